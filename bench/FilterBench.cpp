@@ -0,0 +1,54 @@
+// Fuzzy filter latency benchmark.
+//
+// Builds a listing of synthetic file names and times each keystroke of a
+// few queries typed one character at a time, then deleted again.
+//
+// Usage: FilterBench [entries]
+#include "listing/FuzzyFilter.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    const char* stems[] = {"report", "IMG_", "backup", "config", "session", "index", "part", "Thumbs", "data", "log"};
+    const char* extensions[] = {".txt", ".jpg", ".tar.gz", ".json", ".log", ".cpp", ".h", ".md"};
+    FuzzyFilter filter;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        unsigned value = static_cast<unsigned>(i * 2654435761u);
+        filter.add(std::string(stems[value % 10]) + "_" + std::to_string(value % 100000) + "-" +
+                   std::to_string(i) + extensions[(value >> 8) % 8]);
+    }
+    std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - start;
+    std::cout << count << " names indexed in " << build.count() << " ms" << std::endl;
+
+    const char* queries[] = {"cfg12json", "img7jpg", "log", "rpt_99"};
+    double worst = 0;
+    for (const char* query : queries) {
+        std::string typed;
+        std::string line = std::string(query) + ":";
+        auto keystroke = [&]() {
+            auto begin = std::chrono::steady_clock::now();
+            filter.setQuery(typed);
+            std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - begin;
+            worst = std::max(worst, took.count());
+            line += " " + std::to_string(static_cast<int>(took.count() * 10) / 10.0).substr(0, 4);
+        };
+        for (const char* c = query; *c; c++) {
+            typed += *c;
+            keystroke();
+        }
+        line += " | " + std::to_string(filter.matches().size()) + " matches | back:";
+        while (!typed.empty()) {
+            typed.pop_back();
+            keystroke();
+        }
+        std::cout << line << " (ms)" << std::endl;
+    }
+    std::cout << "Worst keystroke: " << worst << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Cold-cache content search benchmark.
+//
+// Generates a set of text files, drops them from the page cache, then scans
+// them for a pattern that does not occur, once with a plain getline loop and
+// once with Search::searchByContent. Reports the time taken and how much of
+// the scanned data each sweep left in the page cache.
+//
+// Usage: ScanBench [directory] [files] [MiB per file]
+//
+// The directory defaults to ./scan_bench_data; it should be on a disk-backed
+// filesystem, since tmpfs pages cannot be dropped.
+#include "io/AccessHints.h"
+#include "search/Search.h"
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* PATTERN = "no such text in the benchmark data";
+
+bool generate(const std::string& path, uint64_t bytes) {
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_size) == bytes) {
+        return true;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::string line;
+    uint64_t written = 0;
+    for (uint64_t n = 0; written < bytes; n++) {
+        line = "2026-01-01T00:00:00 worker-" + std::to_string(n % 64) + " request " + std::to_string(n) +
+               " completed in " + std::to_string(n * 7919 % 1000) + "ms\n";
+        if (written + line.size() > bytes) {
+            line.resize(bytes - written);
+        }
+        out << line;
+        written += line.size();
+    }
+    return static_cast<bool>(out);
+}
+
+// Flush and drop a file from the page cache; returns the pages still resident
+uint64_t evict(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    fdatasync(fd);
+    AccessHints::dontNeed(fd, 0, 0);
+    uint64_t resident = CacheFootprint::residentPages(fd, st.st_size);
+    close(fd);
+    return resident;
+}
+
+uint64_t resident(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    uint64_t pages = CacheFootprint::residentPages(fd, st.st_size);
+    close(fd);
+    return pages;
+}
+
+bool baselineContains(const std::string& path, const std::string& pattern) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void report(const char* name, double seconds, uint64_t bytes, uint64_t residentPages, uint64_t totalPages) {
+    std::cout << name << ": " << seconds << " s, " << (bytes / (1024.0 * 1024.0)) / seconds << " MiB/s, "
+              << residentPages << "/" << totalPages << " pages left cached ("
+              << (totalPages ? residentPages * 100 / totalPages : 0) << "%)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory = argc > 1 ? argv[1] : "scan_bench_data";
+    int files = argc > 2 ? std::atoi(argv[2]) : 8;
+    uint64_t fileBytes = (argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 32) << 20;
+
+    mkdir(directory.c_str(), 0755);
+    std::vector<std::string> paths;
+    for (int i = 0; i < files; i++) {
+        paths.push_back(directory + "/data" + std::to_string(i) + ".log");
+        if (!generate(paths.back(), fileBytes)) {
+            std::cerr << "Cannot write " << paths.back() << std::endl;
+            return 1;
+        }
+    }
+
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t totalPages = files * ((fileBytes + pageSize - 1) / pageSize);
+    const uint64_t totalBytes = files * fileBytes;
+    auto evictAll = [&]() {
+        uint64_t left = 0;
+        for (const auto& path : paths) {
+            left += evict(path);
+        }
+        if (left > totalPages / 10) {
+            std::cerr << "Warning: " << left << " pages could not be dropped (tmpfs?); results are not cold" << std::endl;
+        }
+    };
+    auto residentAll = [&]() {
+        uint64_t pages = 0;
+        for (const auto& path : paths) {
+            pages += resident(path);
+        }
+        return pages;
+    };
+
+    std::cout << "Scanning " << files << " files of " << (fileBytes >> 20) << " MiB in " << directory << std::endl;
+
+    evictAll();
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& path : paths) {
+        if (baselineContains(path, PATTERN)) {
+            std::cerr << "Unexpected match in " << path << std::endl;
+        }
+    }
+    std::chrono::duration<double> baseline = std::chrono::steady_clock::now() - start;
+    report("getline baseline", baseline.count(), totalBytes, residentAll(), totalPages);
+
+    evictAll();
+    start = std::chrono::steady_clock::now();
+    if (!Search::searchByContent(directory, PATTERN, false).empty()) {
+        std::cerr << "Unexpected match" << std::endl;
+    }
+    std::chrono::duration<double> hinted = std::chrono::steady_clock::now() - start;
+    report("searchByContent", hinted.count(), totalBytes, residentAll(), totalPages);
+
+    // Pages that were cached before the sweep have to stay cached
+    for (const auto& path : paths) {
+        baselineContains(path, PATTERN);
+    }
+    uint64_t warm = residentAll();
+    Search::searchByContent(directory, PATTERN, false);
+    std::cout << "Warm files: " << warm << " pages cached before the search, " << residentAll() << " after"
+              << std::endl;
+    return 0;
+}
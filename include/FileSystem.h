@@ -1,10 +1,12 @@
 #ifndef FILESYSTEM_H
 #define FILESYSTEM_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <cstdint>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -24,13 +26,16 @@ public:
 
     FileInfo(const std::string& name, FileType type, size_t size,
              std::chrono::system_clock::time_point modified_time,
-             uint32_t permissions);
+             uint32_t permissions, uint64_t device = 0, uint64_t inode = 0);
 
     const std::string& getName() const;
     FileType getType() const;
     size_t getSize() const;
     std::chrono::system_clock::time_point getModifiedTime() const;
     uint32_t getPermissions() const;
+    // Identify the underlying file, so hardlinks can be told apart from copies
+    uint64_t getDevice() const;
+    uint64_t getInode() const;
 
 private:
     std::string name_;
@@ -38,11 +43,14 @@ private:
     size_t size_;
     std::chrono::system_clock::time_point modified_time_;
     uint32_t permissions_;
+    uint64_t device_;
+    uint64_t inode_;
 };
 
 class FileSystem {
 public:
-    static std::vector<FileInfo> listDirectory(const std::string& path);
+    // Stops early, returning what it has, once *cancelled becomes true
+    static std::vector<FileInfo> listDirectory(const std::string& path, const std::atomic<bool>* cancelled = nullptr);
     static bool changeDirectory(std::string& current_path, const std::string& target);
     static std::string getParentDirectory(const std::string& path);
     static std::string getAbsolutePath(const std::string& path);
@@ -4,14 +4,27 @@
 #include <vector>
 #include <string>
 
+// Bookmarks are stored as a snapshot, ~/.bookmarks.txt with one path per
+// line, plus a journal of the changes made since, ~/.bookmarks.journal
+// ("+path", "-path", or "!" for clear). Saving appends only the changes
+// made since loading, under a file lock, so concurrent invocations do not
+// lose each other's changes and saving nothing writes nothing. Once the
+// journal grows past JOURNAL_COMPACT_BYTES it is folded into a new
+// snapshot, written to a temporary file and renamed into place.
 class BookMark {
     public:
+        static const long JOURNAL_COMPACT_BYTES = 16 << 10;
+
         static std::vector<std::string> bookMarks;
         static bool addBookMark(std::string path);
         static bool removeBookMark(std::string path);
         static bool emptyBookMarks();
         static bool saveBookMarks();
         static bool loadBookMarks();
+
+    private:
+        // Journal lines for changes not saved yet
+        static std::vector<std::string> pendingChanges;
 };
 
-#endif
\ No newline at end of file
+#endif
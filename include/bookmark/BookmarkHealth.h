@@ -0,0 +1,114 @@
+#ifndef BOOKMARK_BOOKMARKHEALTH_H
+#define BOOKMARK_BOOKMARKHEALTH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Checks whether bookmarked paths still exist, all at once.
+//
+// Paths are stat()ed on detached worker threads, as DirectoryLoader does
+// for listings: a stat on a dead network mount can block in the kernel for
+// minutes, so a path that has not answered within the timeout of a worker
+// picking it up is reported as TIMED_OUT and its worker is left behind.
+// One bad mount then costs the timeout once instead of stalling the whole
+// check, and a long list of healthy paths takes as long as it takes.
+//
+// The workers are shared by every check in the process and at most
+// MAX_WORKERS of them are busy with paths that have not overrun. A worker
+// left behind stops counting and another is started in its place, as
+// ListingPrefetcher does, up to MAX_ABANDONED stuck at once. A path already
+// being checked is not checked again: a later check waits for the same
+// answer, so checking over and over while a mount hangs does not pile up
+// threads.
+class BookmarkHealth {
+public:
+    enum class Status { PENDING, EXISTS, MISSING, DENIED, FAILED, TIMED_OUT };
+
+    struct Result {
+        std::string path;
+        Status status = Status::PENDING;
+        std::string error;
+    };
+
+    // 0 if the path exists, otherwise an errno value
+    using Checker = std::function<int(const std::string&)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{2000};
+    static const size_t MAX_WORKERS = 8;
+    static const size_t MAX_ABANDONED = 32;
+
+    // Starts checking right away; the checker defaults to stat(). A path
+    // already in flight keeps the checker it was started with.
+    explicit BookmarkHealth(const std::vector<std::string>& paths,
+                            std::chrono::milliseconds timeout = DEFAULT_TIMEOUT, Checker checker = nullptr);
+
+    BookmarkHealth(const BookmarkHealth&) = delete;
+    BookmarkHealth& operator=(const BookmarkHealth&) = delete;
+
+    // Results in the order of the paths; PENDING until answered or timed out.
+    // A path still queued only times out when every worker is stuck.
+    std::vector<Result> results() const;
+    // Whether every path has a final status
+    bool done() const;
+    // Block until done() and return the results
+    std::vector<Result> wait();
+
+    static const char* statusName(Status status);
+    // Status for the outcome of a check
+    static Status classify(int error);
+
+private:
+    // Shared with the checking threads, which may outlive this object
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable answered;
+        std::vector<Result> results;
+        std::vector<std::chrono::steady_clock::time_point> started; // Epoch while queued
+        size_t remaining = 0;
+    };
+
+    // One path being checked, and the results waiting for it
+    struct Job {
+        std::string path;
+        Checker checker;
+        std::chrono::milliseconds timeout;
+        std::chrono::steady_clock::time_point started; // Epoch while queued
+        bool abandoned = false;
+        std::vector<std::pair<std::shared_ptr<Shared>, size_t>> waiters;
+    };
+
+    // The workers and their queue, for the whole process
+    struct Pool {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> queue;
+        std::unordered_map<std::string, std::shared_ptr<Job>> inFlight; // Queued or running, by path
+        std::vector<std::shared_ptr<Job>> running;
+        size_t workers = 0;   // Not counting the abandoned ones
+        size_t busy = 0;      // Of those, running a job
+        size_t abandoned = 0; // Left behind in a job that overran
+        bool stalled = false; // Nothing left to take the queue
+    };
+
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{20};
+
+    static Pool& pool();
+    static void work();
+    // Leave overrun workers behind and start enough workers for the queue;
+    // called with the pool locked
+    static void reap(Pool& workers);
+
+    std::shared_ptr<Shared> shared_;
+    std::chrono::milliseconds timeout_;
+    std::chrono::steady_clock::time_point created_;
+};
+
+#endif // BOOKMARK_BOOKMARKHEALTH_H
@@ -0,0 +1,101 @@
+#ifndef BOOKMARK_FRECENCYSTORE_H
+#define BOOKMARK_FRECENCYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Directories visited with `cd`, ranked by frecency (how often and how
+// recently), for jumping to one by part of its name.
+//
+// Every visit is appended to a log as one "rank<TAB>time<TAB>path" line.
+// Loading adds the lines for a path up; when the log has grown to several
+// lines per directory it is rewritten with one line each (compaction),
+// and old entries age out once the total rank passes MAX_TOTAL_RANK or
+// RANK_PER_ENTRY per directory, whichever is larger. Rewriting the log
+// happens under a lock (the log path plus ".lock") and starts by reading
+// it again, so visits appended by other processes meanwhile are kept.
+//
+// Lookups use a trigram (bigram for two letters) index over the last
+// component of each path, so a query only examines the directories whose
+// name can contain its last word instead of the whole history. Where that
+// still leaves more than MAX_POSTINGS_SCAN (a one-letter or common last
+// word), directories are examined best first until the rest can no longer
+// make the list.
+class FrecencyStore {
+public:
+    struct Match {
+        std::string path;
+        double score = 0;
+    };
+
+    static const size_t COMPACT_MIN_LINES = 1000;
+    static const double MAX_TOTAL_RANK;
+    static const double RANK_PER_ENTRY;
+    static const size_t MAX_POSTINGS_SCAN = 10000;
+
+    // Empty path: ~/.frecency.log
+    explicit FrecencyStore(const std::string& logPath = "");
+
+    // Read the log, compacting it if it has grown too long
+    bool load();
+    // Count a visit and append it to the log
+    bool record(const std::string& path, std::time_t now = std::time(nullptr));
+    // Forget a directory (for example one that no longer exists)
+    bool remove(const std::string& path);
+    // Rewrite the log with one line per directory
+    bool compact();
+
+    // Directories whose path contains the words in order, ignoring ASCII
+    // case, with the last word in the final component; best first
+    std::vector<Match> query(const std::vector<std::string>& words, size_t limit,
+                             std::time_t now = std::time(nullptr)) const;
+
+    size_t size() const { return live_; }
+    size_t logLines() const { return logLines_; }
+    // Directories the last query looked at
+    size_t examined() const { return examined_; }
+    const std::string& logPath() const { return logPath_; }
+
+    // Rank weighted by how long ago the last visit was
+    static double frecency(double rank, std::time_t last, std::time_t now);
+
+private:
+    struct Entry {
+        std::string path;
+        std::string folded;  // Lower-case path
+        size_t nameStart = 0; // Start of the last component in folded
+        double rank = 0;
+        std::time_t last = 0;
+        bool removed = false;
+        double bound = 0;   // Frecency when byScore_ was sorted; it can only drop
+        bool dirty = false; // Ranked higher since then
+    };
+
+    bool readLog();
+    bool rewrite(const std::string& keep);
+    int lockLog(int operation) const;
+    void apply(const std::string& path, double rank, std::time_t last);
+    void index(uint32_t id);
+    void rebuildIndex();
+    void sortByScore();
+    void age(const std::string& keep);
+    bool append(const std::string& line);
+
+    std::string logPath_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> grams_; // Trigram or bigram -> entry ids
+    std::vector<uint32_t> byScore_; // Live entry ids, highest frecency first
+    std::vector<uint32_t> dirty_;  // Entries ranked higher since it was sorted
+    std::time_t sortedAt_ = 0;      // Latest visit when byScore_ was sorted
+    size_t live_ = 0;
+    size_t logLines_ = 0;
+    double totalRank_ = 0;
+    mutable size_t examined_ = 0;
+};
+
+#endif // BOOKMARK_FRECENCYSTORE_H
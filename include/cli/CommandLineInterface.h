@@ -2,6 +2,10 @@
 #define COMMANDLINEINTERFACE_H
 
 #include "FileSystem.h"
+#include "../bookmark/FrecencyStore.h"
+#include "../du/DiskUsage.h"
+#include "../io/PathResolver.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,11 +13,20 @@
 #include <ncurses.h>
 #endif
 
+class LineSource;
+class MappedFile;
+class MappedLineSource;
+
 class CommandLineInterface {
 public:
     CommandLineInterface();
     void start();
     void startInteractive();
+    void findDuplicates(const std::string& path);
+    // False if any file could not be hashed
+    bool hashPaths(const std::vector<std::string>& args);
+    // Report bookmarks that no longer exist, optionally removing them
+    void checkBookmarks(bool prune);
 
 private:
     void showPrompt();
@@ -21,21 +34,43 @@ private:
     void executeShellCommand(const std::string& command);
     void listDirectory();
     void changeDirectory(const std::string& path);
+    void jumpToDirectory(const std::vector<std::string>& words);
     void createFile(const std::string& filename);
     void deleteFile(const std::string& path);
     void deleteDirectory(const std::string& path);
     void renameFile(const std::string& oldPath, const std::string& newPath);
     void copyFile(const std::string& sourcePath, const std::string& destinationPath);
+    void showDiskUsage(const std::string& path);
+    DiskUsage& diskUsage();
+    void loadBookmarks();
+    FrecencyStore& visitedDirectories();
     void showHelp();
     
 #ifdef USE_NCURSES
     void interactiveListDirectory();
     void displayFileContent(const std::string& filePath);
+    void displayHexContent(const std::string& filePath, const MappedFile& file);
+    void displayCompressedContent(const std::string& filePath);
+    void viewLines(WINDOW* fileWin, const std::string& filePath, LineSource& source, MappedLineSource* mapped);
+    static std::string promptInput(WINDOW* win, int row, const char* prompt);
     void editFileWithVim(const std::string& filePath);
+    void displayDuplicates(const std::string& directory);
+    bool displayBookmarks(std::string& target);
+    void initColors();
 #endif
     
     FileSystem fileSystem;
     std::string currentPath;
+    PathResolver resolver; // Holds currentPath open for cd
+    std::unique_ptr<DiskUsage> diskUsageEngine; // Created on first use
+    // Subsystems below are initialized on first use, so a launch only pays
+    // for what its command needs
+    bool bookmarksLoaded = false;
+    std::unique_ptr<FrecencyStore> visitedStore; // Directories entered with cd, for z/jump
+#ifdef USE_NCURSES
+    bool colorsReady = false;
+#endif
+
 };
 
 #endif // COMMANDLINEINTERFACE_H
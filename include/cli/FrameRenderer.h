@@ -0,0 +1,67 @@
+#ifndef CLI_FRAMERENDERER_H
+#define CLI_FRAMERENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef USE_NCURSES
+#include <ncurses.h>
+#endif
+
+// Draws full-screen frames as a list of rows and sends only what changed.
+//
+// Each frame is described from scratch with setRow(); present() compares it
+// with the frame on screen and redraws just the rows whose text or
+// attributes differ. When the rows of the scroll region have moved by one
+// (the listing scrolled), the region is scrolled instead, so the terminal
+// receives a scroll sequence and one new row rather than a full repaint.
+class FrameRenderer {
+public:
+    struct Row {
+        std::string text;
+        int attributes = 0;
+
+        bool operator==(const Row& other) const {
+            return attributes == other.attributes && text == other.text;
+        }
+    };
+
+    // How to turn one frame into the next
+    struct Plan {
+        int scroll = 0;          // Lines to scroll the region up (negative: down)
+        std::vector<int> dirty;  // Rows to redraw afterwards
+    };
+
+    // Start describing a frame with the given number of rows
+    void beginFrame(int rows);
+    void setRow(int row, const std::string& text, int attributes = 0);
+    // Rows [top, bottom) move together when the view scrolls
+    void setScrollRegion(int top, int bottom);
+
+    // Forget what is on screen; the next frame is drawn in full
+    void invalidate();
+
+    // Cheapest plan between two frames, scrolling rows [top, bottom) by at most one
+    static Plan plan(const std::vector<Row>& previous, const std::vector<Row>& next, int top, int bottom);
+
+    // Rows drawn by all frames so far
+    uint64_t rowsDrawn() const { return rowsDrawn_; }
+
+#ifdef USE_NCURSES
+    // Draw the frame into the window and update the terminal
+    void present(WINDOW* win);
+#endif
+
+private:
+    std::vector<Row> shown_;
+    std::vector<Row> next_;
+    int scrollTop_ = 0;
+    int scrollBottom_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    bool valid_ = false;
+    uint64_t rowsDrawn_ = 0;
+};
+
+#endif // CLI_FRAMERENDERER_H
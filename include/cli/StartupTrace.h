@@ -0,0 +1,34 @@
+#ifndef CLI_STARTUPTRACE_H
+#define CLI_STARTUPTRACE_H
+
+#include <chrono>
+
+// Timing of startup phases, printed to stderr with --startup-trace.
+// Phases are timed where they happen, including subsystems that are only
+// initialized on first use, so the report shows what a launch really paid
+// for. Everything is a no-op unless tracing was enabled.
+namespace StartupTrace {
+
+void enable();
+bool enabled();
+
+// Print each phase and the time since main() started, then stop tracing
+void report();
+
+// Times a phase from construction to destruction
+class Phase {
+public:
+    explicit Phase(const char* name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace StartupTrace
+
+#endif // CLI_STARTUPTRACE_H
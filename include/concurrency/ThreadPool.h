@@ -0,0 +1,40 @@
+#ifndef CONCURRENCY_THREADPOOL_H
+#define CONCURRENCY_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads. Tasks may submit further tasks;
+// wait() returns once the queue is drained and every worker is idle.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+    size_t size() const;
+
+    static size_t defaultThreadCount();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable idle_;
+    size_t activeTasks_ = 0;
+    bool stopping_ = false;
+};
+
+#endif // CONCURRENCY_THREADPOOL_H
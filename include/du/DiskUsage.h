@@ -0,0 +1,100 @@
+#ifndef DU_DISKUSAGE_H
+#define DU_DISKUSAGE_H
+
+#include "../concurrency/ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Recursive directory sizes computed on a thread pool. Each requested
+// directory is one job whose subdirectories are scanned in parallel;
+// files with several hardlinks are counted once per job via (dev, ino).
+// Finished results are cached per directory until invalidated, and a job
+// that reaches a subdirectory with a cached result adds that instead of
+// walking it again. A cached result is only reused while the directory's
+// mtime and ctime are what they were when it was scanned; that catches
+// entries added, removed or renamed in the directory itself, while changes
+// further down still need invalidate().
+class DiskUsage {
+public:
+    struct Usage {
+        uint64_t apparentBytes = 0;  // Sum of st_size
+        uint64_t allocatedBytes = 0; // Sum of st_blocks * 512
+        uint64_t files = 0;
+        uint64_t directories = 0;
+        uint64_t errors = 0;         // Entries that could not be read
+    };
+
+    explicit DiskUsage(size_t threadCount = 0);
+    ~DiskUsage();
+
+    DiskUsage(const DiskUsage&) = delete;
+    DiskUsage& operator=(const DiskUsage&) = delete;
+
+    // Blocking; returns the cached result when there is one
+    Usage compute(const std::string& path);
+    // Queue a job unless the result is cached or already being computed
+    void computeAsync(const std::string& path);
+    bool lookup(const std::string& path, Usage& usage) const;
+    bool isPending(const std::string& path) const;
+    size_t pendingCount() const;
+    // Bumped whenever a job finishes, so callers can cheaply spot new results
+    uint64_t generation() const;
+    // Drop cached results for path, everything below it and its ancestors
+    void invalidate(const std::string& path);
+    // Invalidate path if the directory changed since it was cached; the
+    // check runs on the pool, and generation() moves if it was stale
+    void revalidate(const std::string& path);
+    // Stop every job still running; nothing is cached for them
+    void cancelPending();
+
+private:
+    // (dev, ino) of a file with several hardlinks -> its apparent and allocated bytes
+    using LinkedInodes = std::map<std::pair<uint64_t, uint64_t>, std::pair<uint64_t, uint64_t>>;
+
+    struct Cached {
+        Usage usage;
+        LinkedInodes linkedInodes; // So a parent job still counts each of them once
+        int64_t modified = 0;      // mtime and ctime of the directory, in ns
+        int64_t changed = 0;
+    };
+
+    struct Job {
+        std::string root;
+        std::atomic<uint64_t> apparentBytes{0};
+        std::atomic<uint64_t> allocatedBytes{0};
+        std::atomic<uint64_t> files{0};
+        std::atomic<uint64_t> directories{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<size_t> outstanding{0};
+        std::atomic<bool> cancelled{false};
+        int64_t rootModified = 0; // Stamps of the root, cached with the result
+        int64_t rootChanged = 0;
+        std::mutex inodesMutex;
+        LinkedInodes linkedInodes;
+    };
+
+    std::shared_ptr<Job> startJob(const std::string& path);
+    void scanDirectory(const std::shared_ptr<Job>& job, const std::string& path);
+    bool addCached(const std::shared_ptr<Job>& job, const std::string& path, int64_t modified, int64_t changed);
+    void invalidateLocked(const std::string& path);
+    void finishDirectory(const std::shared_ptr<Job>& job);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Cached> cache_;
+    std::unordered_map<std::string, std::shared_ptr<Job>> pending_;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex finishedMutex_;
+    std::condition_variable finished_;
+    // Declared last so workers stop before the state they use is destroyed
+    ThreadPool pool_;
+};
+
+#endif // DU_DISKUSAGE_H
@@ -0,0 +1,44 @@
+#ifndef DUPES_DUPLICATEFINDER_H
+#define DUPES_DUPLICATEFINDER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class DuplicateFinder {
+public:
+    struct DuplicateGroup {
+        uint64_t size = 0;
+        std::vector<std::string> paths;
+    };
+
+    struct Report {
+        std::vector<DuplicateGroup> groups;
+        uint64_t filesScanned = 0;
+        uint64_t hardlinksSkipped = 0;
+        uint64_t filesFullyHashed = 0;
+        // Bytes freed by keeping one copy of every group
+        uint64_t reclaimableBytes = 0;
+    };
+
+    // Staged search: bucket by size, then compare a hash of the first and
+    // last 4 KiB, and only hash whole files that still collide.
+    static Report findDuplicates(const std::string& directory);
+
+    static const size_t EDGE_BYTES = 4096;
+
+private:
+    struct Candidate {
+        std::string path;
+        uint64_t size;
+        uint64_t hash;
+        bool readable;
+    };
+
+    static bool hashEdges(const std::string& path, uint64_t size, uint64_t& hash);
+    static bool hashContents(const std::string& path, uint64_t& hash);
+    static void hashAll(std::vector<Candidate>& candidates, bool fullContents);
+    static std::vector<std::vector<Candidate>> splitByHash(std::vector<Candidate>& group);
+};
+
+#endif // DUPES_DUPLICATEFINDER_H
@@ -3,20 +3,49 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 
 class FileOperations {
 public:
+    // Byte counters filled in by copyFile.
+    // logicalBytes is the apparent size of everything copied, physicalBytes
+    // is what was actually read and written (holes in sparse files are skipped).
+    struct CopyStats {
+        uint64_t logicalBytes = 0;
+        uint64_t physicalBytes = 0;
+        uint64_t filesCopied = 0;
+        uint64_t sparseFiles = 0;
+        // A move that finished but could not remove all of its source
+        bool sourceLeftBehind = false;
+    };
+
     static bool createFile(const std::string& filePath);
     static bool deleteFile(const std::string& filePath);
     static bool deleteDirectory(const std::string& dirPath);
     static bool renameFile(const std::string& oldPath, const std::string& newPath);
+    static bool moveFile(const std::string& oldPath, const std::string& newPath, CopyStats& stats);
     static bool copyFile(const std::string& sourcePath, const std::string& destinationPath);
+    static bool copyFile(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats);
     static bool exists(const std::string& path);
     
     // Add helper functions for formatting
     static std::string formatFileSize(size_t size);
     static std::string formatTime(const std::chrono::system_clock::time_point& tp);
     static std::string formatPermissions(uint32_t permissions);
+    static std::string formatCopyStats(const CopyStats& stats);
+
+private:
+#ifndef _WIN32
+    static bool copyRegularFile(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats,
+                                bool durable = false);
+    static bool copyRange(int inFd, int outFd, uint64_t offset, uint64_t length);
+
+    // Cross-device move support (FileOperations_move.cpp)
+    static bool moveAcrossDevices(const std::string& oldPath, const std::string& newPath, CopyStats& stats);
+    static bool copyTreeParallel(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats);
+    static bool removeTree(const std::string& path);
+    static bool syncDirectory(const std::string& dirPath);
+#endif
 };
 
-#endif // FILEOPS_FILEOPERATIONS_H
\ No newline at end of file
+#endif // FILEOPS_FILEOPERATIONS_H
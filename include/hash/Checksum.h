@@ -0,0 +1,47 @@
+#ifndef HASH_CHECKSUM_H
+#define HASH_CHECKSUM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Checksums for files and whole trees, with reads spread over a thread pool.
+// With the fast algorithm, files larger than CHUNK_SIZE are split into
+// chunks hashed in parallel; the chunk digests are then hashed in order,
+// so the result does not depend on the number of threads.
+class Checksum {
+public:
+    enum class Algorithm {
+        FAST,   // XXH64; chunk tree for large files
+        SHA256  // Plain SHA-256 of the contents, comparable with sha256sum
+    };
+
+    struct Result {
+        std::string path;
+        std::string digest; // Lowercase hex, empty on error
+        uint64_t size = 0;
+        std::string error;
+    };
+
+    // Directories are expanded to every file below them, sorted by path
+    static std::vector<Result> hashPaths(const std::vector<std::string>& paths, Algorithm algorithm,
+                                         uint64_t chunkSize = CHUNK_SIZE);
+    // Digest of a tree listing: each relative path and digest, in order.
+    // Empty if any file below root could not be hashed.
+    static std::string combineTree(const std::string& root, const std::vector<Result>& results, Algorithm algorithm);
+
+    static const uint64_t CHUNK_SIZE = 64ULL << 20;
+
+private:
+    struct WorkUnit {
+        size_t resultIndex;
+        uint64_t offset;
+        uint64_t length;
+        size_t chunkIndex;
+    };
+
+    static bool hashRange(const std::string& path, uint64_t offset, uint64_t length, Algorithm algorithm,
+                          std::string& digest, std::string& error);
+};
+
+#endif // HASH_CHECKSUM_H
@@ -0,0 +1,29 @@
+#ifndef HASH_FASTHASH_H
+#define HASH_FASTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64-bit xxHash (XXH64). Not cryptographic, but fast and well distributed;
+// the four independent accumulators keep the CPU's execution units busy.
+class FastHash {
+public:
+    explicit FastHash(uint64_t seed = 0);
+
+    void update(const void* data, size_t length);
+    uint64_t digest() const;
+    void reset(uint64_t seed = 0);
+
+    static uint64_t hash(const void* data, size_t length, uint64_t seed = 0);
+    static std::string toHex(uint64_t value);
+
+private:
+    uint64_t seed_;
+    uint64_t accumulators_[4];
+    uint64_t totalLength_;
+    unsigned char buffer_[32];
+    size_t bufferedBytes_;
+};
+
+#endif // HASH_FASTHASH_H
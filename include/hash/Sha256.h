@@ -0,0 +1,32 @@
+#ifndef HASH_SHA256_H
+#define HASH_SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Streaming SHA-256 (FIPS 180-4)
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t length);
+    Digest digest() const;
+    void reset();
+
+    static Digest hash(const void* data, size_t length);
+    static std::string toHex(const Digest& digest);
+
+private:
+    static void compress(uint32_t state[8], const unsigned char block[64]);
+
+    uint32_t state_[8];
+    uint64_t totalLength_;
+    unsigned char buffer_[64];
+    size_t bufferedBytes_;
+};
+
+#endif // HASH_SHA256_H
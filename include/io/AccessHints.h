@@ -0,0 +1,48 @@
+#ifndef IO_ACCESSHINTS_H
+#define IO_ACCESSHINTS_H
+
+#include <cstdint>
+#include <vector>
+
+// Access-pattern hints for the kernel page cache. They are advisory only:
+// failures are ignored, and where posix_fadvise/madvise are unavailable the
+// calls do nothing.
+namespace AccessHints {
+
+// The file will be read front to back (larger read-ahead)
+void sequential(int fd);
+// Start reading a range of the file into the cache in the background
+void willNeed(int fd, uint64_t offset, uint64_t length);
+// Drop a range of the file from the cache (clean pages only)
+void dontNeed(int fd, uint64_t offset, uint64_t length);
+
+// The same for a range of a mapping; widened to whole pages
+void mappedWillNeed(const void* address, uint64_t length);
+void mappedSequential(const void* address, uint64_t length);
+
+} // namespace AccessHints
+
+// Which pages of a file were cached before a scan, so that afterwards only
+// the pages the scan itself pulled in are dropped. A one-off sweep through a
+// large tree then leaves the page cache as it found it, instead of evicting
+// data other programs are using, and without dropping their cached pages of
+// the same files.
+class CacheFootprint {
+public:
+    CacheFootprint(int fd, uint64_t size);
+
+    // Drop the pages that were not resident at construction
+    void release();
+    // Pages of the file resident right now (for benchmarks and tests)
+    static uint64_t residentPages(int fd, uint64_t size);
+
+private:
+    static bool snapshot(int fd, uint64_t size, std::vector<unsigned char>& pages);
+
+    int fd_;
+    uint64_t size_;
+    bool valid_;
+    std::vector<unsigned char> resident_;
+};
+
+#endif // IO_ACCESSHINTS_H
@@ -0,0 +1,73 @@
+#ifndef IO_PATHRESOLVER_H
+#define IO_PATHRESOLVER_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+// Turns a `cd` target into the canonical path of a directory.
+//
+// realpath() lstat()s every component of the path, which on a slow network
+// mount means one round trip per directory level. Instead the current
+// directory is held open, and a target is looked up relative to it with a
+// single openat2() that refuses to follow symlinks: if that succeeds, no
+// symlink was crossed and the canonical path follows from the text alone.
+// Moving down or up a deep tree then takes one lookup per hop.
+//
+// When the lookup runs into a symlink, the link is resolved once and its
+// canonical target kept, so later paths through it are rewritten before the
+// lookup. The directory holding each cached link is watched with inotify and
+// any change there drops the cache; so does a lookup through a cached link
+// that no longer succeeds.
+//
+// The held directory follows renames, but the caller's path does not: its
+// name is checked against /proc/self/fd on every call, and once it has been
+// renamed or deleted (or any parent has) lookups go by the path text again.
+// Where openat2() or inotify are unavailable this falls back to
+// FileSystem::changeDirectory().
+class PathResolver {
+public:
+    // Symlinks followed while resolving one path
+    static const int MAX_LINKS = 40;
+
+    PathResolver() = default;
+    ~PathResolver();
+
+    PathResolver(const PathResolver&) = delete;
+    PathResolver& operator=(const PathResolver&) = delete;
+
+    // Canonical path of target ("~", absolute, or relative to current) if it
+    // is a directory. The result becomes the held directory, so passing it as
+    // current next time needs no extra lookup.
+    bool resolve(const std::string& current, const std::string& target, std::string& resolved);
+    // Forget cached links (the held directory is kept)
+    void clear();
+
+    // Path lookups made so far, each a syscall on the file system
+    size_t lookups() const { return lookups_; }
+    size_t cachedLinks() const { return links_.size(); }
+
+private:
+    enum class Lookup { FOUND, MISSING, UNSUPPORTED };
+
+    Lookup enter(const std::string& current);
+    Lookup open(const std::string& base, const std::string& path, std::string& canonical, int& fd);
+    Lookup openCanonical(const std::string& canonical, int& fd);
+    Lookup cacheFirstLink(const std::string& path);
+    bool watch(const std::string& directory);
+    void readEvents();
+    // Whether the held directory is still at cwdCanonical_
+    bool stillNamed() const;
+    void hold(int fd, const std::string& path, const std::string& canonical);
+
+    int cwdFd_ = -1;
+    std::string cwdPath_;      // As given by the caller
+    std::string cwdCanonical_; // Without symlinks
+    bool textOnly_ = false;    // cwdCanonical_ no longer names the held directory, which was let go
+    int notifyFd_ = -1;
+    std::unordered_map<std::string, std::string> links_; // Symlink path -> canonical target
+    size_t lookups_ = 0;
+    bool unsupported_ = false;
+};
+
+#endif // IO_PATHRESOLVER_H
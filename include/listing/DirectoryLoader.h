@@ -0,0 +1,79 @@
+#ifndef LISTING_DIRECTORYLOADER_H
+#define LISTING_DIRECTORYLOADER_H
+
+#include "../FileSystem.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lists directories off the UI thread.
+//
+// Each request runs on its own detached thread: a read from a hung network
+// mount blocks in the kernel and cannot be interrupted, so the loader just
+// stops waiting for it. Only the latest request counts; a new request,
+// cancel() or the timeout abandons the previous one, and whatever it
+// produces later is discarded.
+class DirectoryLoader {
+public:
+    enum class State { IDLE, LOADING, DONE, FAILED, TIMED_OUT };
+
+    struct Result {
+        uint64_t request = 0;
+        std::string path;
+        State state = State::IDLE;
+        std::vector<FileInfo> entries;
+        std::string error;
+    };
+
+    using Lister = std::function<std::vector<FileInfo>(const std::string&, const std::atomic<bool>*)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{10000};
+
+    // The lister defaults to FileSystem::listDirectory
+    explicit DirectoryLoader(std::chrono::milliseconds timeout = DEFAULT_TIMEOUT, Lister lister = nullptr);
+    ~DirectoryLoader();
+
+    DirectoryLoader(const DirectoryLoader&) = delete;
+    DirectoryLoader& operator=(const DirectoryLoader&) = delete;
+
+    // Start listing path, superseding any earlier request; returns its id
+    uint64_t request(const std::string& path);
+    // Abandon the current request
+    void cancel();
+
+    // Hand over the outcome of the current request once, when it is known,
+    // waiting up to `wait` for it
+    bool poll(Result& result, std::chrono::milliseconds wait = std::chrono::milliseconds(0));
+
+    State state() const;
+    const std::string& path() const;
+    // Time since the current request started
+    std::chrono::milliseconds elapsed() const;
+
+private:
+    // Shared with the worker threads, which may outlive the loader
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable finished;
+        uint64_t current = 0;
+        bool ready = false;
+        Result result;
+    };
+
+    std::chrono::milliseconds timeout_;
+    Lister lister_;
+    std::shared_ptr<Shared> shared_;
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+    State state_ = State::IDLE;
+    std::string path_;
+    uint64_t nextRequest_ = 0;
+    std::chrono::steady_clock::time_point started_;
+};
+
+#endif // LISTING_DIRECTORYLOADER_H
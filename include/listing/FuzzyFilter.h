@@ -0,0 +1,68 @@
+#ifndef LISTING_FUZZYFILTER_H
+#define LISTING_FUZZYFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Incremental fuzzy filter over a fixed list of names.
+//
+// A name matches when the query's characters appear in it in order,
+// ignoring ASCII case. Typing a character only re-examines the candidates
+// that matched before, continuing each from where its previous match
+// ended; deleting one goes back to the earlier candidate set. Names are
+// stored folded in one buffer with a bitmask of the characters they
+// contain, so most non-matches are rejected without looking at them.
+//
+// Only the best few matches are ranked: candidates are preselected by the
+// span of their match and just those get the full score. The rest follow
+// in their original order.
+class FuzzyFilter {
+public:
+    static const size_t RANK_TOP = 128;
+
+    explicit FuzzyFilter(size_t rankTop = RANK_TOP);
+
+    void clear();
+    void add(const std::string& name);
+    size_t size() const;
+
+    // Narrows or widens from the previous query where it can
+    void setQuery(const std::string& query);
+    const std::string& query() const;
+
+    // Indices of matching names: the ranked best first, then the rest in order
+    const std::vector<uint32_t>& matches() const;
+
+    // Higher is better; only meaningful for names that match
+    static int score(const char* folded, size_t length, const std::string& foldedQuery);
+
+private:
+    struct Candidate {
+        uint32_t index;
+        uint32_t first; // Where the match starts
+        uint32_t next;  // Just past the last matched character
+    };
+
+    // Buffers are kept between queries so typing does not reallocate;
+    // only the first `count` candidates are valid
+    struct Level {
+        std::vector<Candidate> candidates;
+        size_t count = 0;
+    };
+
+    void extend(size_t depth);
+    void rank();
+
+    size_t rankTop_;
+    std::string text_;             // Folded names back to back, padded for vector loads
+    std::vector<uint32_t> starts_; // starts_[i]..starts_[i + 1] is name i
+    std::vector<uint64_t> masks_;
+    std::string query_;
+    std::vector<Level> levels_; // levels_[k] matches query_[0..k]
+    size_t depth_ = 0;          // Levels valid for query_
+    std::vector<uint32_t> matches_;
+};
+
+#endif // LISTING_FUZZYFILTER_H
@@ -0,0 +1,75 @@
+#ifndef LISTING_LISTINGPREFETCHER_H
+#define LISTING_LISTINGPREFETCHER_H
+
+#include "SnapshotCache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Reads the directory under the cursor into a SnapshotCache before it is
+// opened. The cursor has to rest on a directory for `delay` first, so
+// scrolling past entries does not start reads, and moving on cancels a read
+// in progress. The worker runs at idle I/O and CPU priority where the
+// platform allows, so it yields to everything in the foreground.
+//
+// As in DirectoryLoader, the worker is detached and shares its state with
+// the prefetcher: a read from a hung mount cannot be interrupted, so the
+// prefetcher never waits for it. A worker stuck for longer than
+// `stallTimeout` is left behind when the cursor moves on, and a new one
+// takes over (up to MAX_ABANDONED of them at a time).
+class ListingPrefetcher {
+public:
+    using Lister = std::function<std::vector<FileInfo>(const std::string&, const std::atomic<bool>*)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_DELAY{150};
+    static constexpr std::chrono::milliseconds DEFAULT_STALL_TIMEOUT{2000};
+    static const size_t MAX_ABANDONED = 4;
+
+    // The lister defaults to FileSystem::listDirectory
+    explicit ListingPrefetcher(SnapshotCache& cache, std::chrono::milliseconds delay = DEFAULT_DELAY,
+                               Lister lister = nullptr,
+                               std::chrono::milliseconds stallTimeout = DEFAULT_STALL_TIMEOUT);
+    // Does not wait for the worker; it stops touching the cache right away
+    ~ListingPrefetcher();
+
+    ListingPrefetcher(const ListingPrefetcher&) = delete;
+    ListingPrefetcher& operator=(const ListingPrefetcher&) = delete;
+
+    // Directory under the cursor, or empty for none; replaces the previous one
+    void hint(const std::string& path);
+    // Listings read into the cache so far
+    uint64_t completed() const;
+
+private:
+    // Shared with the worker threads, which may outlive the prefetcher
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable changed;
+        SnapshotCache* cache = nullptr; // Null once the prefetcher is gone
+        std::chrono::milliseconds delay{0};
+        Lister lister;
+        std::string target;
+        std::chrono::steady_clock::time_point hinted;
+        std::shared_ptr<std::atomic<bool>> cancelled; // Of the read in progress
+        bool reading = false;
+        std::chrono::steady_clock::time_point readStarted;
+        uint64_t worker = 0;   // Id of the current worker; any other one exits
+        size_t abandoned = 0;  // Workers left behind in a stalled read
+        std::atomic<uint64_t> completed{0};
+    };
+
+    static void run(std::shared_ptr<Shared> shared, uint64_t id);
+    void startWorker();
+
+    std::shared_ptr<Shared> shared_;
+    std::chrono::milliseconds stallTimeout_;
+};
+
+#endif // LISTING_LISTINGPREFETCHER_H
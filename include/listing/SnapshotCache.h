@@ -0,0 +1,59 @@
+#ifndef LISTING_SNAPSHOTCACHE_H
+#define LISTING_SNAPSHOTCACHE_H
+
+#include "../FileSystem.h"
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Recently seen directory listings, so revisiting or entering a prefetched
+// directory can be drawn before it is read again. Snapshots may be stale;
+// callers show them and reload in the background. Memory is capped and the
+// least recently used snapshots are evicted first. Thread-safe.
+class SnapshotCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 64 << 20;
+
+    explicit SnapshotCache(size_t capacityBytes = DEFAULT_CAPACITY);
+
+    void put(const std::string& path, const std::vector<FileInfo>& entries);
+    bool get(const std::string& path, std::vector<FileInfo>& entries);
+    bool contains(const std::string& path) const;
+    // Drop the snapshot of path and of its parent, whose listing shows it
+    void invalidate(const std::string& path);
+    void clear();
+
+    size_t size() const;
+    size_t bytes() const;
+    size_t capacity() const;
+    // Lookups with get() that found a snapshot, and those that did not
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+    // Approximate memory held by a listing
+    static size_t footprint(const std::vector<FileInfo>& entries);
+
+private:
+    struct Snapshot {
+        std::vector<FileInfo> entries;
+        size_t bytes = 0;
+        std::list<std::string>::iterator position;
+    };
+
+    void evict();
+    void erase(const std::string& path);
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    size_t bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    std::list<std::string> lru_; // Most recently used first
+    std::unordered_map<std::string, Snapshot> snapshots_;
+};
+
+#endif // LISTING_SNAPSHOTCACHE_H
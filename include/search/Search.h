@@ -1,19 +1,32 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
+#include "../FileSystem.h"
 #include <string>
 #include <vector>
 #include <regex>
 #include <filesystem>
+#include <functional>
 
 class Search {
 public:
+    // Content searches read files in chunks of this size
+    static const size_t READ_CHUNK = 1 << 20;
+
+    // Called for every entry found during a traversal, with its full path
+    using Visitor = std::function<void(const std::string& path, const FileInfo& info)>;
+
     static std::vector<std::string> searchByName(const std::string& directory, const std::string& pattern, bool recursive = true);
     static std::vector<std::string> searchByContent(const std::string& directory, const std::string& pattern, bool recursive = true);
+
+    // Breadth-first traversal shared by the searches and other tree scanners.
+    // Each directory is visited once even when reachable through symlinks.
+    static void walk(const std::string& directory, bool recursive, const Visitor& visitor);
     
 private:
     static void searchByNameRecursive(const std::string& directory, const std::regex& pattern, std::vector<std::string>& results);
     static void searchByContentRecursive(const std::string& directory, const std::string& pattern, std::vector<std::string>& results);
+    static bool fileContains(const std::string& path, const std::string& pattern);
 };
 
 #endif // SEARCH_H
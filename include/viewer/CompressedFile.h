@@ -0,0 +1,117 @@
+#ifndef VIEWER_COMPRESSEDFILE_H
+#define VIEWER_COMPRESSEDFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class StreamDecoder;
+
+// Random access to the decompressed contents of a gzip (or, when built with
+// libzstd, zstd) file without keeping them around.
+//
+// A background pass decompresses the file once and records a checkpoint
+// about every SPAN output bytes: the position in the compressed stream plus
+// whatever the decoder needs to resume there (for deflate, the last 32 KiB
+// of output). Reading at an offset then only decompresses from the nearest
+// checkpoint before it. The same pass records the start of every
+// LINE_STRIDE-th line, as LineIndex does for plain files.
+//
+// Memory stays bounded: checkpoints and line starts are thinned out (and
+// their spacing doubled) when they pass their caps, and decompressed data
+// is only kept in a small LRU of blocks.
+class CompressedFile {
+public:
+    enum class Format { NONE, GZIP, ZSTD };
+
+    // Where a decoder can resume
+    struct Checkpoint {
+        uint64_t in = 0;                   // Compressed offset
+        uint64_t out = 0;                  // Decompressed offset
+        int bits = 0;                      // Bits of the byte before `in` still to be used
+        std::vector<unsigned char> window; // Preceding output the decoder may refer back to
+    };
+
+    static const uint64_t SPAN = 4 << 20;
+    static const size_t MAX_CHECKPOINTS = 256;
+    static const uint64_t LINE_STRIDE = 64;
+    static const size_t MAX_LINE_CHECKPOINTS = 1 << 18;
+    static const uint64_t BLOCK_SIZE = 256 << 10;
+    static const size_t CACHE_BLOCKS = 16;
+    static const uint64_t MAX_LINE_BYTES = 1 << 20;
+
+    CompressedFile();
+    ~CompressedFile();
+
+    CompressedFile(const CompressedFile&) = delete;
+    CompressedFile& operator=(const CompressedFile&) = delete;
+
+    // Format from the magic bytes at the start of the file
+    static Format detect(const std::string& path);
+    static const char* formatName(Format format);
+
+    // Open and start indexing in the background
+    bool open(const std::string& path, uint64_t span = SPAN);
+    void close();
+
+    Format format() const;
+    const std::string& error() const;
+
+    bool complete() const;
+    double progress() const;        // Fraction of the compressed input indexed
+    uint64_t size() const;          // Decompressed bytes seen so far
+    uint64_t knownLines() const;    // Lines seen so far; the total once complete
+    size_t checkpointCount() const;
+    // Block until the background pass has finished
+    void waitForIndex();
+
+    // Decompressed bytes [offset, offset + length), fewer at the end of data.
+    // read() and line() keep decoder state and are meant for one thread.
+    bool read(uint64_t offset, uint64_t length, std::string& out);
+    // Line n (0-based) without its newline; false if it is not indexed yet
+    bool line(uint64_t n, std::string& text);
+    // Line containing the given decompressed offset, within the indexed part
+    uint64_t lineAtOffset(uint64_t offset);
+
+private:
+    void indexLoop();
+    void addCheckpoint(Checkpoint&& point);
+    void addLineStart(uint64_t offset);
+    const std::string* block(uint64_t blockIndex);
+    bool decodeBlock(uint64_t blockIndex, std::string& out);
+    std::unique_ptr<StreamDecoder> makeDecoder() const;
+
+    std::string path_;
+    std::string error_;
+    Format format_ = Format::NONE;
+    int fd_ = -1;
+    uint64_t compressedSize_ = 0;
+
+    // Built by the indexing thread, read by the viewer
+    mutable std::mutex mutex_;
+    std::vector<Checkpoint> checkpoints_;
+    uint64_t span_ = SPAN;
+    std::vector<uint64_t> lineStarts_;  // lineStarts_[k] = start of line k * lineStride_
+    uint64_t lineStride_ = LINE_STRIDE;
+    std::atomic<uint64_t> compressedDone_{0};
+    std::atomic<uint64_t> size_{0};
+    std::atomic<uint64_t> newlines_{0};
+    std::atomic<bool> lastByteNewline_{true};
+    std::atomic<bool> complete_{false};
+    std::atomic<bool> stopping_{false};
+    std::thread indexer_;
+
+    // Reader state: a decoder left where the last block ended, and recent blocks
+    std::unique_ptr<StreamDecoder> cursor_;
+    uint64_t cursorOut_ = 0;
+    std::list<uint64_t> lru_;
+    std::unordered_map<uint64_t, std::pair<std::string, std::list<uint64_t>::iterator>> blocks_;
+};
+
+#endif // VIEWER_COMPRESSEDFILE_H
@@ -0,0 +1,57 @@
+#ifndef VIEWER_CONTENTSEARCH_H
+#define VIEWER_CONTENTSEARCH_H
+
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Literal search over a mapped file on a worker thread. The scan starts at
+// a given offset, wraps around once, and checks for cancellation between
+// chunks so that a search through gigabytes can be abandoned at any time.
+class ContentSearch {
+public:
+    enum class State { IDLE, RUNNING, FOUND, NOT_FOUND, CANCELLED };
+
+    static const uint64_t CHUNK = 16 << 20;
+
+    explicit ContentSearch(const MappedFile& file);
+    ~ContentSearch();
+
+    ContentSearch(const ContentSearch&) = delete;
+    ContentSearch& operator=(const ContentSearch&) = delete;
+
+    // Forward: first match starting at or after from. Backward: last match
+    // starting before from. Replaces any search still running.
+    void start(const std::string& pattern, uint64_t from, bool forward);
+    // Stop the worker and wait for it; no-op when idle
+    void cancel();
+
+    State state() const;
+    uint64_t result() const;    // Match offset once FOUND
+    bool wrapped() const;       // The match was found after wrapping around
+    double progress() const;    // Fraction of the file scanned
+    const std::string& pattern() const;
+
+    // First match in [from, to) (forward) or the last one (backward)
+    static bool findForward(const char* data, uint64_t from, uint64_t to,
+                            const std::string& pattern, uint64_t& found);
+    static bool findBackward(const char* data, uint64_t from, uint64_t to,
+                             const std::string& pattern, uint64_t& found);
+
+private:
+    void run(uint64_t from, bool forward);
+    bool scanRange(uint64_t begin, uint64_t end, bool forward, uint64_t& found);
+
+    const MappedFile& file_;
+    std::string pattern_;
+    std::thread worker_;
+    std::atomic<State> state_{State::IDLE};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<uint64_t> result_{0};
+    std::atomic<bool> wrapped_{false};
+    std::atomic<uint64_t> scanned_{0};
+};
+
+#endif // VIEWER_CONTENTSEARCH_H
@@ -0,0 +1,34 @@
+#ifndef VIEWER_FILEWATCHER_H
+#define VIEWER_FILEWATCHER_H
+
+#include <string>
+
+// Change notifications for one file path, backed by inotify on Linux.
+// Both the file and its directory are watched, so a log that is rotated
+// (renamed away and recreated) is noticed as well as one that grows.
+// fd() can be polled together with other descriptors; it is -1 where
+// inotify is unavailable, in which case callers have to poll the file.
+class FileWatcher {
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool watch(const std::string& path);
+    void stop();
+
+    int fd() const;
+    // Drain pending events; true if any concerned the watched path
+    bool readEvents();
+
+private:
+    std::string path_;
+    std::string name_;  // File name within the directory
+    int fd_ = -1;
+    int fileWatch_ = -1;
+    int dirWatch_ = -1;
+};
+
+#endif // VIEWER_FILEWATCHER_H
@@ -0,0 +1,38 @@
+#ifndef VIEWER_HEXFORMAT_H
+#define VIEWER_HEXFORMAT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Helpers for the hex viewer. Everything works on a mapped byte range, so
+// rows are formatted straight from the mapping at any offset.
+namespace HexFormat {
+
+// Bytes examined when deciding whether a file is binary
+const uint64_t SNIFF_BYTES = 8192;
+
+// True if the start of the data contains a NUL byte
+bool looksBinary(const char* data, uint64_t size);
+
+// Widest row (a multiple of 8 bytes, at least 8) that fits in the columns
+int bytesPerRow(int columns);
+
+// "0000001f0  48 65 6c 6c 6f 00 ...  |Hello.|" for the row starting at offset
+std::string formatRow(const char* data, uint64_t size, uint64_t offset, int bytesPerRow);
+
+// Parse a search pattern: hex bytes ("de ad be ef", "deadbeef") or a quoted
+// string ("\"ELF\""). Returns false if the text is neither.
+bool parsePattern(const std::string& text, std::vector<uint8_t>& pattern);
+
+// Parse an offset: decimal, 0x-prefixed hex, or a percentage ("50%")
+bool parseOffset(const std::string& text, uint64_t size, uint64_t& offset);
+
+// First occurrence of the pattern at or after from, wrapping around to the
+// start of the data once
+bool findPattern(const char* data, uint64_t size, uint64_t from,
+                 const std::vector<uint8_t>& pattern, uint64_t& found);
+
+} // namespace HexFormat
+
+#endif // VIEWER_HEXFORMAT_H
@@ -0,0 +1,73 @@
+#ifndef VIEWER_LINEINDEX_H
+#define VIEWER_LINEINDEX_H
+
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sparse index of line start offsets in a mapped file.
+// Only every STRIDE-th line start is stored; the lines in between are found
+// with a short forward scan. The index grows on demand as the view asks for
+// lines, and can also be completed by a background thread so that any line
+// number can later be reached in constant time. When the number of stored
+// starts passes maxCheckpoints the stride doubles and every other one is
+// dropped, so a file that keeps growing never grows the index without bound.
+class LineIndex {
+public:
+    static const uint64_t STRIDE = 64;
+    static const uint64_t SCAN_CHUNK = 1 << 20;
+    static const size_t MAX_CHECKPOINTS = 1 << 18;
+
+    explicit LineIndex(const MappedFile& file, size_t maxCheckpoints = MAX_CHECKPOINTS);
+    ~LineIndex();
+
+    LineIndex(const LineIndex&) = delete;
+    LineIndex& operator=(const LineIndex&) = delete;
+
+    // Byte range of line n (0-based), without its newline. Indexes up to n
+    // on demand; returns false if the file has fewer lines.
+    bool lineRange(uint64_t line, uint64_t& start, uint64_t& length);
+    bool hasLine(uint64_t line);
+
+    bool complete() const;
+    // Lines found so far; the total once complete() is true
+    uint64_t knownLines() const;
+    // Fraction of the file scanned, 0.0 to 1.0
+    double progress() const;
+    // Line containing the given byte offset (indexes up to it)
+    uint64_t lineAtOffset(uint64_t offset);
+    // Index the rest of the file on this thread and return the line count
+    uint64_t lineCount();
+
+    // Index the whole file on a worker thread while the caller keeps reading
+    void startBackgroundIndexing();
+    void stopBackgroundIndexing();
+
+    // Forget everything, e.g. after the file was truncated or replaced.
+    // Stops background indexing; the caller restarts it if wanted.
+    void reset();
+    // Lines between two stored starts (STRIDE until the index is compacted)
+    uint64_t stride() const;
+
+private:
+    bool ensureLine(uint64_t line);
+    void scanChunk();
+    uint64_t lineStart(uint64_t line) const;
+    void backgroundLoop();
+    void addCheckpoint(uint64_t offset);
+
+    const MappedFile& file_;
+    mutable std::mutex mutex_;           // Guards checkpoints_ and the scan itself
+    std::vector<uint64_t> checkpoints_; // checkpoints_[k] = start of line k * stride_
+    uint64_t stride_ = STRIDE;
+    size_t maxCheckpoints_;
+    std::atomic<uint64_t> scannedBytes_{0};
+    std::atomic<uint64_t> newlines_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread indexer_;
+};
+
+#endif // VIEWER_LINEINDEX_H
@@ -0,0 +1,119 @@
+#ifndef VIEWER_LINESOURCE_H
+#define VIEWER_LINESOURCE_H
+
+#include "CompressedFile.h"
+#include "LineIndex.h"
+#include "LineWrapper.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// The lines a text view scrolls through, wrapped to the screen width.
+// The view only asks for the lines it draws, so a source may still be
+// indexing (or decompressing) further on; the plain and compressed viewers
+// share one scrolling loop over this interface.
+class LineSource {
+public:
+    virtual ~LineSource() = default;
+
+    // Rows of line n at the given width, as offsets into text(n); empty if
+    // the line has not been reached. Valid until the next trim().
+    virtual const std::vector<RowSegment>& rows(uint64_t line, int width) = 0;
+    virtual const char* text(uint64_t line) = 0;
+    virtual bool hasLine(uint64_t line) = 0;
+
+    virtual bool complete() const = 0;
+    // Lines seen so far; the total once complete
+    virtual uint64_t knownLines() const = 0;
+    // Total lines, counting to the end first where that is possible
+    virtual uint64_t lineCount() = 0;
+    // Line at a percentage of the file (of the part seen so far)
+    virtual uint64_t lineAtPercent(uint64_t percent) = 0;
+
+    // For the title ("gzip"); empty for plain text
+    virtual std::string format() const = 0;
+    // For the status bar, e.g. indexing progress; may be empty
+    virtual std::string progressNote() const = 0;
+
+    // Drop cached lines far from the top of the view
+    virtual void trim(uint64_t topLine) = 0;
+};
+
+// A memory-mapped text file, indexed in the background
+class MappedLineSource : public LineSource {
+public:
+    // Smallest read-ahead past the view; a screen of short lines is only a few KiB
+    static const uint64_t PREFETCH_MIN_BYTES = 64 << 10;
+
+    // Starts indexing right away
+    explicit MappedLineSource(MappedFile& file);
+
+    const std::vector<RowSegment>& rows(uint64_t line, int width) override;
+    const char* text(uint64_t line) override;
+    bool hasLine(uint64_t line) override;
+    bool complete() const override;
+    uint64_t knownLines() const override;
+    uint64_t lineCount() override;
+    uint64_t lineAtPercent(uint64_t percent) override;
+    std::string format() const override;
+    std::string progressNote() const override;
+    void trim(uint64_t topLine) override;
+
+    MappedFile& file() { return file_; }
+    uint64_t lineAtOffset(uint64_t offset);
+
+    // Pick up changes for follow mode. True if the file was truncated or
+    // replaced, so the view has to start over. Nothing may be reading the
+    // mapping (a search) while this runs.
+    bool reload(const std::string& path);
+    // Two screens' worth ahead of the visible bytes, in the direction of scrolling
+    void readAhead(uint64_t viewBegin, uint64_t viewEnd);
+
+private:
+    MappedFile& file_;
+    LineIndex index_;
+    WrapCache wrapCache_;
+    uint64_t lastViewBegin_ = 0;
+    bool scrollingForward_ = true;
+    uint64_t prefetchBegin_ = 0;
+    uint64_t prefetchEnd_ = 0;
+};
+
+// A gzip or zstd file, decompressed on the fly
+class CompressedLineSource : public LineSource {
+public:
+    // Lines kept around the view; they are cheap to decompress again from
+    // the block cache, so this only saves rewrapping while scrolling
+    static const size_t MAX_CACHED_LINES = 512;
+
+    explicit CompressedLineSource(CompressedFile& file);
+
+    const std::vector<RowSegment>& rows(uint64_t line, int width) override;
+    const char* text(uint64_t line) override;
+    bool hasLine(uint64_t line) override;
+    bool complete() const override;
+    uint64_t knownLines() const override;
+    uint64_t lineCount() override;
+    uint64_t lineAtPercent(uint64_t percent) override;
+    std::string format() const override;
+    std::string progressNote() const override;
+    void trim(uint64_t topLine) override;
+
+private:
+    // A decompressed line and its rows at the current width
+    struct WrappedLine {
+        std::string text;
+        std::vector<RowSegment> rows;
+    };
+
+    const WrappedLine& lineAt(uint64_t line, int width);
+
+    CompressedFile& file_;
+    std::map<uint64_t, WrappedLine> lines_;
+    int width_ = -1;
+    const WrappedLine missing_;
+};
+
+#endif // VIEWER_LINESOURCE_H
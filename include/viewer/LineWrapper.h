@@ -0,0 +1,51 @@
+#ifndef VIEWER_LINEWRAPPER_H
+#define VIEWER_LINEWRAPPER_H
+
+#include "LineIndex.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// One screen row: a slice of a line in the mapped file
+struct RowSegment {
+    uint64_t start;
+    uint64_t length;
+};
+
+// Wrap a line to the given width, preferring to break at spaces. Lines
+// longer than MAX_LINE_BYTES are cut off instead of being wrapped in full.
+std::vector<RowSegment> wrapLine(const char* data, uint64_t start, uint64_t length, int width);
+
+// Wrapped rows of the lines around the viewport, keyed by line number for
+// the current width. A different width drops everything, so after a resize
+// only the lines that are drawn again get rewrapped.
+class WrapCache {
+public:
+    static const uint64_t MAX_LINE_BYTES = 1 << 20;
+    static const size_t MAX_LINES = 1024;
+
+    WrapCache(const MappedFile& file, LineIndex& index);
+
+    // Rows of the line at the given width; empty if the file has no such line.
+    // The reference stays valid until the next trim() or clear().
+    const std::vector<RowSegment>& rows(uint64_t line, int width);
+
+    // Drop lines far away from the top of the view once the cache is full
+    void trim(uint64_t topLine);
+    // Forget lines from the given one on, e.g. a last line that grew
+    void invalidateFrom(uint64_t line);
+    void clear();
+
+    size_t size() const;
+    int width() const;
+
+private:
+    const MappedFile& file_;
+    LineIndex& index_;
+    int width_ = -1;
+    std::unordered_map<uint64_t, std::vector<RowSegment>> lines_;
+    const std::vector<RowSegment> missing_;
+};
+
+#endif // VIEWER_LINEWRAPPER_H
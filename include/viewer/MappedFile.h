@@ -0,0 +1,56 @@
+#ifndef VIEWER_MAPPEDFILE_H
+#define VIEWER_MAPPEDFILE_H
+
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are only faulted in when
+// touched, so opening is O(1) regardless of the file size.
+//
+// A file truncated while it is mapped would kill the process with SIGBUS
+// on the next read past its new end, whether from the view, the indexer or
+// a search. A handler maps zeros over those pages instead, so such reads
+// see NULs, and shrank() tells the owner to reopen the file.
+class MappedFile {
+public:
+    // What refresh() found when it looked at the file again
+    enum class Change {
+        NONE,       // Same file, same size
+        GREW,       // Data was appended; the mapping now covers it
+        TRUNCATED,  // Same file, but shorter than before
+        REPLACED    // The path now names a different file (rotation)
+    };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    // Re-check the file behind the path. Growth is handled by extending the
+    // mapping in place; on TRUNCATED or REPLACED the caller should reopen.
+    Change refresh();
+    // Whether a read went past the end of the file since it was opened;
+    // refresh() then reports TRUNCATED
+    bool shrank() const;
+
+    bool isOpen() const;
+    const char* data() const;
+    uint64_t size() const;
+    const std::string& path() const;
+    const std::string& error() const;
+
+private:
+    std::string path_;
+    std::string error_;
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    uint64_t size_ = 0;
+    uint64_t device_ = 0;
+    uint64_t inode_ = 0;
+    int guard_ = -1; // Slot of the mapping in the SIGBUS handler's table
+};
+
+#endif // VIEWER_MAPPEDFILE_H
@@ -0,0 +1,85 @@
+#ifndef VIEWER_PREVIEWER_H
+#define VIEWER_PREVIEWER_H
+
+#include "../FileSystem.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Short previews of files and directories for the split view: the first
+// lines of a text file (decompressed for gzip), a hex dump of a binary, or
+// the entries of a directory.
+//
+// Previews are made on a worker thread. Only the latest request matters:
+// asking for another item cancels the one in progress, so scrolling through
+// a listing never waits on preview I/O. Finished previews are kept in an
+// LRU keyed by path, size and modification time.
+//
+// Only regular files and directories are read; pipes, sockets and devices
+// could block or have side effects when opened. The worker is detached, as
+// in DirectoryLoader, so a read stuck on a hung mount does not hold up the
+// Previewer's destruction.
+class Previewer {
+public:
+    struct Preview {
+        std::string kind;               // "text", "hex", "gzip", "directory", "special" or "error"
+        std::vector<std::string> lines; // Printable; tabs expanded
+    };
+
+    static const size_t CACHE_ENTRIES = 64;
+    static const size_t MAX_LINES = 200;
+    static const size_t READ_BYTES = 64 << 10;
+    static const int HEX_ROW_BYTES = 8;
+
+    explicit Previewer(size_t cacheEntries = CACHE_ENTRIES);
+    ~Previewer();
+
+    Previewer(const Previewer&) = delete;
+    Previewer& operator=(const Previewer&) = delete;
+
+    // The cached preview of the item if there is one; otherwise start making
+    // it in place of whatever was requested before, and return false
+    bool request(const std::string& path, const FileInfo& info, Preview& preview);
+    // Forget all previews
+    void clear();
+
+    // Make a preview on the calling thread; stops early once *cancelled is set
+    static Preview generate(const std::string& path, FileInfo::FileType type,
+                            const std::atomic<bool>* cancelled = nullptr);
+
+private:
+    struct Entry {
+        Preview preview;
+        std::list<std::string>::iterator position;
+    };
+
+    // Shared with the worker thread, which may outlive the Previewer
+    struct Shared {
+        std::mutex mutex;
+        std::condition_variable requested;
+        size_t capacity = 0;
+        std::list<std::string> lru; // Most recently used first
+        std::unordered_map<std::string, Entry> cache;
+
+        // The request the worker should serve next
+        std::string wantedKey;
+        std::string wantedPath;
+        FileInfo::FileType wantedType = FileInfo::FileType::UNKNOWN;
+        bool hasWork = false;
+        std::atomic<bool> cancelled{false};
+        bool stopping = false;
+    };
+
+    static std::string keyOf(const std::string& path, const FileInfo& info);
+    static void run(std::shared_ptr<Shared> shared);
+
+    std::shared_ptr<Shared> shared_;
+};
+
+#endif // VIEWER_PREVIEWER_H
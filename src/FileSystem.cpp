@@ -18,8 +18,9 @@
 // FileInfo implementation
 FileInfo::FileInfo(const std::string& name, FileType type, size_t size,
                    std::chrono::system_clock::time_point modified_time,
-                   uint32_t permissions)
-    : name_(name), type_(type), size_(size), modified_time_(modified_time), permissions_(permissions) {}
+                   uint32_t permissions, uint64_t device, uint64_t inode)
+    : name_(name), type_(type), size_(size), modified_time_(modified_time), permissions_(permissions),
+      device_(device), inode_(inode) {}
 
 const std::string& FileInfo::getName() const {
     return name_;
@@ -41,6 +42,14 @@ uint32_t FileInfo::getPermissions() const {
     return permissions_;
 }
 
+uint64_t FileInfo::getDevice() const {
+    return device_;
+}
+
+uint64_t FileInfo::getInode() const {
+    return inode_;
+}
+
 // Helper function to convert time_t to system_clock::time_point
 std::chrono::system_clock::time_point time_t_to_time_point(time_t t) {
     return std::chrono::system_clock::from_time_t(t);
@@ -102,12 +111,12 @@ FileInfo FileSystem::createFileInfo(const std::string& name,
     auto modified_time = time_t_to_time_point(stat_buf.st_mtime);
     uint32_t permissions = stat_buf.st_mode & 0777;
 
-    return FileInfo(name, type, size, modified_time, permissions);
+    return FileInfo(name, type, size, modified_time, permissions, stat_buf.st_dev, stat_buf.st_ino);
 #endif
 }
 
 // List directory contents
-std::vector<FileInfo> FileSystem::listDirectory(const std::string& path) {
+std::vector<FileInfo> FileSystem::listDirectory(const std::string& path, const std::atomic<bool>* cancelled) {
     std::vector<FileInfo> files;
     std::string search_path = path;
 
@@ -129,6 +138,9 @@ std::vector<FileInfo> FileSystem::listDirectory(const std::string& path) {
     }
 
     do {
+        if (cancelled && *cancelled) {
+            break;
+        }
         std::string name(find_data.cFileName);
         if (name != "." && name != "..") {
             files.push_back(createFileInfo(name, find_data));
@@ -149,6 +161,9 @@ std::vector<FileInfo> FileSystem::listDirectory(const std::string& path) {
 
     struct dirent* entry;
     while ((entry = readdir(dir)) != nullptr) {
+        if (cancelled && *cancelled) {
+            break;
+        }
         std::string name(entry->d_name);
         if (name != "." && name != "..") {
             // Get full path for stat
@@ -6,9 +6,104 @@
 #include <unistd.h>
 #include <pwd.h>
 #include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
 
 // Static member definition
 std::vector<std::string> BookMark::bookMarks;
+std::vector<std::string> BookMark::pendingChanges;
+
+namespace {
+
+bool homeDirectory(std::string& home) {
+    const char* homeDir = getenv("HOME");
+    if (!homeDir) {
+        // Fallback to passwd lookup if HOME is not set
+        struct passwd* pw = getpwuid(getuid());
+        if (!pw) {
+            std::cerr << "Error: Could not determine home directory" << std::endl;
+            return false;
+        }
+        homeDir = pw->pw_dir;
+    }
+    home = homeDir;
+    return true;
+}
+
+// Replay one journal line onto a list of bookmarks
+void applyChange(std::vector<std::string>& marks, const std::string& line) {
+    if (line == "!") {
+        marks.clear();
+    } else if (line.size() > 1 && line[0] == '+') {
+        std::string path = line.substr(1);
+        if (std::find(marks.begin(), marks.end(), path) == marks.end()) {
+            marks.push_back(path);
+        }
+    } else if (line.size() > 1 && line[0] == '-') {
+        marks.erase(std::remove(marks.begin(), marks.end(), line.substr(1)), marks.end());
+    }
+}
+
+// The snapshot with the journal replayed on top; the caller holds the journal lock
+void readState(const std::string& snapshotFile, int journal, std::vector<std::string>& marks) {
+    marks.clear();
+    std::ifstream file(snapshotFile);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            marks.push_back(line);
+        }
+    }
+
+    if (journal < 0) {
+        return;
+    }
+    std::string content;
+    char buffer[8192];
+    ssize_t count;
+    off_t offset = 0;
+    while ((count = pread(journal, buffer, sizeof(buffer), offset)) > 0) {
+        content.append(buffer, count);
+        offset += count;
+    }
+    // Only complete lines; a crash can leave the last one cut short
+    size_t start = 0;
+    size_t end;
+    while ((end = content.find('\n', start)) != std::string::npos) {
+        applyChange(marks, content.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+// Fold the journal into a new snapshot and empty it; the caller holds the lock
+bool compactJournal(const std::string& snapshotFile, int journal) {
+    std::vector<std::string> marks;
+    readState(snapshotFile, journal, marks);
+
+    std::string temporary = snapshotFile + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open bookmarks file for writing: " << temporary << std::endl;
+        return false;
+    }
+    std::string content;
+    for (const auto& mark : marks) {
+        content += mark + "\n";
+    }
+    bool written = write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()) &&
+                   fsync(fd) == 0;
+    close(fd);
+    if (!written || rename(temporary.c_str(), snapshotFile.c_str()) != 0) {
+        std::cerr << "Error: Could not replace bookmarks file: " << snapshotFile << std::endl;
+        unlink(temporary.c_str());
+        return false;
+    }
+    // Replaying the journal again after a crash right here gives the same list
+    return ftruncate(journal, 0) == 0;
+}
+
+} // namespace
 
 bool BookMark::addBookMark(std::string path) {
     // Check if bookmark already exists
@@ -17,6 +112,7 @@ bool BookMark::addBookMark(std::string path) {
     }
     
     bookMarks.push_back(path);
+    pendingChanges.push_back("+" + path);
     return true; // Successfully added
 }
 
@@ -24,6 +120,7 @@ bool BookMark::removeBookMark(std::string path) {
     auto it = std::find(bookMarks.begin(), bookMarks.end(), path);
     if (it != bookMarks.end()) {
         bookMarks.erase(it);
+        pendingChanges.push_back("-" + path);
         return true; // Successfully removed
     }
     return false; // Bookmark not found
@@ -32,75 +129,87 @@ bool BookMark::removeBookMark(std::string path) {
 bool BookMark::emptyBookMarks() {
     bool isEmpty = bookMarks.empty();
     bookMarks.clear();
+    if (!isEmpty) {
+        pendingChanges.push_back("!");
+    }
     return !isEmpty; // Return true if there were elements to clear
 }
 
 bool BookMark::saveBookMarks() {
-    // Get home directory path
-    const char* homeDir = getenv("HOME");
-    if (!homeDir) {
-        // Fallback to passwd lookup if HOME is not set
-        struct passwd* pw = getpwuid(getuid());
-        if (!pw) {
-            std::cerr << "Error: Could not determine home directory" << std::endl;
-            return false;
-        }
-        homeDir = pw->pw_dir;
+    // Nothing changed since loading: leave the files alone
+    if (pendingChanges.empty()) {
+        return true;
     }
     
-    // Create full path to bookmarks file
-    std::string bookmarksFile = std::string(homeDir) + "/.bookmarks.txt";
+    std::string homeDir;
+    if (!homeDirectory(homeDir)) {
+        return false;
+    }
+    std::string bookmarksFile = homeDir + "/.bookmarks.txt";
+    std::string journalFile = homeDir + "/.bookmarks.journal";
     
-    // Open file for writing
-    std::ofstream file(bookmarksFile);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open bookmarks file for writing: " << bookmarksFile << std::endl;
+    int journal = open(journalFile.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (journal < 0) {
+        std::cerr << "Error: Could not open bookmarks journal for writing: " << journalFile << std::endl;
         return false;
     }
+    flock(journal, LOCK_EX);
     
-    // Write all bookmarks to file
-    for (const auto& bookmark : bookMarks) {
-        file << bookmark << std::endl;
+    // Cut off a line left unfinished by a crash, so the next one starts cleanly
+    struct stat info;
+    char last = '\n';
+    if (fstat(journal, &info) == 0 && info.st_size > 0) {
+        pread(journal, &last, 1, info.st_size - 1);
+    }
+    if (last != '\n') {
+        off_t keep = info.st_size - 1;
+        while (keep > 0 && pread(journal, &last, 1, keep - 1) == 1 && last != '\n') {
+            keep--;
+        }
+        ftruncate(journal, keep);
+        info.st_size = keep;
     }
     
-    file.close();
-    return true;
+    // All changes in one write
+    std::string content;
+    for (const auto& change : pendingChanges) {
+        content += change + "\n";
+    }
+    bool written = write(journal, content.data(), content.size()) == static_cast<ssize_t>(content.size()) &&
+                   fsync(journal) == 0;
+    if (!written) {
+        std::cerr << "Error: Could not write bookmarks journal: " << journalFile << std::endl;
+    } else if (info.st_size + static_cast<off_t>(content.size()) > JOURNAL_COMPACT_BYTES) {
+        compactJournal(bookmarksFile, journal);
+    }
+    
+    flock(journal, LOCK_UN);
+    close(journal);
+    if (written) {
+        pendingChanges.clear();
+    }
+    return written;
 }
 
 bool BookMark::loadBookMarks() {
-    // Get home directory path
-    const char* homeDir = getenv("HOME");
-    if (!homeDir) {
-        // Fallback to passwd lookup if HOME is not set
-        struct passwd* pw = getpwuid(getuid());
-        if (!pw) {
-            std::cerr << "Error: Could not determine home directory" << std::endl;
-            return false;
-        }
-        homeDir = pw->pw_dir;
+    std::string homeDir;
+    if (!homeDirectory(homeDir)) {
+        return false;
     }
+    std::string bookmarksFile = homeDir + "/.bookmarks.txt";
+    std::string journalFile = homeDir + "/.bookmarks.journal";
     
-    // Create full path to bookmarks file
-    std::string bookmarksFile = std::string(homeDir) + "/.bookmarks.txt";
-    
-    // Open file for reading
-    std::ifstream file(bookmarksFile);
-    if (!file.is_open()) {
-        // File doesn't exist, which is okay for first run
-        return true;
+    // A missing journal (or snapshot) is fine, for example on first run
+    int journal = open(journalFile.c_str(), O_RDONLY);
+    if (journal >= 0) {
+        flock(journal, LOCK_SH);
     }
-    
-    // Clear existing bookmarks
-    bookMarks.clear();
-    
-    // Read bookmarks from file
-    std::string line;
-    while (std::getline(file, line)) {
-        if (!line.empty()) {
-            bookMarks.push_back(line);
-        }
+    readState(bookmarksFile, journal, bookMarks);
+    if (journal >= 0) {
+        flock(journal, LOCK_UN);
+        close(journal);
     }
     
-    file.close();
+    pendingChanges.clear();
     return true;
-}
\ No newline at end of file
+}
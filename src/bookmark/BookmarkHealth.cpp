@@ -0,0 +1,218 @@
+#include "../../include/bookmark/BookmarkHealth.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+
+constexpr std::chrono::milliseconds BookmarkHealth::DEFAULT_TIMEOUT;
+constexpr std::chrono::milliseconds BookmarkHealth::POLL_INTERVAL;
+const size_t BookmarkHealth::MAX_WORKERS;
+const size_t BookmarkHealth::MAX_ABANDONED;
+
+BookmarkHealth::BookmarkHealth(const std::vector<std::string>& paths, std::chrono::milliseconds timeout,
+                               Checker checker)
+    : shared_(std::make_shared<Shared>()), timeout_(timeout), created_(std::chrono::steady_clock::now()) {
+    if (!checker) {
+        checker = [](const std::string& path) {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0 ? 0 : errno;
+        };
+    }
+
+    shared_->results.resize(paths.size());
+    shared_->started.resize(paths.size());
+    shared_->remaining = paths.size();
+    for (size_t i = 0; i < paths.size(); i++) {
+        shared_->results[i].path = paths[i];
+    }
+
+    Pool& workers = pool();
+    std::lock_guard<std::mutex> lock(workers.mutex);
+    for (size_t i = 0; i < paths.size(); i++) {
+        // The job holds its own reference, so it can finish after we are gone
+        std::shared_ptr<Job>& job = workers.inFlight[paths[i]];
+        if (!job) {
+            job = std::make_shared<Job>();
+            job->path = paths[i];
+            job->checker = checker;
+            job->timeout = timeout;
+            workers.queue.push_back(job);
+        }
+        // Nobody else sees our results yet, and workers only start jobs
+        // with the pool locked
+        shared_->started[i] = job->started;
+        job->waiters.emplace_back(shared_, i);
+    }
+    reap(workers);
+}
+
+BookmarkHealth::Pool& BookmarkHealth::pool() {
+    // Never destroyed: workers may still be stuck in a check at exit
+    static Pool* instance = new Pool;
+    return *instance;
+}
+
+void BookmarkHealth::reap(Pool& workers) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& job : workers.running) {
+        if (!job->abandoned && workers.abandoned < MAX_ABANDONED && now - job->started > job->timeout) {
+            job->abandoned = true;
+            workers.workers--;
+            workers.busy--;
+            workers.abandoned++;
+        }
+    }
+
+    // Enough workers for the queue, up to the limit
+    while (workers.workers < MAX_WORKERS && workers.workers - workers.busy < workers.queue.size()) {
+        try {
+            std::thread(work).detach();
+        } catch (const std::system_error&) {
+            // Whatever is queued waits for a worker that is already running
+            break;
+        }
+        workers.workers++;
+    }
+
+    // With every worker stuck past the abandoned limit, the queue only
+    // moves when a mount comes back
+    bool moving = false;
+    for (auto& job : workers.running) {
+        if (!job->abandoned && now - job->started <= job->timeout) {
+            moving = true;
+            break;
+        }
+    }
+    workers.stalled = !workers.queue.empty() && workers.workers == workers.busy && !moving;
+}
+
+void BookmarkHealth::work() {
+    Pool& workers = pool();
+    std::unique_lock<std::mutex> lock(workers.mutex);
+    while (!workers.queue.empty()) {
+        std::shared_ptr<Job> job = workers.queue.front();
+        workers.queue.pop_front();
+        workers.busy++;
+        workers.running.push_back(job);
+        // Each path's timeout runs from here
+        job->started = std::chrono::steady_clock::now();
+        for (auto& waiter : job->waiters) {
+            std::lock_guard<std::mutex> started(waiter.first->mutex);
+            waiter.first->started[waiter.second] = job->started;
+        }
+        lock.unlock();
+
+        int error = job->checker(job->path);
+        Result answer;
+        answer.status = classify(error);
+        if (answer.status == Status::FAILED) {
+            answer.error = strerror(error);
+        }
+
+        lock.lock();
+        workers.running.erase(std::find(workers.running.begin(), workers.running.end(), job));
+        // Checks started from now on ask again
+        workers.inFlight.erase(job->path);
+        std::vector<std::pair<std::shared_ptr<Shared>, size_t>> waiters = std::move(job->waiters);
+        bool leftBehind = job->abandoned;
+        if (leftBehind) {
+            // Another worker has taken our place
+            workers.abandoned--;
+        } else {
+            workers.busy--;
+        }
+        lock.unlock();
+
+        for (auto& waiter : waiters) {
+            std::lock_guard<std::mutex> answered(waiter.first->mutex);
+            Result& result = waiter.first->results[waiter.second];
+            result.status = answer.status;
+            result.error = answer.error;
+            waiter.first->remaining--;
+            waiter.first->answered.notify_all();
+        }
+        if (leftBehind) {
+            return;
+        }
+        lock.lock();
+    }
+    workers.workers--;
+}
+
+std::vector<BookmarkHealth::Result> BookmarkHealth::results() const {
+    bool stalled;
+    {
+        Pool& workers = pool();
+        std::lock_guard<std::mutex> lock(workers.mutex);
+        reap(workers);
+        stalled = workers.stalled;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point queued;
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    std::vector<Result> results = shared_->results;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results[i].status != Status::PENDING) {
+            continue;
+        }
+        std::chrono::steady_clock::time_point started = shared_->started[i];
+        if (started != queued ? now - started > timeout_ : stalled && now - created_ > timeout_) {
+            results[i].status = Status::TIMED_OUT;
+        }
+    }
+    return results;
+}
+
+bool BookmarkHealth::done() const {
+    for (const auto& result : results()) {
+        if (result.status == Status::PENDING) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<BookmarkHealth::Result> BookmarkHealth::wait() {
+    // Per-path timeouts start as workers get to them, so look again now and then
+    while (!done()) {
+        std::unique_lock<std::mutex> lock(shared_->mutex);
+        shared_->answered.wait_for(lock, POLL_INTERVAL, [&] { return shared_->remaining == 0; });
+    }
+    return results();
+}
+
+const char* BookmarkHealth::statusName(Status status) {
+    switch (status) {
+        case Status::PENDING:
+            return "checking";
+        case Status::EXISTS:
+            return "ok";
+        case Status::MISSING:
+            return "missing";
+        case Status::DENIED:
+            return "denied";
+        case Status::FAILED:
+            return "error";
+        case Status::TIMED_OUT:
+            return "timed out";
+    }
+    return "";
+}
+
+BookmarkHealth::Status BookmarkHealth::classify(int error) {
+    switch (error) {
+        case 0:
+            return Status::EXISTS;
+        case ENOENT:
+        case ENOTDIR:
+            return Status::MISSING;
+        case EACCES:
+        case EPERM:
+            return Status::DENIED;
+        default:
+            return Status::FAILED;
+    }
+}
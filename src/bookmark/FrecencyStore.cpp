@@ -0,0 +1,493 @@
+#include "../../include/bookmark/FrecencyStore.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <pwd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const size_t FrecencyStore::COMPACT_MIN_LINES;
+const double FrecencyStore::MAX_TOTAL_RANK = 10000;
+const double FrecencyStore::RANK_PER_ENTRY = 4;
+const size_t FrecencyStore::MAX_POSTINGS_SCAN;
+
+namespace {
+
+// The most frecency() weighs a rank by
+const double MAX_WEIGHT = 4;
+
+// Changed ranks collected before byScore_ is sorted again
+const size_t MAX_DIRTY = 1024;
+
+std::string defaultLogPath() {
+    const char* homeDir = getenv("HOME");
+    if (!homeDir) {
+        // Fallback to passwd lookup if HOME is not set
+        struct passwd* pw = getpwuid(getuid());
+        if (!pw) {
+            return "";
+        }
+        homeDir = pw->pw_dir;
+    }
+    return std::string(homeDir) + "/.frecency.log";
+}
+
+std::string fold(const std::string& text) {
+    std::string folded(text);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return folded;
+}
+
+uint32_t trigram(const char* p) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<unsigned char>(p[2]);
+}
+
+// Above every trigram, so both share one index
+uint32_t bigram(const char* p) {
+    return (1u << 24) | (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 8) |
+           static_cast<unsigned char>(p[1]);
+}
+
+// Write all of data, retrying short writes
+bool writeAll(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t count = write(fd, data.data() + done, data.size() - done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        done += count;
+    }
+    return true;
+}
+
+std::string formatLine(double rank, std::time_t last, const std::string& path) {
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "%.3f\t%lld\t", rank, static_cast<long long>(last));
+    return prefix + path + "\n";
+}
+
+} // namespace
+
+FrecencyStore::FrecencyStore(const std::string& logPath)
+    : logPath_(logPath.empty() ? defaultLogPath() : logPath) {
+}
+
+bool FrecencyStore::load() {
+    if (!readLog()) {
+        return false;
+    }
+    if (logLines_ > std::max(COMPACT_MIN_LINES, live_ * 4)) {
+        return compact();
+    }
+    sortByScore();
+    return true;
+}
+
+bool FrecencyStore::readLog() {
+    entries_.clear();
+    ids_.clear();
+    grams_.clear();
+    byScore_.clear();
+    dirty_.clear();
+    live_ = 0;
+    logLines_ = 0;
+    totalRank_ = 0;
+
+    std::ifstream file(logPath_);
+    if (!file.is_open()) {
+        // No history yet
+        return true;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        // rank<TAB>time<TAB>path; anything else (a torn last line) is skipped
+        size_t first = line.find('\t');
+        size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+        if (second == std::string::npos || second + 1 >= line.size()) {
+            continue;
+        }
+        char* end = nullptr;
+        double rank = strtod(line.c_str(), &end);
+        if (end != line.c_str() + first) {
+            continue;
+        }
+        std::time_t last = static_cast<std::time_t>(strtoll(line.c_str() + first + 1, &end, 10));
+        if (end != line.c_str() + second) {
+            continue;
+        }
+        if (line.find('\t', second + 1) != std::string::npos) {
+            continue; // A torn line with the next one appended to it
+        }
+        apply(line.substr(second + 1), rank, last);
+        logLines_++;
+    }
+    return true;
+}
+
+bool FrecencyStore::record(const std::string& path, std::time_t now) {
+    // Tabs and newlines would not survive the log format
+    if (path.empty() || path.find_first_of("\t\n") != std::string::npos) {
+        return false;
+    }
+    apply(path, 1, now);
+    bool written = append(formatLine(1, now, path));
+    if (totalRank_ > std::max(MAX_TOTAL_RANK, live_ * RANK_PER_ENTRY) ||
+        logLines_ > std::max(COMPACT_MIN_LINES, live_ * 4)) {
+        return rewrite(path) && written;
+    }
+    if (dirty_.size() > MAX_DIRTY) {
+        sortByScore();
+    }
+    return written;
+}
+
+bool FrecencyStore::remove(const std::string& path) {
+    auto it = ids_.find(path);
+    if (it == ids_.end() || entries_[it->second].removed) {
+        return false;
+    }
+    apply(path, 0, 0);
+    // A zero rank in the log drops the directory when it is read back
+    return append(formatLine(0, 0, path));
+}
+
+bool FrecencyStore::compact() {
+    return rewrite("");
+}
+
+bool FrecencyStore::rewrite(const std::string& keep) {
+    // Other processes append while holding the lock shared, so nothing
+    // lands in the old log between reading it and replacing it
+    int lock = lockLog(LOCK_EX);
+    if (lock < 0) {
+        return false;
+    }
+    readLog();
+    if (totalRank_ > std::max(MAX_TOTAL_RANK, live_ * RANK_PER_ENTRY)) {
+        age(keep);
+    }
+
+    std::string temporary = logPath_ + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open history file for writing: " << temporary << std::endl;
+        close(lock);
+        return false;
+    }
+    std::string content;
+    std::vector<Entry> kept;
+    kept.reserve(live_);
+    for (auto& entry : entries_) {
+        if (!entry.removed) {
+            content += formatLine(entry.rank, entry.last, entry.path);
+            kept.push_back(std::move(entry));
+        }
+    }
+    bool written = fchmod(fd, 0644) == 0 && writeAll(fd, content);
+    written = close(fd) == 0 && written;
+    if (!written || rename(temporary.c_str(), logPath_.c_str()) != 0) {
+        std::cerr << "Error: Could not replace history file: " << logPath_ << std::endl;
+        unlink(temporary.c_str());
+        close(lock);
+        sortByScore();
+        return false;
+    }
+    close(lock);
+
+    entries_ = std::move(kept);
+    logLines_ = entries_.size();
+    rebuildIndex();
+    return true;
+}
+
+int FrecencyStore::lockLog(int operation) const {
+    // A file of its own, as the log itself is replaced when rewritten
+    std::string lockPath = logPath_ + ".lock";
+    int fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open history lock: " << lockPath << std::endl;
+        return -1;
+    }
+    // Closing the descriptor releases the lock
+    while (flock(fd, operation) != 0) {
+        if (errno != EINTR) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+std::vector<FrecencyStore::Match> FrecencyStore::query(const std::vector<std::string>& words, size_t limit,
+                                                       std::time_t now) const {
+    if (limit == 0) {
+        return {};
+    }
+    std::vector<std::string> folded;
+    for (const auto& word : words) {
+        if (!word.empty()) {
+            folded.push_back(fold(word));
+        }
+    }
+
+    // Candidates: directories whose name holds the rarest trigram of the last
+    // word, or its bigram if it has two letters
+    const std::vector<uint32_t>* postings = nullptr;
+    if (!folded.empty() && folded.back().size() >= 2) {
+        const std::string& last = folded.back();
+        size_t gram = last.size() == 2 ? 2 : 3;
+        for (size_t i = 0; i + gram <= last.size(); i++) {
+            auto it = grams_.find(gram == 2 ? bigram(last.data()) : trigram(last.data() + i));
+            if (it == grams_.end()) {
+                return {};
+            }
+            if (!postings || it->second.size() < postings->size()) {
+                postings = &it->second;
+            }
+        }
+    }
+
+    std::vector<Match> matches;
+    std::vector<double> best; // Scores of the best `limit` matches so far, lowest on top
+    examined_ = 0;
+    auto consider = [&](uint32_t id) {
+        examined_++;
+        const Entry& entry = entries_[id];
+        if (entry.removed) {
+            return;
+        }
+        size_t position = 0;
+        for (size_t w = 0; w < folded.size(); w++) {
+            bool last = w + 1 == folded.size();
+            size_t found = entry.folded.find(folded[w], last ? std::max(position, entry.nameStart) : position);
+            if (found == std::string::npos) {
+                return;
+            }
+            position = found + folded[w].size();
+        }
+        double score = frecency(entry.rank, entry.last, now);
+        matches.push_back(Match{entry.path, score});
+        if (best.size() < limit) {
+            best.push_back(score);
+            std::push_heap(best.begin(), best.end(), std::greater<double>());
+        } else if (score > best.front()) {
+            std::pop_heap(best.begin(), best.end(), std::greater<double>());
+            best.back() = score;
+            std::push_heap(best.begin(), best.end(), std::greater<double>());
+        }
+    };
+    if (postings && postings->size() <= MAX_POSTINGS_SCAN) {
+        for (uint32_t id : *postings) {
+            consider(id);
+        }
+    } else {
+        // Best first, until no directory left could outscore the matches
+        // found; ranks raised since the sort are looked at up front
+        for (uint32_t id : dirty_) {
+            consider(id);
+        }
+        for (uint32_t id : byScore_) {
+            const Entry& entry = entries_[id];
+            if (entry.dirty) {
+                continue;
+            }
+            // Frecency only falls with time, unless the clock went back
+            double bound = now >= sortedAt_ ? entry.bound : entry.rank * MAX_WEIGHT;
+            if (best.size() == limit && bound < best.front()) {
+                break;
+            }
+            consider(id);
+        }
+    }
+
+    auto better = [](const Match& a, const Match& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.path < b.path;
+    };
+    if (matches.size() > limit) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
+
+double FrecencyStore::frecency(double rank, std::time_t last, std::time_t now) {
+    std::time_t age = now - last;
+    if (age < 60 * 60) {
+        return rank * MAX_WEIGHT;
+    }
+    if (age < 24 * 60 * 60) {
+        return rank * 2;
+    }
+    if (age < 7 * 24 * 60 * 60) {
+        return rank / 2;
+    }
+    return rank / 4;
+}
+
+void FrecencyStore::apply(const std::string& path, double rank, std::time_t last) {
+    auto it = ids_.find(path);
+    if (rank <= 0) {
+        if (it != ids_.end() && !entries_[it->second].removed) {
+            Entry& entry = entries_[it->second];
+            totalRank_ -= entry.rank;
+            entry.rank = 0;
+            entry.removed = true;
+            live_--;
+        }
+        return;
+    }
+    if (it == ids_.end()) {
+        Entry entry;
+        entry.path = path;
+        entry.folded = fold(path);
+        size_t end = entry.folded.size();
+        while (end > 1 && entry.folded[end - 1] == '/') {
+            end--;
+        }
+        size_t slash = entry.folded.rfind('/', end - 1);
+        entry.nameStart = slash == std::string::npos ? 0 : slash + 1;
+        entry.removed = true;
+        uint32_t id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(std::move(entry));
+        it = ids_.emplace(path, id).first;
+        index(id);
+    }
+    Entry& entry = entries_[it->second];
+    if (entry.removed) {
+        entry.removed = false;
+        live_++;
+    }
+    if (!entry.dirty) {
+        entry.dirty = true;
+        dirty_.push_back(it->second);
+    }
+    entry.rank += rank;
+    entry.last = std::max(entry.last, last);
+    totalRank_ += rank;
+}
+
+void FrecencyStore::index(uint32_t id) {
+    const Entry& entry = entries_[id];
+    const char* name = entry.folded.data() + entry.nameStart;
+    size_t length = entry.folded.size() - entry.nameStart;
+    for (size_t i = 0; i + 2 <= length; i++) {
+        // Ids are added in order, so a repeated gram is the last one in its list
+        std::vector<uint32_t>& pairs = grams_[bigram(name + i)];
+        if (pairs.empty() || pairs.back() != id) {
+            pairs.push_back(id);
+        }
+        if (i + 3 > length) {
+            continue;
+        }
+        std::vector<uint32_t>& ids = grams_[trigram(name + i)];
+        if (ids.empty() || ids.back() != id) {
+            ids.push_back(id);
+        }
+    }
+}
+
+void FrecencyStore::rebuildIndex() {
+    ids_.clear();
+    grams_.clear();
+    live_ = 0;
+    totalRank_ = 0;
+    for (uint32_t id = 0; id < entries_.size(); id++) {
+        ids_.emplace(entries_[id].path, id);
+        index(id);
+        if (!entries_[id].removed) {
+            live_++;
+            totalRank_ += entries_[id].rank;
+        }
+    }
+    sortByScore();
+}
+
+void FrecencyStore::sortByScore() {
+    // As of the latest visit, which any query comes after
+    sortedAt_ = 0;
+    for (const auto& entry : entries_) {
+        sortedAt_ = std::max(sortedAt_, entry.last);
+    }
+    byScore_.clear();
+    byScore_.reserve(live_);
+    for (uint32_t id = 0; id < entries_.size(); id++) {
+        Entry& entry = entries_[id];
+        entry.dirty = false;
+        entry.bound = frecency(entry.rank, entry.last, sortedAt_);
+        if (!entry.removed) {
+            byScore_.push_back(id);
+        }
+    }
+    std::stable_sort(byScore_.begin(), byScore_.end(),
+                     [&](uint32_t a, uint32_t b) { return entries_[a].bound > entries_[b].bound; });
+    dirty_.clear();
+}
+
+void FrecencyStore::age(const std::string& keep) {
+    // Scale every rank down so the total drops to 90% of the cap; directories
+    // that fall below one visit are forgotten, except the one just visited
+    double factor = std::max(MAX_TOTAL_RANK, live_ * RANK_PER_ENTRY) * 0.9 / totalRank_;
+    for (auto& entry : entries_) {
+        if (entry.removed) {
+            continue;
+        }
+        totalRank_ -= entry.rank;
+        entry.rank *= factor;
+        if (entry.rank < 1 && entry.path == keep) {
+            entry.rank = 1;
+            totalRank_ += entry.rank;
+        } else if (entry.rank < 1) {
+            entry.rank = 0;
+            entry.removed = true;
+            live_--;
+        } else {
+            totalRank_ += entry.rank;
+        }
+    }
+}
+
+bool FrecencyStore::append(const std::string& line) {
+    // One write with O_APPEND, so a crash leaves at most a torn last line.
+    // Appends share the lock; only a rewrite needs it to itself.
+    int lock = lockLog(LOCK_SH);
+    if (lock < 0) {
+        return false;
+    }
+    int fd = open(logPath_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open history file for writing: " << logPath_ << std::endl;
+        close(lock);
+        return false;
+    }
+    bool written = write(fd, line.data(), line.size()) == static_cast<ssize_t>(line.size());
+    close(fd);
+    close(lock);
+    if (!written) {
+        std::cerr << "Error: Could not write history file: " << logPath_ << std::endl;
+        return false;
+    }
+    logLines_++;
+    return true;
+}
@@ -1,6 +1,7 @@
 #include "../../include/cli/CommandLineInterface.h"
 #include "../../include/fileops/FileOperations.h"
 #include "../../include/bookmark/BookMark.h"
+#include "../../include/cli/StartupTrace.h"
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -10,11 +11,27 @@
 #include <filesystem>
 
 CommandLineInterface::CommandLineInterface() {
-    // Load bookmarks from file
-    BookMark::loadBookMarks();
+    // Bookmarks and the directory history are loaded when first needed
     currentPath = fileSystem.getAbsolutePath(".");
 }
 
+void CommandLineInterface::loadBookmarks() {
+    if (!bookmarksLoaded) {
+        StartupTrace::Phase phase("load bookmarks");
+        BookMark::loadBookMarks();
+        bookmarksLoaded = true;
+    }
+}
+
+FrecencyStore& CommandLineInterface::visitedDirectories() {
+    if (!visitedStore) {
+        StartupTrace::Phase phase("load directory history");
+        visitedStore.reset(new FrecencyStore());
+        visitedStore->load();
+    }
+    return *visitedStore;
+}
+
 void CommandLineInterface::start() {
     std::cout << "CLI File Explorer\n";
     std::cout << "Type 'help' for available commands or 'exit' to quit.\n";
@@ -69,6 +86,8 @@ void CommandLineInterface::processCommand(const std::string& command) {
         listDirectory();
     } else if (tokens[0] == "cd" && tokens.size() > 1) {
         changeDirectory(tokens[1]);
+    } else if (tokens[0] == "z" || tokens[0] == "jump") {
+        jumpToDirectory(std::vector<std::string>(tokens.begin() + 1, tokens.end()));
     } else if (tokens[0] == "help") {
         showHelp();
     } else if (tokens[0] == "touch" && tokens.size() > 1) {
@@ -81,8 +100,15 @@ void CommandLineInterface::processCommand(const std::string& command) {
         renameFile(tokens[1], tokens[2]);
     } else if (tokens[0] == "cp" && tokens.size() > 2) {
         copyFile(tokens[1], tokens[2]);
+    } else if (tokens[0] == "hash") {
+        hashPaths(std::vector<std::string>(tokens.begin() + 1, tokens.end()));
+    } else if (tokens[0] == "du") {
+        showDiskUsage(tokens.size() > 1 ? tokens[1] : "");
+    } else if (tokens[0] == "dupes") {
+        findDuplicates(tokens.size() > 1 ? tokens[1] : "");
     } else if (tokens[0] == "bookmark" && tokens.size() > 1) {
         // Handle bookmark commands
+        loadBookmarks();
         if (tokens[1] == "add" && tokens.size() > 2) {
             std::string path = tokens[2];
             // If path is relative, make it absolute
@@ -110,6 +136,8 @@ void CommandLineInterface::processCommand(const std::string& command) {
             for (const auto& bookmark : BookMark::bookMarks) {
                 std::cout << "  " << bookmark << "\n";
             }
+        } else if (tokens[1] == "check" || tokens[1] == "prune") {
+            checkBookmarks(tokens[1] == "prune");
         } else if (tokens[1] == "clear") {
             if (BookMark::emptyBookMarks()) {
                 std::cout << "All bookmarks cleared.\n";
@@ -117,7 +145,7 @@ void CommandLineInterface::processCommand(const std::string& command) {
                 std::cout << "No bookmarks to clear.\n";
             }
         } else {
-            std::cout << "Invalid bookmark command. Use 'bookmark add <path>', 'bookmark remove <path>', 'bookmark list', or 'bookmark clear'.\n";
+            std::cout << "Invalid bookmark command. Use 'bookmark add <path>', 'bookmark remove <path>', 'bookmark list', 'bookmark check', 'bookmark prune', or 'bookmark clear'.\n";
         }
     } else {
         std::cout << "Unknown command: " << command << "\n";
@@ -141,6 +169,11 @@ void CommandLineInterface::listDirectory() {
               << std::setw(10) << "Type" << "\n";
     std::cout << std::string(90, '-') << "\n";
     
+    std::string dirPrefix = currentPath;
+    if (dirPrefix.back() != '/') {
+        dirPrefix += "/";
+    }
+    
     for (const auto& file : files) {
         std::string type;
         switch (file.getType()) {
@@ -164,8 +197,16 @@ void CommandLineInterface::listDirectory() {
             name = name.substr(0, 26) + "...";
         }
         
+        // Directories show their recursive size once 'du' has computed it
+        std::string sizeStr = FileOperations::formatFileSize(file.getSize());
+        DiskUsage::Usage usage;
+        if (file.getType() == FileInfo::FileType::DIRECTORY) {
+            sizeStr = (diskUsageEngine && diskUsageEngine->lookup(dirPrefix + file.getName(), usage))
+                ? FileOperations::formatFileSize(usage.apparentBytes) : "<DIR>";
+        }
+        
         std::cout << std::left << std::setw(30) << name
-                  << std::setw(12) << (file.getType() == FileInfo::FileType::DIRECTORY ? "<DIR>" : FileOperations::formatFileSize(file.getSize()))
+                  << std::setw(12) << sizeStr
                   << std::setw(20) << FileOperations::formatTime(file.getModifiedTime())
                   << std::setw(12) << FileOperations::formatPermissions(file.getPermissions())
                   << std::setw(10) << type << "\n";
@@ -173,13 +214,42 @@ void CommandLineInterface::listDirectory() {
 }
 
 void CommandLineInterface::changeDirectory(const std::string& path) {
-    std::string newPath = currentPath;
+    std::string newPath;
     
-    if (!fileSystem.changeDirectory(newPath, path)) {
+    if (!resolver.resolve(currentPath, path, newPath)) {
         std::cout << "Directory does not exist: " << path << "\n";
     } else {
         currentPath = newPath;
+        visitedDirectories().record(currentPath);
+    }
+}
+
+void CommandLineInterface::jumpToDirectory(const std::vector<std::string>& words) {
+    // Without words, show what the history holds
+    if (words.empty()) {
+        std::cout << "Most visited directories:\n";
+        for (const auto& match : visitedDirectories().query(words, 10)) {
+            std::cout << "  " << std::fixed << std::setprecision(1) << std::setw(8) << match.score << "  "
+                      << match.path << "\n";
+        }
+        return;
+    }
+    
+    // The best match other than where we are; directories that are gone are forgotten
+    for (const auto& match : visitedDirectories().query(words, 16)) {
+        if (match.path == currentPath) {
+            continue;
+        }
+        if (!fileSystem.isDirectory(match.path)) {
+            visitedDirectories().remove(match.path);
+            continue;
+        }
+        currentPath = match.path;
+        visitedDirectories().record(currentPath);
+        std::cout << currentPath << "\n";
+        return;
     }
+    std::cout << "No visited directory matches.\n";
 }
 
 void CommandLineInterface::createFile(const std::string& filename) {
@@ -216,14 +286,20 @@ void CommandLineInterface::showHelp() {
     std::cout << "Available commands:\n";
     std::cout << "  ls                - List files in current directory\n";
     std::cout << "  cd <path>         - Change directory\n";
+    std::cout << "  z <words...>      - Jump to the most frecent visited directory matching the words (also 'jump')\n";
     std::cout << "  touch <filename>  - Create a new file\n";
     std::cout << "  rm <file>         - Delete a file\n";
     std::cout << "  rmdir <directory> - Delete an empty directory\n";
     std::cout << "  mv <old> <new>    - Rename/move file or directory\n";
     std::cout << "  cp <source> <dest> - Copy file or directory\n";
+    std::cout << "  hash [--sha256] <path...> - Checksum files or whole trees\n";
+    std::cout << "  du [dir]          - Show recursive directory sizes\n";
+    std::cout << "  dupes [dir]       - Find duplicate files and show reclaimable space\n";
     std::cout << "  bookmark add <path>    - Add a bookmark\n";
     std::cout << "  bookmark remove <path> - Remove a bookmark\n";
     std::cout << "  bookmark list          - List all bookmarks\n";
+    std::cout << "  bookmark check         - Show which bookmarks no longer exist\n";
+    std::cout << "  bookmark prune         - Remove bookmarks that no longer exist\n";
     std::cout << "  bookmark clear         - Clear all bookmarks\n";
     std::cout << "  !<command>        - Execute shell command\n";
     std::cout << "  help              - Show this help message\n";
@@ -234,6 +310,9 @@ void CommandLineInterface::showHelp() {
     std::cout << "  PgUp/PgDn         - Page up/down\n";
     std::cout << "  Enter             - Open directories or view file content\n";
     std::cout << "  Ctrl+E            - Edit file with vim\n";
+    std::cout << "  s                 - Toggle sorting by name or size\n";
+    std::cout << "  D                 - Find duplicate files under the current directory\n";
+    std::cout << "  b                 - Bookmarks, with a check of which still exist\n";
     std::cout << "  q                 - Quit interactive mode\n";
 }
 
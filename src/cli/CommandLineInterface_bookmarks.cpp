@@ -0,0 +1,184 @@
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/bookmark/BookMark.h"
+#include "../../include/bookmark/BookmarkHealth.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+void CommandLineInterface::checkBookmarks(bool prune) {
+    if (BookMark::bookMarks.empty()) {
+        std::cout << "No bookmarks.\n";
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BookmarkHealth health(BookMark::bookMarks);
+    std::vector<BookmarkHealth::Result> results = health.wait();
+    auto took = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    size_t missing = 0;
+    size_t unanswered = 0;
+    for (const auto& result : results) {
+        std::cout << "  " << BookmarkHealth::statusName(result.status);
+        std::cout << std::string(10 - std::string(BookmarkHealth::statusName(result.status)).size(), ' ');
+        std::cout << result.path;
+        if (!result.error.empty()) {
+            std::cout << " (" << result.error << ")";
+        }
+        std::cout << "\n";
+        if (result.status == BookmarkHealth::Status::MISSING) {
+            missing++;
+        } else if (result.status == BookmarkHealth::Status::TIMED_OUT) {
+            unanswered++;
+        }
+    }
+    std::cout << results.size() << " bookmarks checked in " << took.count() << " ms: " << missing << " missing, "
+              << unanswered << " not answering\n";
+
+    // Only paths known to be gone are removed; a slow mount may come back
+    if (prune) {
+        for (const auto& result : results) {
+            if (result.status == BookmarkHealth::Status::MISSING) {
+                BookMark::removeBookMark(result.path);
+            }
+        }
+        std::cout << "Removed " << missing << " missing bookmarks.\n";
+    } else if (missing > 0) {
+        std::cout << "Use 'bookmark prune' to remove the missing ones.\n";
+    }
+}
+
+#ifdef USE_NCURSES
+bool CommandLineInterface::displayBookmarks(std::string& target) {
+    loadBookmarks();
+    WINDOW* bookmarksWin = newwin(LINES - 2, COLS - 2, 1, 1);
+    keypad(bookmarksWin, TRUE);
+
+    // Statuses fill in as the checks answer
+    std::unique_ptr<BookmarkHealth> health(new BookmarkHealth(BookMark::bookMarks));
+    int selected = 0;
+    int offset = 0;
+    std::string message;
+
+    while (true) {
+        // Asked first, so a check that finishes in between still gets drawn
+        bool checking = !health->done();
+        std::vector<BookmarkHealth::Result> results = health->results();
+        int maxDisplayLines = LINES - 5;
+        if (selected >= (int)results.size()) {
+            selected = std::max(0, (int)results.size() - 1);
+        }
+        if (selected >= offset + maxDisplayLines) {
+            offset = selected - maxDisplayLines + 1;
+        } else if (selected < offset) {
+            offset = selected;
+        }
+
+        werase(bookmarksWin);
+        box(bookmarksWin, 0, 0);
+        mvwprintw(bookmarksWin, 0, 2, "Bookmarks (%d)", (int)results.size());
+
+        int end = std::min(offset + maxDisplayLines, (int)results.size());
+        size_t missing = 0;
+        for (const auto& result : results) {
+            missing += result.status == BookmarkHealth::Status::MISSING;
+        }
+        for (int i = offset; i < end; i++) {
+            const auto& result = results[i];
+            std::string row = std::string(i == selected ? "> " : "  ") + BookmarkHealth::statusName(result.status);
+            row.resize(14, ' ');
+            row += result.path;
+            if (!result.error.empty()) {
+                row += " (" + result.error + ")";
+            }
+            bool bad = result.status != BookmarkHealth::Status::EXISTS && result.status != BookmarkHealth::Status::PENDING;
+            if (i == selected) {
+                wattron(bookmarksWin, A_REVERSE);
+            } else if (bad) {
+                wattron(bookmarksWin, A_DIM);
+            }
+            mvwaddnstr(bookmarksWin, i - offset + 1, 1, row.c_str(), COLS - 4);
+            wattroff(bookmarksWin, A_REVERSE | A_DIM);
+        }
+        if (results.empty()) {
+            mvwaddstr(bookmarksWin, 1, 2, "No bookmarks. Press 'a' to add the current directory.");
+        }
+
+        std::string status = checking ? "Checking..." : std::to_string(missing) + " missing";
+        if (!message.empty()) {
+            status += " | " + message;
+            message.clear();
+        }
+        status += " | Enter: Go | a: Add current | x: Remove | P: Prune missing | c: Recheck | q: Close";
+        mvwaddnstr(bookmarksWin, LINES - 3, 1, status.c_str(), COLS - 4);
+        wrefresh(bookmarksWin);
+
+        // Redraw as answers arrive
+        wtimeout(bookmarksWin, checking ? 100 : -1);
+        int ch = wgetch(bookmarksWin);
+        bool changed = false;
+        switch (ch) {
+            case KEY_UP:
+                if (selected > 0) {
+                    selected--;
+                }
+                break;
+
+            case KEY_DOWN:
+                if (selected + 1 < (int)results.size()) {
+                    selected++;
+                }
+                break;
+
+            case '\n':
+                if (selected < (int)results.size()) {
+                    target = results[selected].path;
+                    delwin(bookmarksWin);
+                    return true;
+                }
+                break;
+
+            case 'a':
+                if (BookMark::addBookMark(currentPath)) {
+                    changed = true;
+                } else {
+                    message = "Already bookmarked";
+                }
+                break;
+
+            case 'x':
+                if (selected < (int)results.size()) {
+                    BookMark::removeBookMark(results[selected].path);
+                    changed = true;
+                }
+                break;
+
+            case 'P':
+                // Only paths known to be gone; a slow mount may come back
+                for (const auto& result : results) {
+                    if (result.status == BookmarkHealth::Status::MISSING) {
+                        BookMark::removeBookMark(result.path);
+                    }
+                }
+                message = "Removed " + std::to_string(missing) + " missing";
+                changed = missing > 0;
+                break;
+
+            case 'c':
+                changed = true;
+                break;
+
+            case 'q':
+            case 'Q':
+                delwin(bookmarksWin);
+                return false;
+        }
+        if (changed) {
+            health.reset(new BookmarkHealth(BookMark::bookMarks));
+        }
+    }
+}
+#endif // USE_NCURSES
@@ -36,8 +36,10 @@ void CommandLineInterface::copyFile(const std::string& sourcePath, const std::st
         return;
     }
     
-    if (FileOperations::copyFile(fullSourcePath, fullDestinationPath)) {
+    FileOperations::CopyStats stats;
+    if (FileOperations::copyFile(fullSourcePath, fullDestinationPath, stats)) {
         std::cout << "Copied successfully: " << sourcePath << " -> " << destinationPath << "\n";
+        std::cout << "  " << FileOperations::formatCopyStats(stats) << "\n";
     } else {
         std::cout << "Failed to copy: " << sourcePath << " -> " << destinationPath << "\n";
     }
@@ -126,8 +126,16 @@ void CommandLineInterface::renameFile(const std::string& oldPath, const std::str
         return;
     }
     
-    if (FileOperations::renameFile(fullOldPath, fullNewPath)) {
+    FileOperations::CopyStats stats;
+    if (FileOperations::moveFile(fullOldPath, fullNewPath, stats)) {
         std::cout << "Renamed successfully: " << oldPath << " -> " << newPath << "\n";
+        if (stats.filesCopied > 0) {
+            // The move crossed a filesystem boundary and had to copy the data
+            std::cout << "  " << FileOperations::formatCopyStats(stats) << "\n";
+        }
+        if (stats.sourceLeftBehind) {
+            std::cout << "  Some of " << oldPath << " could not be removed; the copy at " << newPath << " is complete\n";
+        }
     } else {
         std::cout << "Failed to rename: " << oldPath << " -> " << newPath << "\n";
     }
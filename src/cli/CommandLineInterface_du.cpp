@@ -0,0 +1,76 @@
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/fileops/FileOperations.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+DiskUsage& CommandLineInterface::diskUsage() {
+    if (!diskUsageEngine) {
+        diskUsageEngine = std::make_unique<DiskUsage>();
+    }
+    return *diskUsageEngine;
+}
+
+void CommandLineInterface::showDiskUsage(const std::string& path) {
+    std::string directory = path.empty() ? currentPath : path;
+    if (directory[0] != '/') {
+        directory = currentPath + "/" + directory;
+    }
+    directory = fileSystem.getAbsolutePath(directory);
+
+    if (!fileSystem.isDirectory(directory)) {
+        std::cout << "Directory does not exist: " << path << "\n";
+        return;
+    }
+
+    std::string prefix = directory;
+    if (prefix.back() != '/') {
+        prefix += "/";
+    }
+
+    // Queue every subdirectory first so they are all scanned in parallel
+    DiskUsage& usage = diskUsage();
+    std::vector<std::string> subdirectories;
+    for (const auto& file : fileSystem.listDirectory(directory)) {
+        if (file.getType() == FileInfo::FileType::DIRECTORY) {
+            subdirectories.push_back(file.getName());
+            usage.computeAsync(prefix + file.getName());
+        }
+    }
+    std::vector<std::pair<std::string, DiskUsage::Usage>> rows;
+    for (const auto& name : subdirectories) {
+        rows.emplace_back(name, usage.compute(prefix + name));
+    }
+    // With every subdirectory cached, the total only reads this directory itself
+    DiskUsage::Usage total = usage.compute(directory);
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second.allocatedBytes > b.second.allocatedBytes;
+    });
+
+    std::cout << std::left << std::setw(30) << "Directory"
+              << std::setw(14) << "Apparent"
+              << std::setw(14) << "On disk"
+              << std::setw(10) << "Files" << "\n";
+    std::cout << std::string(68, '-') << "\n";
+    for (const auto& row : rows) {
+        std::string name = row.first;
+        if (name.length() > 29) {
+            name = name.substr(0, 26) + "...";
+        }
+        std::cout << std::left << std::setw(30) << name
+                  << std::setw(14) << FileOperations::formatFileSize(row.second.apparentBytes)
+                  << std::setw(14) << FileOperations::formatFileSize(row.second.allocatedBytes)
+                  << std::setw(10) << row.second.files << "\n";
+    }
+    std::cout << std::string(68, '-') << "\n";
+    std::cout << std::left << std::setw(30) << "Total (hardlinks once)"
+              << std::setw(14) << FileOperations::formatFileSize(total.apparentBytes)
+              << std::setw(14) << FileOperations::formatFileSize(total.allocatedBytes)
+              << std::setw(10) << total.files << "\n";
+    if (total.errors > 0) {
+        std::cout << total.errors << " entries could not be read\n";
+    }
+}
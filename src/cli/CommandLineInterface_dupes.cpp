@@ -0,0 +1,112 @@
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/dupes/DuplicateFinder.h"
+#include "../../include/fileops/FileOperations.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void CommandLineInterface::findDuplicates(const std::string& path) {
+    std::string directory = path.empty() ? currentPath : path;
+    if (directory[0] != '/') {
+        directory = currentPath + "/" + directory;
+    }
+
+    if (!fileSystem.isDirectory(directory)) {
+        std::cout << "Directory does not exist: " << path << "\n";
+        return;
+    }
+
+    std::cout << "Scanning " << directory << " for duplicates...\n";
+    DuplicateFinder::Report report = DuplicateFinder::findDuplicates(directory);
+
+    for (const auto& group : report.groups) {
+        std::cout << FileOperations::formatFileSize(group.size) << " x " << group.paths.size() << ":\n";
+        for (const auto& file : group.paths) {
+            std::cout << "  " << file << "\n";
+        }
+    }
+
+    std::cout << report.groups.size() << " duplicate groups in " << report.filesScanned << " files ("
+              << report.hardlinksSkipped << " hardlinks skipped, " << report.filesFullyHashed << " fully hashed)\n";
+    std::cout << "Reclaimable: " << FileOperations::formatFileSize(report.reclaimableBytes) << "\n";
+}
+
+#ifdef USE_NCURSES
+void CommandLineInterface::displayDuplicates(const std::string& directory) {
+    WINDOW* dupesWin = newwin(LINES - 2, COLS - 2, 1, 1);
+    keypad(dupesWin, TRUE);
+    box(dupesWin, 0, 0);
+    mvwprintw(dupesWin, 1, 2, "Scanning %s for duplicates...", directory.c_str());
+    wrefresh(dupesWin);
+
+    DuplicateFinder::Report report = DuplicateFinder::findDuplicates(directory);
+
+    // Flatten the groups into display rows
+    std::vector<std::string> rows;
+    for (const auto& group : report.groups) {
+        rows.push_back(FileOperations::formatFileSize(group.size) + " x " + std::to_string(group.paths.size()));
+        for (const auto& file : group.paths) {
+            rows.push_back("    " + file);
+        }
+    }
+    if (rows.empty()) {
+        rows.push_back("No duplicate files found.");
+    }
+
+    int offset = 0;
+    while (true) {
+        int maxDisplayLines = LINES - 5;
+        werase(dupesWin);
+        box(dupesWin, 0, 0);
+        mvwprintw(dupesWin, 0, 2, "Duplicates: %s (%d groups, %s reclaimable)", directory.c_str(),
+                  (int)report.groups.size(), FileOperations::formatFileSize(report.reclaimableBytes).c_str());
+
+        int end = std::min(offset + maxDisplayLines, (int)rows.size());
+        for (int i = offset; i < end; i++) {
+            bool header = rows[i].compare(0, 4, "    ") != 0;
+            if (header) {
+                wattron(dupesWin, A_BOLD);
+            }
+            mvwaddnstr(dupesWin, i - offset + 1, 1, rows[i].c_str(), COLS - 4);
+            if (header) {
+                wattroff(dupesWin, A_BOLD);
+            }
+        }
+
+        mvwprintw(dupesWin, LINES - 3, 1, "%d files scanned, %d hardlinks skipped | ↑/↓: Scroll | q: Close",
+                  (int)report.filesScanned, (int)report.hardlinksSkipped);
+        wrefresh(dupesWin);
+
+        int ch = wgetch(dupesWin);
+        switch (ch) {
+            case KEY_UP:
+                if (offset > 0) {
+                    offset--;
+                }
+                break;
+
+            case KEY_DOWN:
+                if (offset + maxDisplayLines < (int)rows.size()) {
+                    offset++;
+                }
+                break;
+
+            case KEY_PPAGE:
+                offset = std::max(0, offset - maxDisplayLines);
+                break;
+
+            case KEY_NPAGE:
+                if (offset + maxDisplayLines < (int)rows.size()) {
+                    offset = std::min(offset + maxDisplayLines, (int)rows.size() - maxDisplayLines);
+                }
+                break;
+
+            case 'q':
+            case 'Q':
+                delwin(dupesWin);
+                return;
+        }
+    }
+}
+#endif // USE_NCURSES
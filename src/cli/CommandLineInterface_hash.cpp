@@ -0,0 +1,54 @@
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/hash/Checksum.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+bool CommandLineInterface::hashPaths(const std::vector<std::string>& args) {
+    Checksum::Algorithm algorithm = Checksum::Algorithm::FAST;
+    std::vector<std::string> paths;
+    for (const auto& arg : args) {
+        if (arg == "--sha256") {
+            algorithm = Checksum::Algorithm::SHA256;
+        } else if (arg == "--fast") {
+            algorithm = Checksum::Algorithm::FAST;
+        } else {
+            paths.push_back(arg[0] == '/' ? arg : currentPath + "/" + arg);
+        }
+    }
+
+    if (paths.empty()) {
+        std::cout << "Usage: hash [--sha256] <path...>\n";
+        return false;
+    }
+
+    std::vector<Checksum::Result> results = Checksum::hashPaths(paths, algorithm);
+    bool success = true;
+    for (const auto& result : results) {
+        if (result.error.empty()) {
+            std::cout << result.digest << "  " << result.path << "\n";
+        } else {
+            std::cerr << "hash: " << result.path << ": " << result.error << "\n";
+            success = false;
+        }
+    }
+
+    // One line per directory argument summarising the whole tree; a tree
+    // with unreadable files has no digest, as it would not verify anything
+    for (const auto& path : paths) {
+        if (fileSystem.isDirectory(path)) {
+            std::string root = path;
+            while (!root.empty() && root.back() == '/') {
+                root.pop_back();
+            }
+            std::string digest = Checksum::combineTree(path, results, algorithm);
+            if (digest.empty()) {
+                std::cerr << "hash: " << root << "/: no tree digest, some files could not be read\n";
+                success = false;
+            } else {
+                std::cout << digest << "  " << root << "/ (tree)\n";
+            }
+        }
+    }
+    return success;
+}
@@ -0,0 +1,192 @@
+#ifdef USE_NCURSES
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/viewer/ContentSearch.h"
+#include "../../include/viewer/HexFormat.h"
+#include "../../include/viewer/MappedFile.h"
+#include <ncurses.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+void CommandLineInterface::displayHexContent(const std::string& filePath, const MappedFile& file) {
+    WINDOW* hexWin = newwin(LINES - 2, COLS - 2, 1, 1);
+    keypad(hexWin, TRUE);
+
+    const char* data = file.data();
+    uint64_t size = file.size();
+
+    // Offset of the first byte on screen; always at the start of a row
+    uint64_t topOffset = 0;
+
+    // Last search, highlighted while it is on screen
+    std::vector<uint8_t> pattern;
+    bool hasMatch = false;
+    uint64_t matchOffset = 0;
+    std::string message;
+
+    // Search runs on a worker, as in the text view; the loop polls it
+    ContentSearch search(file);
+    bool searchPending = false;
+
+    int ch;
+    while (true) {
+        int bytesPerRow = HexFormat::bytesPerRow(COLS - 4);
+        int maxRows = LINES - 4;
+        uint64_t pageBytes = static_cast<uint64_t>(bytesPerRow) * maxRows;
+
+        // Last top offset that still fills the screen
+        uint64_t lastRow = size > 0 ? (size - 1) / bytesPerRow * bytesPerRow : 0;
+        uint64_t endTop = lastRow > pageBytes - bytesPerRow ? lastRow - (pageBytes - bytesPerRow) : 0;
+        topOffset -= topOffset % bytesPerRow; // Rows move after a resize
+
+        // Pick up a finished search and bring the hit on screen, at the top
+        // unless it is already visible
+        if (searchPending && search.state() != ContentSearch::State::RUNNING) {
+            searchPending = false;
+            if (search.state() == ContentSearch::State::FOUND) {
+                if (search.wrapped()) {
+                    message = "Search wrapped to the start";
+                }
+                hasMatch = true;
+                matchOffset = search.result();
+                if (matchOffset < topOffset || matchOffset >= topOffset + pageBytes) {
+                    topOffset = std::min(matchOffset - matchOffset % bytesPerRow, endTop);
+                }
+            } else if (search.state() == ContentSearch::State::NOT_FOUND) {
+                hasMatch = false;
+                message = "Pattern not found";
+            } else {
+                message = "Search cancelled";
+            }
+        }
+
+        werase(hexWin);
+        box(hexWin, 0, 0);
+
+        // Columns of byte i within a row: hex digits and the ASCII dump
+        int asciiStart = 12 + bytesPerRow * 3 + bytesPerRow / 8 - 1 + 2;
+        for (int row = 0; row < maxRows; row++) {
+            uint64_t offset = topOffset + static_cast<uint64_t>(row) * bytesPerRow;
+            if (offset >= size) {
+                break;
+            }
+            std::string text = HexFormat::formatRow(data, size, offset, bytesPerRow);
+            mvwaddnstr(hexWin, row + 1, 1, text.c_str(), COLS - 4);
+
+            if (hasMatch && matchOffset < offset + bytesPerRow && matchOffset + pattern.size() > offset) {
+                for (int i = 0; i < bytesPerRow; i++) {
+                    uint64_t byte = offset + i;
+                    if (byte >= matchOffset && byte < matchOffset + pattern.size()) {
+                        mvwchgat(hexWin, row + 1, 1 + 12 + i * 3 + i / 8, 2, A_REVERSE, 0, nullptr);
+                        mvwchgat(hexWin, row + 1, 1 + asciiStart + i, 1, A_REVERSE, 0, nullptr);
+                    }
+                }
+            }
+        }
+
+        mvwprintw(hexWin, 0, 2, "File: %s (%llu bytes, hex)", filePath.c_str(), (unsigned long long)size);
+        mvwprintw(hexWin, LINES - 3, 1, "Offset 0x%llx of 0x%llx (%d%%)", (unsigned long long)topOffset,
+                  (unsigned long long)size, size > 0 ? (int)(topOffset * 100 / size) : 100);
+        if (searchPending) {
+            wprintw(hexWin, " | Searching %d%% (any key cancels)", (int)(search.progress() * 100));
+        } else if (!message.empty()) {
+            wprintw(hexWin, " | %s", message.c_str());
+            message.clear();
+        }
+        mvwprintw(hexWin, LINES - 3, COLS - 55, "↑/↓: Navigate | :Offset | /: Search n: Next | q: Close");
+
+        wrefresh(hexWin);
+
+        auto startSearch = [&](uint64_t from) {
+            search.start(std::string(pattern.begin(), pattern.end()), from, true);
+            searchPending = true;
+        };
+
+        // Redraw while a search runs so its progress shows
+        wtimeout(hexWin, searchPending ? 100 : -1);
+        ch = wgetch(hexWin);
+        if (ch == ERR) {
+            continue;
+        }
+        // A key press abandons a search that is still scanning
+        if (searchPending && ch != KEY_RESIZE) {
+            search.cancel();
+            continue;
+        }
+        switch (ch) {
+            case KEY_RESIZE:
+                wresize(hexWin, LINES - 2, COLS - 2);
+                break;
+
+            case KEY_UP:
+                if (topOffset >= static_cast<uint64_t>(bytesPerRow)) {
+                    topOffset -= bytesPerRow;
+                }
+                break;
+
+            case KEY_DOWN:
+                if (topOffset < endTop) {
+                    topOffset += bytesPerRow;
+                }
+                break;
+
+            case KEY_PPAGE: // Page Up
+                topOffset = topOffset > pageBytes ? topOffset - pageBytes : 0;
+                break;
+
+            case KEY_NPAGE: // Page Down
+                topOffset = std::min(topOffset + pageBytes, endTop);
+                break;
+
+            case 'g':
+                topOffset = 0;
+                break;
+
+            case 'G':
+                topOffset = endTop;
+                break;
+
+            case ':': {
+                // Decimal, 0x-prefixed hex, or a percentage of the file
+                std::string input = promptInput(hexWin, LINES - 3, "Offset: ");
+                uint64_t offset = 0;
+                if (input.empty()) {
+                    break;
+                }
+                if (!HexFormat::parseOffset(input, size, offset)) {
+                    message = "Invalid offset";
+                } else {
+                    offset = std::min(offset, size > 0 ? size - 1 : 0);
+                    topOffset = std::min(offset - offset % bytesPerRow, endTop);
+                }
+                break;
+            }
+
+            case '/': {
+                std::string input = promptInput(hexWin, LINES - 3, "Search (hex bytes or \"text\"): ");
+                if (input.empty()) {
+                    break;
+                }
+                if (!HexFormat::parsePattern(input, pattern)) {
+                    message = "Invalid pattern";
+                    break;
+                }
+                hasMatch = false;
+                startSearch(topOffset);
+                break;
+            }
+
+            case 'n':
+                if (!pattern.empty()) {
+                    startSearch(hasMatch ? matchOffset + 1 : topOffset);
+                }
+                break;
+
+            case 'q':
+            case 'Q':
+                delwin(hexWin);
+                return;
+        }
+    }
+}
+#endif // USE_NCURSES
@@ -1,7 +1,15 @@
 #ifdef USE_NCURSES
 #include "../../include/cli/CommandLineInterface.h"
+#include "../../include/cli/FrameRenderer.h"
 #include "../../include/fileops/FileOperations.h"
+#include "../../include/du/DiskUsage.h"
+#include "../../include/listing/DirectoryLoader.h"
+#include "../../include/listing/FuzzyFilter.h"
+#include "../../include/listing/ListingPrefetcher.h"
+#include "../../include/listing/SnapshotCache.h"
+#include "../../include/viewer/Previewer.h"
 #include <ncurses.h>
+#include <chrono>
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -9,6 +17,39 @@
 #include <dirent.h>
 #include <cstring>
 
+namespace {
+
+// How long to wait for a listing before drawing the "loading" frame
+const int LOAD_WAIT_MS = 50;
+
+// How often to look for a finished preview
+const int PREVIEW_POLL_MS = 50;
+
+// Widest the listing gets next to the preview pane
+const int PREVIEW_LIST_WIDTH = 48;
+
+// Shortest time between frames (about 60 fps)
+const std::chrono::milliseconds FRAME_INTERVAL(16);
+
+// Whether a key arrives within the given time; it is left to be read
+bool inputWithin(std::chrono::milliseconds wait) {
+    timeout(std::max(0, (int)wait.count()));
+    int next = getch();
+    if (next == ERR) {
+        return false;
+    }
+    ungetch(next);
+    return true;
+}
+
+// The next key if one is already waiting, otherwise ERR
+int queuedKey() {
+    timeout(0);
+    return getch();
+}
+
+} // namespace
+
 void CommandLineInterface::interactiveListDirectory() {
     // Initialize ncurses
     initscr();
@@ -16,110 +57,232 @@ void CommandLineInterface::interactiveListDirectory() {
     noecho();
     keypad(stdscr, TRUE);
     curs_set(0); // Hide cursor
+    set_escdelay(25); // Esc leaves the filter without a noticeable pause
     
     int selected = 0;
     int offset = 0;
     int maxRows = LINES - 3; // Leave space for header and footer
     
-    while (true) {
-        // Clear screen
-        clear();
-        
-        // Get directory contents
-        auto files = fileSystem.listDirectory(currentPath);
+    std::vector<FileInfo> files;
+    bool reload = true;
+    bool sortBySize = false;
+    uint64_t sizesGeneration = 0;
+    std::string sizedPath; // Directory the queued size jobs belong to
+    DiskUsage& usage = diskUsage();
+    
+    // F12 replaces the title with timings of the last frame, listing and
+    // sort, to tell a slow filesystem from a slow sort or terminal
+    bool showStats = false;
+    std::chrono::microseconds frameTime(0);
+    std::chrono::microseconds terminalTime(0);
+    std::chrono::microseconds sortTime(0);
+    std::chrono::milliseconds listTime(0);
+    size_t statCount = 0;    // One stat per entry of the last listing
+    size_t listingBytes = 0; // Memory held by its snapshot
+    
+    // Full path of an entry in the current directory
+    auto childPath = [this](const std::string& name) {
+        std::string path = currentPath;
+#ifdef _WIN32
+        if (path.back() != '\\' && path.back() != '/') {
+            path += "\\";
+        }
+#else
+        if (path.back() != '/') {
+            path += "/";
+        }
+#endif
+        return path + name;
+    };
+    
+    // Recursive size of a directory entry, or false while it is still being computed
+    auto directorySize = [&](const FileInfo& file, uint64_t& size) {
+        DiskUsage::Usage result;
+        if (file.getName() == ".." || !usage.lookup(childPath(file.getName()), result)) {
+            return false;
+        }
+        size = result.apparentBytes;
+        return true;
+    };
+    
+    auto sortListing = [&]() {
+        auto sortStart = std::chrono::steady_clock::now();
+        // Keep ".." pinned to the top
+        auto begin = files.begin();
+        if (!files.empty() && files.front().getName() == "..") {
+            ++begin;
+        }
+        std::string selectedName = selected < (int)files.size() ? files[selected].getName() : "";
         
-        // Sort files alphabetically
-        std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) {
-            // Directories first, then files
-            if (a.getType() == FileInfo::FileType::DIRECTORY && b.getType() != FileInfo::FileType::DIRECTORY) {
-                return true;
+        if (sortBySize) {
+            std::vector<std::pair<uint64_t, FileInfo>> keyed;
+            keyed.reserve(files.end() - begin);
+            for (auto it = begin; it != files.end(); ++it) {
+                uint64_t size = it->getSize();
+                if (it->getType() == FileInfo::FileType::DIRECTORY && !directorySize(*it, size)) {
+                    size = 0; // Unknown sizes sink until their result arrives
+                }
+                keyed.emplace_back(size, *it);
             }
-            if (a.getType() != FileInfo::FileType::DIRECTORY && b.getType() == FileInfo::FileType::DIRECTORY) {
-                return false;
+            std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+                if (a.first != b.first) {
+                    return a.first > b.first;
+                }
+                return a.second.getName() < b.second.getName();
+            });
+            auto out = begin;
+            for (auto& entry : keyed) {
+                *out++ = std::move(entry.second);
             }
-            return a.getName() < b.getName();
-        });
-        
-        // Add parent directory entry if not at root
-        if (currentPath != "/" && currentPath != ".") {
-            std::vector<FileInfo> filesWithParent;
-            filesWithParent.emplace_back("..", FileInfo::FileType::DIRECTORY, 0, 
-                                         std::chrono::system_clock::time_point(), 0);
-            filesWithParent.insert(filesWithParent.end(), files.begin(), files.end());
-            files = std::move(filesWithParent);
+        } else {
+            std::sort(begin, files.end(), [](const FileInfo& a, const FileInfo& b) {
+                // Directories first, then files
+                if (a.getType() == FileInfo::FileType::DIRECTORY && b.getType() != FileInfo::FileType::DIRECTORY) {
+                    return true;
+                }
+                if (a.getType() != FileInfo::FileType::DIRECTORY && b.getType() == FileInfo::FileType::DIRECTORY) {
+                    return false;
+                }
+                return a.getName() < b.getName();
+            });
         }
         
-        // Calculate display bounds
-        maxRows = LINES - 5; // Adjust for header and footer lines
-        if (selected >= offset + maxRows) {
-            offset = selected - maxRows + 1;
-        } else if (selected < offset) {
-            offset = selected;
+        // Keep the cursor on the same entry after re-sorting
+        for (size_t i = 0; i < files.size(); i++) {
+            if (files[i].getName() == selectedName) {
+                selected = static_cast<int>(i);
+                break;
+            }
         }
+        sortTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sortStart);
+    };
+    
+    // Only rows that changed since the last frame are sent to the terminal
+    FrameRenderer renderer;
+    
+    // Listings are read on a worker so a slow mount never blocks input
+    DirectoryLoader loader;
+    std::string loadError;
+    
+    // Listings seen recently or prefetched while the cursor rested on a
+    // directory; shown at once on entry and then reloaded
+    SnapshotCache snapshots;
+    ListingPrefetcher prefetcher(snapshots);
+    bool showingSnapshot = false;
+    
+    // '/' narrows the listing to fuzzy matches of what is typed next. The
+    // view is a list of indices into files, best matches first.
+    FuzzyFilter filter;
+    bool filtering = false;
+    bool filterStale = true; // files changed since the filter was built
+    auto shownCount = [&]() {
+        return filtering ? (int)filter.matches().size() : (int)files.size();
+    };
+    auto entryAt = [&](int i) -> const FileInfo& {
+        return filtering ? files[filter.matches()[i]] : files[i];
+    };
+    auto applyFilter = [&](const std::string& query) {
+        if (filterStale) {
+            filter.clear();
+            for (const auto& file : files) {
+                filter.add(file.getName());
+            }
+            filterStale = false;
+        }
+        filter.setQuery(query);
+        selected = 0;
+        offset = 0;
+    };
+    
+    // While sorting by size, size every subdirectory in the background;
+    // otherwise they are sized as they come into view. The total of the
+    // current directory waits for them, as it reuses their results.
+    auto queueSizes = [&]() {
+        bool subdirectoriesDone = true;
+        DiskUsage::Usage result;
+        for (const auto& file : files) {
+            if (file.getType() == FileInfo::FileType::DIRECTORY && file.getName() != ".." &&
+                !usage.lookup(childPath(file.getName()), result)) {
+                if (sortBySize) {
+                    usage.computeAsync(childPath(file.getName()));
+                }
+                subdirectoriesDone = false;
+            }
+        }
+        if (subdirectoriesDone) {
+            usage.computeAsync(currentPath);
+        }
+    };
+    
+    // 'p' splits the screen: the right pane previews the entry under the
+    // cursor. Previews are made in the background and cached, so moving
+    // the cursor never waits for them.
+    Previewer previewer;
+    bool previewing = false;
+    
+    // Replace everything after ".." with a listing of the current directory
+    auto showListing = [&](const std::vector<FileInfo>& entries) {
+        auto begin = files.begin();
+        if (!files.empty() && files.front().getName() == "..") {
+            ++begin;
+        }
+        files.erase(begin, files.end());
+        files.insert(files.end(), entries.begin(), entries.end());
         
-        // Display header
-        printw("CLI File Explorer - Interactive Mode\n");
-        printw("Current path: %s\n", currentPath.c_str());
-        printw("%-30s %-12s %-20s %-12s %-10s\n", "Name", "Size", "Modified", "Permissions", "Type");
-        printw("%s\n", std::string(90, '-').c_str());
-        
-        // Display files
-        int end = std::min(offset + maxRows, (int)files.size());
-        for (int i = offset; i < end; i++) {
-            const auto& file = files[i];
-            std::string type;
-            switch (file.getType()) {
-                case FileInfo::FileType::DIRECTORY:
-                    type = "[DIR]";
-                    break;
-                case FileInfo::FileType::FILE:
-                    type = "[FILE]";
-                    break;
-                case FileInfo::FileType::SYMLINK:
-                    type = "[LINK]";
-                    break;
-                default:
-                    type = "[UNK]";
-                    break;
+        // Sizes cached on an earlier visit are dropped if the directories changed since
+        usage.revalidate(currentPath);
+        for (const auto& file : entries) {
+            if (file.getType() == FileInfo::FileType::DIRECTORY) {
+                usage.revalidate(childPath(file.getName()));
             }
-            
-            std::string name = file.getName();
-            // Truncate long names
-            if (name.length() > 29) {
-                name = name.substr(0, 26) + "...";
+        }
+        queueSizes();
+        sortListing();
+        sizesGeneration = usage.generation();
+        filterStale = true;
+        if (filtering) {
+            applyFilter(filter.query());
+        }
+        if (selected >= shownCount()) {
+            selected = std::max(0, shownCount() - 1);
+        }
+    };
+    
+    // Keys that arrive faster than frames can be drawn (a held arrow key)
+    // are applied together before the next frame, and frames are at least
+    // FRAME_INTERVAL apart, so the view never falls behind the keyboard
+    auto lastFrame = std::chrono::steady_clock::now() - FRAME_INTERVAL;
+    bool loadingShown = false; // A frame has been drawn since the listing was requested
+    
+    // Apply one key; false once the user quits
+    auto handleKey = [&](int ch) {
+        // While filtering, typing edits the query instead of running commands
+        if (filtering) {
+            if (ch == 27) { // Esc: back to the full listing, on the same entry
+                selected = selected < shownCount() ? (int)filter.matches()[selected] : 0;
+                filtering = false;
+                return true;
             }
-            
-            std::string sizeStr = (file.getType() == FileInfo::FileType::DIRECTORY) ? 
-                                  "<DIR>" : FileOperations::formatFileSize(file.getSize());
-            
-            if (i == selected) {
-                attron(A_REVERSE);
-                printw("> %-30s %-12s %-20s %-12s %-10s\n", 
-                       name.c_str(), 
-                       sizeStr.c_str(),
-                       FileOperations::formatTime(file.getModifiedTime()).c_str(),
-                       FileOperations::formatPermissions(file.getPermissions()).c_str(),
-                       type.c_str());
-                attroff(A_REVERSE);
-            } else {
-                printw("  %-30s %-12s %-20s %-12s %-10s\n", 
-                       name.c_str(), 
-                       sizeStr.c_str(),
-                       FileOperations::formatTime(file.getModifiedTime()).c_str(),
-                       FileOperations::formatPermissions(file.getPermissions()).c_str(),
-                       type.c_str());
+            if (ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+                std::string query = filter.query();
+                if (!query.empty()) {
+                    query.pop_back();
+                    applyFilter(query);
+                }
+                return true;
+            }
+            if (ch >= 32 && ch < 127) {
+                applyFilter(filter.query() + static_cast<char>(ch));
+                return true;
             }
+        } else if (ch == '/') {
+            filtering = true;
+            applyFilter("");
+            return true;
         }
         
-        // Display footer
-        printw("%s\n", std::string(90, '-').c_str());
-        printw("↑/↓: Navigate | Enter: Open | Ctrl+E: Edit | n: New | d: Delete | r: Rename | q: Quit\n");
-        
-        // Refresh screen
-        refresh();
-        
-        // Get user input
-        int ch = getch();
+        // Entries can be missing while a listing is still loading
+        bool hasSelection = selected < shownCount();
         
         switch (ch) {
             case KEY_UP:
@@ -129,20 +292,21 @@ void CommandLineInterface::interactiveListDirectory() {
                 break;
                 
             case KEY_DOWN:
-                if (selected < (int)files.size() - 1) {
+                if (selected < shownCount() - 1) {
                     selected++;
                 }
                 break;
                 
             case '\n': // Enter key
-                {
-                    const auto& selectedFile = files[selected];
+                if (hasSelection) {
+                    const auto& selectedFile = entryAt(selected);
                     if (selectedFile.getType() == FileInfo::FileType::DIRECTORY) {
                         if (selectedFile.getName() == "..") {
                             // Go to parent directory
                             currentPath = fileSystem.getParentDirectory(currentPath);
                             selected = 0;
                             offset = 0;
+                            reload = true;
                         } else {
                             // Enter subdirectory
                             std::string newPath = currentPath;
@@ -156,11 +320,12 @@ void CommandLineInterface::interactiveListDirectory() {
                             }
 #endif
                             newPath += selectedFile.getName();
-                            if (fileSystem.isDirectory(newPath)) {
-                                currentPath = newPath;
-                                selected = 0;
-                                offset = 0;
-                            }
+                            // The listing already says it is a directory; checking
+                            // again here would block on a hung mount
+                            currentPath = newPath;
+                            selected = 0;
+                            offset = 0;
+                            reload = true;
                         }
                     } else if (selectedFile.getType() == FileInfo::FileType::FILE) {
                         // Display file content
@@ -180,13 +345,14 @@ void CommandLineInterface::interactiveListDirectory() {
                         // After viewing file, refresh the directory listing
                         clear();
                         refresh();
+                        renderer.invalidate();
                     }
                 }
                 break;
                 
             case 5: // Ctrl+E
-                {
-                    const auto& selectedFile = files[selected];
+                if (hasSelection) {
+                    const auto& selectedFile = entryAt(selected);
                     if (selectedFile.getType() == FileInfo::FileType::FILE) {
                         // Edit file with vim
                         std::string filePath = currentPath;
@@ -201,10 +367,14 @@ void CommandLineInterface::interactiveListDirectory() {
 #endif
                         filePath += selectedFile.getName();
                         editFileWithVim(filePath);
+                        usage.invalidate(currentPath);
+                        snapshots.invalidate(currentPath);
+                        reload = true;
                         
                         // After editing file, refresh the directory listing
                         clear();
                         refresh();
+                        renderer.invalidate();
                     }
                 }
                 break;
@@ -235,6 +405,8 @@ void CommandLineInterface::interactiveListDirectory() {
                     
                     // Create the file
                     if (FileOperations::createFile(filePath)) {
+                        usage.invalidate(currentPath);
+                        snapshots.invalidate(currentPath);
                         std::cout << "File created successfully: " << filePath << std::endl;
                     } else {
                         std::cout << "Failed to create file: " << filePath << std::endl;
@@ -251,15 +423,17 @@ void CommandLineInterface::interactiveListDirectory() {
                     curs_set(0); // Hide cursor
                     
                     // Refresh the directory listing
+                    reload = true;
                     clear();
                     refresh();
+                    renderer.invalidate();
                 }
                 break;
                 
             case 'd':
-                {
+                if (hasSelection) {
                     // Delete file or directory
-                    const auto& selectedFile = files[selected];
+                    const auto& selectedFile = entryAt(selected);
                     std::string itemPath = currentPath;
 #ifdef _WIN32
                     if (itemPath.back() != '\\' && itemPath.back() != '/') {
@@ -308,6 +482,8 @@ void CommandLineInterface::interactiveListDirectory() {
                         }
                         
                         if (success) {
+                            usage.invalidate(itemPath);
+                            snapshots.invalidate(itemPath);
                             std::cout << "Deleted successfully: " << selectedFile.getName() << std::endl;
                         } else {
                             std::cout << "Failed to delete: " << selectedFile.getName() << std::endl;
@@ -327,15 +503,17 @@ void CommandLineInterface::interactiveListDirectory() {
                     curs_set(0); // Hide cursor
                     
                     // Refresh the directory listing
+                    reload = true;
                     clear();
                     refresh();
+                    renderer.invalidate();
                 }
                 break;
                 
             case 'r':
-                {
+                if (hasSelection) {
                     // Rename file or directory
-                    const auto& selectedFile = files[selected];
+                    const auto& selectedFile = entryAt(selected);
                     std::string oldPath = currentPath;
 #ifdef _WIN32
                     if (oldPath.back() != '\\' && oldPath.back() != '/') {
@@ -368,8 +546,15 @@ void CommandLineInterface::interactiveListDirectory() {
 #endif
                         newPath += newName;
                         
-                        if (FileOperations::renameFile(oldPath, newPath)) {
+                        FileOperations::CopyStats stats;
+                        if (FileOperations::moveFile(oldPath, newPath, stats)) {
+                            usage.invalidate(oldPath);
+                            usage.invalidate(newPath);
+                            snapshots.invalidate(oldPath);
                             std::cout << "Renamed successfully: " << selectedFile.getName() << " -> " << newName << std::endl;
+                            if (stats.sourceLeftBehind) {
+                                std::cout << "Some of the original could not be removed; the copy is complete" << std::endl;
+                            }
                         } else {
                             std::cout << "Failed to rename: " << selectedFile.getName() << " -> " << newName << std::endl;
                         }
@@ -388,183 +573,323 @@ void CommandLineInterface::interactiveListDirectory() {
                     curs_set(0); // Hide cursor
                     
                     // Refresh the directory listing
+                    reload = true;
                     clear();
                     refresh();
+                    renderer.invalidate();
                 }
                 break;
 
+            case 's':
+                // Toggle between name and recursive size ordering; by name,
+                // only the directories on screen are sized
+                sortBySize = !sortBySize;
+                if (sortBySize) {
+                    queueSizes();
+                } else {
+                    usage.cancelPending();
+                }
+                sortListing();
+                break;
+                
+            case 'p':
+                previewing = !previewing;
+                break;
+                
+            case 'b': {
+                // Bookmarks, with a check of which still exist; Enter goes to one
+                std::string target;
+                if (displayBookmarks(target)) {
+                    currentPath = target;
+                    selected = 0;
+                    offset = 0;
+                    reload = true;
+                }
+                clear();
+                refresh();
+                renderer.invalidate();
+                break;
+            }
+                
+            case KEY_F(12):
+                showStats = !showStats;
+                break;
+                
+            case 'D':
+                // Duplicate finder for the current directory
+                displayDuplicates(currentPath);
+                clear();
+                refresh();
+                renderer.invalidate();
+                break;
+
             case 'q':
             case 'Q':
                 // Exit interactive mode
                 endwin();
-                return;
+                return false;
         }
-    }
-    
-    // Clean up ncurses
-    endwin();
-}
-
-void CommandLineInterface::displayFileContent(const std::string& filePath) {
-    // Create a new window for file content
-    WINDOW* fileWin = newwin(LINES - 2, COLS - 2, 1, 1);
-    box(fileWin, 0, 0);
-    wrefresh(fileWin);
-    
-    // Read file content
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        mvwprintw(fileWin, 1, 1, "Cannot open file: %s", filePath.c_str());
-        wrefresh(fileWin);
-        getch();
-        delwin(fileWin);
-        return;
-    }
-    
-    // Display file content with scrolling
-    int offset = 0;
-    std::vector<std::string> lines;
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        lines.push_back(line);
-    }
-    
-    file.close();
-    
-    // Initialize color if possible
-    bool hasColor = has_colors();
-    if (hasColor) {
-        start_color();
-        init_pair(1, COLOR_YELLOW, COLOR_BLACK); // Line numbers
-        init_pair(2, COLOR_WHITE, COLOR_BLACK);  // Content
-    }
-    
-    // Process lines for wrapping
-    struct WrappedLine {
-        int originalLineNum; // 0-based index in original lines vector
-        std::string content;
+        return true;
     };
     
-    std::vector<WrappedLine> wrappedLines;
-    int contentStart = 9; // Position after line number
-    int availableWidth = COLS - contentStart - 2;
-    
-    for (size_t i = 0; i < lines.size(); i++) {
-        const std::string& originalLine = lines[i];
+    while (true) {
+        if (reload) {
+            // Sizes of a directory that was left are no longer wanted
+            if (currentPath != sizedPath) {
+                usage.cancelPending();
+                sizedPath = currentPath;
+            }
+            // Until the listing arrives only ".." is offered, so a slow or
+            // hung directory can always be backed out of
+            filtering = false;
+            filterStale = true;
+            files.clear();
+            if (currentPath != "/" && currentPath != ".") {
+                files.insert(files.begin(), FileInfo("..", FileInfo::FileType::DIRECTORY, 0,
+                                                     std::chrono::system_clock::time_point(), 0));
+            }
+            loadError.clear();
+            std::vector<FileInfo> snapshot;
+            showingSnapshot = snapshots.get(currentPath, snapshot);
+            if (showingSnapshot) {
+                showListing(snapshot);
+            }
+            loader.request(currentPath);
+            loadingShown = false;
+            reload = false;
+        }
         
-        // Handle empty lines
-        if (originalLine.empty()) {
-            wrappedLines.push_back({static_cast<int>(i), ""});
-            continue;
+        // Ordinary directories arrive before the first frame; slow ones show a
+        // spinner, after which keys are never held up waiting for the listing
+        DirectoryLoader::Result listing;
+        bool waitForListing = !showingSnapshot && !loadingShown;
+        if (loader.poll(listing, std::chrono::milliseconds(waitForListing ? LOAD_WAIT_MS : 0))) {
+            if (listing.state == DirectoryLoader::State::DONE) {
+                listTime = loader.elapsed();
+                statCount = listing.entries.size();
+                listingBytes = SnapshotCache::footprint(listing.entries);
+                snapshots.put(currentPath, listing.entries);
+                showListing(listing.entries);
+                showingSnapshot = false;
+            } else {
+                loadError = listing.error;
+            }
+        } else if (usage.generation() != sizesGeneration) {
+            // New directory sizes arrived
+            sizesGeneration = usage.generation();
+            queueSizes();
+            // Not while filtering: re-sorting would rebuild the filter on every result
+            if (sortBySize && !filtering) {
+                sortListing();
+                filterStale = true;
+            }
         }
         
-        // Handle line wrapping
-        if ((int)originalLine.length() <= availableWidth) {
-            // Line fits in one line
-            wrappedLines.push_back({static_cast<int>(i), originalLine});
+        auto frameStart = std::chrono::steady_clock::now();
+        
+        // Calculate display bounds
+        maxRows = LINES - 7; // Adjust for header and footer lines
+        if (selected >= offset + maxRows) {
+            offset = selected - maxRows + 1;
+        } else if (selected < offset) {
+            offset = selected;
+        }
+        
+        // Describe the frame row by row; the renderer works out what to send
+        int visible = std::max(0, std::min(offset + maxRows, shownCount()) - offset);
+        // The preview pane uses the whole list area, however short the listing
+        int listRows = previewing ? std::max(0, maxRows) : visible;
+        renderer.beginFrame(listRows + 7);
+        char row[512];
+        if (showStats) {
+            uint64_t lookups = snapshots.hits() + snapshots.misses();
+            snprintf(row, sizeof(row),
+                     "Frame %.1f ms (terminal %.1f ms) | List %lld ms, %zu stats | Sort %.1f ms | "
+                     "Snapshots %d%% hit | Listing %s",
+                     frameTime.count() / 1000.0, terminalTime.count() / 1000.0, (long long)listTime.count(),
+                     statCount, sortTime.count() / 1000.0,
+                     lookups > 0 ? (int)(snapshots.hits() * 100 / lookups) : 0,
+                     FileOperations::formatFileSize(listingBytes).c_str());
+            renderer.setRow(0, row, A_BOLD);
         } else {
-            // Line needs to be wrapped
-            size_t pos = 0;
-            while (pos < originalLine.length()) {
-                // Try to wrap at word boundaries
-                size_t wrapPos = pos + availableWidth;
-                if (wrapPos >= originalLine.length()) {
-                    // Remaining text fits in one line
-                    wrappedLines.push_back({static_cast<int>(i), originalLine.substr(pos)});
-                    break;
-                }
-                
-                // Try to find a word boundary
-                size_t spacePos = originalLine.rfind(' ', wrapPos);
-                if (spacePos != std::string::npos && spacePos > pos) {
-                    // Found a space to wrap at
-                    wrappedLines.push_back({static_cast<int>(i), originalLine.substr(pos, spacePos - pos)});
-                    pos = spacePos + 1; // Skip the space
-                } else {
-                    // No good word boundary, hard wrap
-                    wrappedLines.push_back({static_cast<int>(i), originalLine.substr(pos, availableWidth)});
-                    pos += availableWidth;
-                }
+            renderer.setRow(0, "CLI File Explorer - Interactive Mode");
+        }
+        std::string pathRow = "Current path: " + currentPath;
+        if (loader.state() == DirectoryLoader::State::LOADING && !showingSnapshot) {
+            char spinner[48];
+            snprintf(spinner, sizeof(spinner), "  [loading %c %.1fs]", "|/-\\"[(loader.elapsed().count() / 100) % 4],
+                     loader.elapsed().count() / 1000.0);
+            pathRow += spinner;
+        }
+        renderer.setRow(1, pathRow);
+        
+        // Preview of the entry under the cursor, if it is ready
+        int listWidth = std::min(PREVIEW_LIST_WIDTH, COLS / 2);
+        Previewer::Preview preview;
+        std::string previewTitle;
+        bool previewWaiting = false;
+        if (previewing && selected < shownCount() && entryAt(selected).getName() != "..") {
+            const auto& file = entryAt(selected);
+            previewTitle = file.getName();
+            if (!previewer.request(childPath(file.getName()), file, preview)) {
+                preview.lines.assign(1, "Loading preview...");
+                previewWaiting = true;
+            } else {
+                previewTitle += " (" + preview.kind + ")";
             }
         }
-    }
-    
-    int ch;
-    while (true) {
-        werase(fileWin);
-        box(fileWin, 0, 0);
-        mvwprintw(fileWin, 0, 2, "File: %s (%d lines)", filePath.c_str(), (int)lines.size());
+        // A listing row cut to the left column, followed by a line of the preview
+        auto withPreview = [&](const std::string& left, int line) {
+            std::string text = left.substr(0, std::max(0, listWidth - 1));
+            text.resize(std::max(0, listWidth - 1), ' ');
+            text += "| ";
+            if (line >= 0 && line < (int)preview.lines.size()) {
+                text += preview.lines[line];
+            }
+            return text;
+        };
         
-        // Display content with scrolling and line numbers
-        int maxDisplayLines = LINES - 4;
-        int end = std::min(offset + maxDisplayLines, (int)wrappedLines.size());
+        if (previewing) {
+            snprintf(row, sizeof(row), "  %-30s %-12s", "Name", "Size");
+            std::string header = withPreview(row, -1) + previewTitle;
+            renderer.setRow(2, header);
+            renderer.setRow(3, std::string(std::max(0, listWidth - 1), '-') + "+" + std::string(std::max(0, COLS - listWidth), '-'));
+        } else {
+            snprintf(row, sizeof(row), "%-30s %-12s %-20s %-12s %-10s", "Name", "Size", "Modified", "Permissions", "Type");
+            renderer.setRow(2, row);
+            renderer.setRow(3, std::string(90, '-'));
+        }
         
+        // Display files
+        int end = offset + visible;
         for (int i = offset; i < end; i++) {
-            const WrappedLine& wrappedLine = wrappedLines[i];
+            const auto& file = entryAt(i);
+            std::string type;
+            switch (file.getType()) {
+                case FileInfo::FileType::DIRECTORY:
+                    type = "[DIR]";
+                    break;
+                case FileInfo::FileType::FILE:
+                    type = "[FILE]";
+                    break;
+                case FileInfo::FileType::SYMLINK:
+                    type = "[LINK]";
+                    break;
+                default:
+                    type = "[UNK]";
+                    break;
+            }
             
-            // Format line number (only for first line of wrapped content)
-            char lineNum[16];
-            if (i == 0 || wrappedLine.originalLineNum != wrappedLines[i-1].originalLineNum) {
-                snprintf(lineNum, sizeof(lineNum), "%6d ", wrappedLine.originalLineNum + 1);
-            } else {
-                snprintf(lineNum, sizeof(lineNum), "       "); // Just spaces for continuation lines
+            std::string name = file.getName();
+            // Truncate long names
+            if (name.length() > 29) {
+                name = name.substr(0, 26) + "...";
             }
             
-            // Print line number with color if available
-            if (hasColor) {
-                wattron(fileWin, COLOR_PAIR(1));
-                mvwprintw(fileWin, i - offset + 1, 1, "%s", lineNum);
-                wattroff(fileWin, COLOR_PAIR(1));
+            std::string sizeStr;
+            if (file.getType() == FileInfo::FileType::DIRECTORY) {
+                uint64_t size = 0;
+                if (directorySize(file, size)) {
+                    sizeStr = FileOperations::formatFileSize(size);
+                } else if (file.getName() != "..") {
+                    // On screen, so wanted now
+                    usage.computeAsync(childPath(file.getName()));
+                    sizeStr = "...";
+                } else {
+                    sizeStr = "<DIR>";
+                }
             } else {
-                mvwprintw(fileWin, i - offset + 1, 1, "%s", lineNum);
+                sizeStr = FileOperations::formatFileSize(file.getSize());
             }
             
-            // Print content
-            if (hasColor) {
-                wattron(fileWin, COLOR_PAIR(2));
-                mvwprintw(fileWin, i - offset + 1, contentStart, "%s", wrappedLine.content.c_str());
-                wattroff(fileWin, COLOR_PAIR(2));
-            } else {
-                mvwprintw(fileWin, i - offset + 1, contentStart, "%s", wrappedLine.content.c_str());
+            if (previewing) {
+                // Just the name and size beside the preview; the marker shows the cursor
+                snprintf(row, sizeof(row), "%s %-30s %-12s", i == selected ? ">" : " ", name.c_str(), sizeStr.c_str());
+                renderer.setRow(4 + i - offset, withPreview(row, i - offset));
+                continue;
             }
+            snprintf(row, sizeof(row), "%s %-30s %-12s %-20s %-12s %-10s",
+                     i == selected ? ">" : " ",
+                     name.c_str(),
+                     sizeStr.c_str(),
+                     FileOperations::formatTime(file.getModifiedTime()).c_str(),
+                     FileOperations::formatPermissions(file.getPermissions()).c_str(),
+                     type.c_str());
+            renderer.setRow(4 + i - offset, row, i == selected ? A_REVERSE : A_NORMAL);
+        }
+        if (previewing) {
+            // Preview lines below the end of the listing
+            for (int r = visible; r < listRows; r++) {
+                renderer.setRow(4 + r, withPreview("", r));
+            }
+        } else {
+            renderer.setScrollRegion(4, 4 + visible);
+        }
+        
+        // Display footer
+        DiskUsage::Usage total;
+        std::string totalStr;
+        if (usage.lookup(currentPath, total)) {
+            totalStr = "Total: " + FileOperations::formatFileSize(total.apparentBytes) + " (" +
+                       FileOperations::formatFileSize(total.allocatedBytes) + " on disk) | ";
+        } else if (sortBySize || usage.isPending(currentPath)) {
+            totalStr = "Total: calculating... | ";
+        }
+        renderer.setRow(4 + listRows, std::string(90, '-'));
+        if (filtering) {
+            renderer.setRow(5 + listRows, "Filter: " + filter.query() + "_ (" + std::to_string(shownCount()) + " of " +
+                                             std::to_string(files.size()) + ")");
+        } else if (!loadError.empty()) {
+            renderer.setRow(5 + listRows, "Cannot list directory: " + loadError + " | Enter on .. to go back");
+        } else {
+            renderer.setRow(5 + listRows, totalStr + "Sort: " + (sortBySize ? "size" : "name"));
+        }
+        if (filtering) {
+            renderer.setRow(6 + listRows, "Type to filter | ↑/↓: Navigate | Enter: Open | Backspace: Widen | Esc: Done");
+        } else {
+            renderer.setRow(6 + listRows, "↑/↓: Navigate | Enter: Open | Ctrl+E: Edit | n: New | d: Delete | r: Rename | s: Sort | /: Filter | p: Preview | b: Bookmarks | D: Dupes | q: Quit");
         }
         
-        mvwprintw(fileWin, LINES - 3, 1, "Lines %d-%d of %d (wrapped)", offset + 1, end, (int)wrappedLines.size());
-        mvwprintw(fileWin, LINES - 3, COLS - 25, "↑/↓: Navigate | q: Close");
+        auto frameBuilt = std::chrono::steady_clock::now();
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            FRAME_INTERVAL - (std::chrono::steady_clock::now() - lastFrame));
+        if (!inputWithin(wait)) {
+            auto presentStart = std::chrono::steady_clock::now();
+            renderer.present(stdscr);
+            loadingShown = true;
+            lastFrame = std::chrono::steady_clock::now();
+            terminalTime = std::chrono::duration_cast<std::chrono::microseconds>(lastFrame - presentStart);
+            frameTime = std::chrono::duration_cast<std::chrono::microseconds>(frameBuilt - frameStart) + terminalTime;
+        }
         
-        wrefresh(fileWin);
+        // Read the directory under the cursor ahead of time
+        if (selected < shownCount() && entryAt(selected).getType() == FileInfo::FileType::DIRECTORY &&
+            entryAt(selected).getName() != "..") {
+            prefetcher.hint(childPath(entryAt(selected).getName()));
+        } else {
+            prefetcher.hint("");
+        }
         
-        ch = wgetch(fileWin);
-        switch (ch) {
-            case KEY_UP:
-                if (offset > 0) {
-                    offset--;
-                }
-                break;
-                
-            case KEY_DOWN:
-                if (offset + maxDisplayLines < (int)wrappedLines.size()) {
-                    offset++;
-                }
-                break;
-                
-            case KEY_PPAGE: // Page Up
-                offset = std::max(0, offset - maxDisplayLines);
-                break;
-                
-            case KEY_NPAGE: // Page Down
-                if (offset + maxDisplayLines < (int)wrappedLines.size()) {
-                    offset = std::min(offset + maxDisplayLines, (int)wrappedLines.size() - maxDisplayLines);
-                }
-                break;
-                
-            case 'q':
-            case 'Q':
-                delwin(fileWin);
+        // Wake up periodically while the listing or directory sizes are still arriving
+        if (loader.state() == DirectoryLoader::State::LOADING) {
+            timeout(100);
+        } else if (previewWaiting) {
+            timeout(PREVIEW_POLL_MS);
+        } else {
+            timeout(usage.pendingCount() > 0 ? 200 : -1);
+        }
+        
+        // Get user input, then every key already queued behind it, so the
+        // frame is built once for the lot
+        for (int ch = getch(); ch != ERR; ch = reload ? ERR : queuedKey()) {
+            if (!handleKey(ch)) {
                 return;
+            }
         }
     }
+    
+    // Clean up ncurses
+    endwin();
 }
 
 void CommandLineInterface::editFileWithVim(const std::string& filePath) {
@@ -0,0 +1,532 @@
+#ifdef USE_NCURSES
+#include "../../include/cli/CommandLineInterface.h"
+#include "../../include/viewer/CompressedFile.h"
+#include "../../include/viewer/ContentSearch.h"
+#include "../../include/viewer/FileWatcher.h"
+#include "../../include/viewer/HexFormat.h"
+#include "../../include/viewer/LineSource.h"
+#include "../../include/viewer/MappedFile.h"
+#include <ncurses.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+
+// Read a short answer on the given row of the window; empty if cancelled
+std::string CommandLineInterface::promptInput(WINDOW* win, int row, const char* prompt) {
+    char buffer[64] = {0};
+    wmove(win, row, 1);
+    wclrtoeol(win);
+    mvwprintw(win, row, 1, "%s", prompt);
+    wtimeout(win, -1);
+    echo();
+    curs_set(1);
+    int result = wgetnstr(win, buffer, sizeof(buffer) - 1);
+    curs_set(0);
+    noecho();
+    return result == ERR ? std::string() : std::string(buffer);
+}
+
+// Color pairs of the viewers: 1 for line numbers, 2 for content. Set up
+// once per ncurses session rather than every time a file is opened.
+void CommandLineInterface::initColors() {
+    if (colorsReady || !has_colors()) {
+        return;
+    }
+    start_color();
+    init_pair(1, COLOR_YELLOW, COLOR_BLACK); // Line numbers
+    init_pair(2, COLOR_WHITE, COLOR_BLACK);  // Content
+    colorsReady = true;
+}
+
+void CommandLineInterface::displayFileContent(const std::string& filePath) {
+    // Create a new window for file content
+    WINDOW* fileWin = newwin(LINES - 2, COLS - 2, 1, 1);
+    keypad(fileWin, TRUE);
+    box(fileWin, 0, 0);
+    wrefresh(fileWin);
+    
+    // Compressed logs are decompressed on the fly instead of shown as bytes
+    if (CompressedFile::detect(filePath) != CompressedFile::Format::NONE) {
+        delwin(fileWin);
+        displayCompressedContent(filePath);
+        return;
+    }
+    
+    // Map the file; nothing is read until a row is drawn
+    MappedFile file;
+    if (!file.open(filePath)) {
+        mvwprintw(fileWin, 1, 1, "Cannot open file: %s (%s)", filePath.c_str(), file.error().c_str());
+        wrefresh(fileWin);
+        wgetch(fileWin);
+        delwin(fileWin);
+        return;
+    }
+    
+    // Binary files get the hex view instead of garbage lines
+    if (HexFormat::looksBinary(file.data(), file.size())) {
+        delwin(fileWin);
+        displayHexContent(filePath, file);
+        return;
+    }
+    
+    MappedLineSource source(file);
+    viewLines(fileWin, filePath, source, &source);
+    delwin(fileWin);
+}
+
+void CommandLineInterface::displayCompressedContent(const std::string& filePath) {
+    WINDOW* fileWin = newwin(LINES - 2, COLS - 2, 1, 1);
+    keypad(fileWin, TRUE);
+    box(fileWin, 0, 0);
+    wrefresh(fileWin);
+    
+    // Indexing starts right away; lines are shown as soon as they are reached
+    CompressedFile file;
+    if (!file.open(filePath)) {
+        mvwprintw(fileWin, 1, 1, "Cannot open file: %s (%s)", filePath.c_str(), file.error().c_str());
+        wrefresh(fileWin);
+        wgetch(fileWin);
+        delwin(fileWin);
+        return;
+    }
+    
+    CompressedLineSource source(file);
+    viewLines(fileWin, filePath, source, nullptr);
+    delwin(fileWin);
+}
+
+// Scroll through the lines of a file until 'q'. Search, follow mode and the
+// hex view work on the mapping, so they are offered when mapped is given
+// (the same source as a plain file).
+void CommandLineInterface::viewLines(WINDOW* fileWin, const std::string& filePath, LineSource& source,
+                                     MappedLineSource* mapped) {
+    initColors();
+    bool hasColor = colorsReady;
+    
+    int contentStart = 9; // Position after line number
+    
+    // Top of the view: a line and a wrapped row within it
+    uint64_t topLine = 0;
+    size_t topRow = 0;
+    
+    // A line the indexer has not reached yet (UINT64_MAX: the end); the
+    // view waits at the end so far and moves on as indexing goes on
+    bool chasing = false;
+    uint64_t chaseLine = 0;
+    
+    // Lines are wrapped when first drawn and kept for the current width
+    auto rowsOf = [&](uint64_t line, int width) -> const std::vector<RowSegment>& {
+        return source.rows(line, width);
+    };
+    
+    // Search runs on a worker; the loop polls it and jumps to the hit
+    std::unique_ptr<ContentSearch> search;
+    if (mapped) {
+        search = std::make_unique<ContentSearch>(mapped->file());
+    }
+    bool searchPending = false;
+    bool searchForward = true;   // Direction of the last / or ?
+    bool pendingForward = true;  // Direction of the scan in progress
+    bool hasMatch = false;
+    uint64_t matchOffset = 0;
+    std::string highlight; // Last pattern, marked in the visible rows
+    std::string message;
+    
+    // Follow mode: stay at the end and pick up appended data as it arrives
+    bool following = false;
+    FileWatcher watcher;
+    auto reloadFile = [&]() {
+        // The mapping may move, so the search may not be reading it
+        search->cancel();
+        if (mapped->reload(filePath)) {
+            topLine = 0;
+            topRow = 0;
+        }
+    };
+    
+    int ch;
+    while (true) {
+        int availableWidth = COLS - contentStart - 2;
+        int maxDisplayLines = LINES - 4;
+        
+        // A file truncated under the mapping reads as zeros past its new end
+        if (mapped && mapped->file().shrank()) {
+            reloadFile();
+            message = "File was truncated; showing it from the top";
+        }
+        
+        // Pick up a finished search and bring the hit to the top of the view
+        if (searchPending && search->state() != ContentSearch::State::RUNNING) {
+            searchPending = false;
+            if (search->state() == ContentSearch::State::FOUND) {
+                hasMatch = true;
+                matchOffset = search->result();
+                topLine = mapped->lineAtOffset(matchOffset);
+                const std::vector<RowSegment>& rows = rowsOf(topLine, availableWidth);
+                topRow = 0;
+                while (topRow + 1 < rows.size() && rows[topRow + 1].start <= matchOffset) {
+                    topRow++;
+                }
+                if (search->wrapped()) {
+                    message = pendingForward ? "Search hit bottom, continued at top" : "Search hit top, continued at bottom";
+                }
+            } else if (search->state() == ContentSearch::State::NOT_FOUND) {
+                message = "Pattern not found: " + highlight;
+            } else {
+                message = "Search cancelled";
+            }
+        }
+        
+        source.trim(topLine);
+        
+        // A narrower width can leave the top position past its line's last row
+        const std::vector<RowSegment>& topRows = rowsOf(topLine, availableWidth);
+        if (!topRows.empty() && topRow >= topRows.size()) {
+            topRow = topRows.size() - 1;
+        }
+        
+        werase(fileWin);
+        box(fileWin, 0, 0);
+        
+        // Lay out rows from the top position, wrapping only the lines on screen
+        int screenRow = 0;
+        uint64_t line = topLine;
+        size_t row = topRow;
+        uint64_t lastLine = topLine;
+        bool moreBelow = false;
+        uint64_t viewBegin = topRow < topRows.size() ? topRows[topRow].start : 0;
+        uint64_t viewEnd = viewBegin;
+        while (screenRow < maxDisplayLines) {
+            const std::vector<RowSegment>& segments = rowsOf(line, availableWidth);
+            if (segments.empty()) {
+                break; // End of file, or of what has been indexed
+            }
+            const char* text = source.text(line);
+            
+            for (; row < segments.size() && screenRow < maxDisplayLines; row++, screenRow++) {
+                // Format line number (only for first row of a wrapped line)
+                char lineNum[24];
+                if (row == 0) {
+                    snprintf(lineNum, sizeof(lineNum), "%6llu ", (unsigned long long)line + 1);
+                } else {
+                    snprintf(lineNum, sizeof(lineNum), "       "); // Just spaces for continuation lines
+                }
+                
+                // Print line number with color if available
+                if (hasColor) {
+                    wattron(fileWin, COLOR_PAIR(1));
+                    mvwprintw(fileWin, screenRow + 1, 1, "%s", lineNum);
+                    wattroff(fileWin, COLOR_PAIR(1));
+                } else {
+                    mvwprintw(fileWin, screenRow + 1, 1, "%s", lineNum);
+                }
+                
+                // Print content straight from the source's text
+                const RowSegment& segment = segments[row];
+                viewEnd = segment.start + segment.length;
+                if (hasColor) {
+                    wattron(fileWin, COLOR_PAIR(2));
+                }
+                if (segment.length > 0) {
+                    mvwaddnstr(fileWin, screenRow + 1, contentStart, text + segment.start, (int)segment.length);
+                }
+                if (hasColor) {
+                    wattroff(fileWin, COLOR_PAIR(2));
+                }
+                
+                // Mark every occurrence of the search pattern in this row,
+                // including ones that continue from or into a neighbouring row
+                if (!highlight.empty() && segment.length > 0) {
+                    uint64_t lineBegin = segments.front().start;
+                    uint64_t lineEnd = segments.back().start + segments.back().length;
+                    uint64_t overlap = highlight.size() - 1;
+                    uint64_t rowEnd = segment.start + segment.length;
+                    uint64_t from = segment.start > lineBegin + overlap ? segment.start - overlap : lineBegin;
+                    uint64_t to = std::min(lineEnd, rowEnd + overlap);
+                    uint64_t hit = 0;
+                    while (ContentSearch::findForward(text, from, to, highlight, hit)) {
+                        uint64_t low = std::max(hit, segment.start);
+                        uint64_t high = std::min(hit + highlight.size(), rowEnd);
+                        if (low < high) {
+                            mvwchgat(fileWin, screenRow + 1, contentStart + (int)(low - segment.start), (int)(high - low),
+                                     A_REVERSE, hasColor ? 2 : 0, nullptr);
+                        }
+                        from = hit + 1;
+                    }
+                }
+            }
+            
+            lastLine = line;
+            if (row < segments.size()) {
+                moreBelow = true; // Screen filled in the middle of a line
+                break;
+            }
+            line++;
+            row = 0;
+            if (screenRow >= maxDisplayLines) {
+                moreBelow = source.hasLine(line);
+            }
+        }
+        
+        // Line counts are only final once the whole file has been seen
+        std::string format = source.format();
+        mvwprintw(fileWin, 0, 2, "File: %s (%s%s%llu%s lines)", filePath.c_str(), format.c_str(),
+                  format.empty() ? "" : ", ", (unsigned long long)source.knownLines(), source.complete() ? "" : "+");
+        char status[128];
+        snprintf(status, sizeof(status), "Lines %llu-%llu of %llu%s", (unsigned long long)topLine + 1,
+                 (unsigned long long)lastLine + 1, (unsigned long long)source.knownLines(),
+                 source.complete() ? "" : "+");
+        std::string statusLine = status;
+        std::string note = source.progressNote();
+        if (!note.empty()) {
+            statusLine += " | " + note;
+        }
+        if (following) {
+            statusLine += " | Following";
+        }
+        if (searchPending) {
+            snprintf(status, sizeof(status), " | Searching %d%% (any key cancels)", (int)(search->progress() * 100));
+            statusLine += status;
+        } else if (!message.empty()) {
+            statusLine += " | " + message;
+            message.clear();
+        }
+        mvwaddnstr(fileWin, LINES - 3, 1, statusLine.c_str(), COLS - 4);
+        
+        // Key help only where it does not cover the status
+        const char* help = mapped ? "/?: Search | :N G %: Jump | F: Follow | x: Hex | q: Close" : ":N G %: Jump | q: Close";
+        int helpColumn = COLS - 3 - (int)strlen(help);
+        if (helpColumn > (int)statusLine.size() + 2) {
+            mvwaddstr(fileWin, LINES - 3, helpColumn, help);
+        }
+        
+        wrefresh(fileWin);
+        
+        if (mapped) {
+            mapped->readAhead(viewBegin, viewEnd);
+        }
+        
+        // Move the top position by one wrapped row
+        auto scrollDown = [&]() {
+            if (topRow + 1 < rowsOf(topLine, availableWidth).size()) {
+                topRow++;
+            } else {
+                topLine++;
+                topRow = 0;
+            }
+        };
+        auto scrollUp = [&]() {
+            if (topRow > 0) {
+                topRow--;
+            } else if (topLine > 0) {
+                topLine--;
+                topRow = rowsOf(topLine, availableWidth).size() - 1;
+            }
+        };
+        
+        // Put the last row of the file at the bottom of the screen; while
+        // indexing, of the part indexed so far, without waiting for the rest
+        auto jumpToEnd = [&]() {
+            chasing = !source.complete();
+            chaseLine = UINT64_MAX;
+            uint64_t total = source.knownLines();
+            if (total == 0) {
+                return;
+            }
+            topLine = total - 1;
+            topRow = rowsOf(topLine, availableWidth).size() - 1;
+            for (int i = 1; i < maxDisplayLines; i++) {
+                scrollUp();
+            }
+        };
+        // Start a search from the given offset; the result is picked up above
+        auto startSearch = [&](bool forward, uint64_t from) {
+            searchPending = true;
+            pendingForward = forward;
+            search->start(highlight, from, forward);
+        };
+        auto topOffset = [&]() -> uint64_t {
+            const std::vector<RowSegment>& rows = rowsOf(topLine, availableWidth);
+            return rows.empty() ? 0 : rows[std::min(topRow, rows.size() - 1)].start;
+        };
+        
+        auto jumpToLine = [&](uint64_t target) {
+            if (target >= source.knownLines() && !source.complete()) {
+                // Not indexed yet: wait at the end so far
+                jumpToEnd();
+                chaseLine = target;
+            } else if (source.hasLine(target)) {
+                chasing = false;
+                topLine = target;
+                topRow = 0;
+            } else {
+                jumpToEnd();
+            }
+        };
+        
+        // Drawing ran into the new end of a truncated file: start over now
+        if (mapped && mapped->file().shrank()) {
+            continue;
+        }
+        if (following) {
+            // Sleep until a key arrives or the file changes. Without inotify
+            // the file is checked once a second instead, once the indexer
+            // has caught up; until then the view keeps moving down with it.
+            struct pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {watcher.fd(), POLLIN, 0}};
+            bool watching = watcher.fd() >= 0;
+            int ready = poll(fds, watching ? 2 : 1, chasing ? 200 : (watching ? -1 : 1000));
+            if (ready >= 0 && (watching ? (fds[1].revents & POLLIN) != 0 : !chasing)) {
+                if (!watching || watcher.readEvents()) {
+                    reloadFile();
+                    jumpToEnd();
+                }
+            } else if (chasing) {
+                jumpToLine(chaseLine);
+            }
+            // A signal (resize) also has to reach wgetch
+            if (ready >= 0 && !(fds[0].revents & POLLIN)) {
+                continue;
+            }
+            wtimeout(fileWin, 0);
+        } else if (searchPending) {
+            wtimeout(fileWin, 100);
+        } else {
+            // Redraw periodically while indexing so new lines and progress show up
+            wtimeout(fileWin, source.complete() ? -1 : 200);
+        }
+        ch = wgetch(fileWin);
+        if (ch == ERR) {
+            if (chasing) {
+                jumpToLine(chaseLine);
+            }
+            continue;
+        }
+        
+        // A key press abandons a search that is still scanning
+        if (searchPending && ch != KEY_RESIZE) {
+            search->cancel();
+            continue;
+        }
+        
+        // Like tail -f in less, moving around leaves follow mode, and a
+        // jump still waiting for the indexer
+        if (following && ch != 'F' && ch != KEY_RESIZE) {
+            following = false;
+            watcher.stop();
+        }
+        if (ch != KEY_RESIZE) {
+            chasing = false;
+        }
+        // The rest need the mapping
+        if (!mapped && (ch == 'F' || ch == '/' || ch == '?' || ch == 'n' || ch == 'N' || ch == 'x')) {
+            continue;
+        }
+        switch (ch) {
+            case KEY_RESIZE:
+                // Fit the window to the terminal; rows are rewrapped lazily
+                wresize(fileWin, LINES - 2, COLS - 2);
+                break;
+                
+            case KEY_UP:
+                scrollUp();
+                break;
+                
+            case KEY_DOWN:
+                if (moreBelow) {
+                    scrollDown();
+                }
+                break;
+                
+            case KEY_PPAGE: // Page Up
+                for (int i = 0; i < maxDisplayLines; i++) {
+                    scrollUp();
+                }
+                break;
+                
+            case KEY_NPAGE: // Page Down
+                if (moreBelow) {
+                    // Continue from the first row below the screen
+                    topLine = line;
+                    topRow = row;
+                }
+                break;
+                
+            case 'F':
+                following = !following;
+                if (following) {
+                    watcher.watch(filePath);
+                    reloadFile();
+                    jumpToEnd();
+                } else {
+                    watcher.stop();
+                }
+                break;
+                
+            case '/':
+            case '?': {
+                std::string input = promptInput(fileWin, LINES - 3, ch == '/' ? "/" : "?");
+                if (input.empty()) {
+                    break;
+                }
+                highlight = input;
+                hasMatch = false;
+                searchForward = ch == '/';
+                startSearch(searchForward, topOffset());
+                break;
+            }
+                
+            case 'n':
+            case 'N':
+                if (!highlight.empty()) {
+                    // n repeats the last direction, N goes the other way
+                    bool forward = (ch == 'n') == searchForward;
+                    uint64_t from = hasMatch ? matchOffset + (forward ? 1 : 0) : topOffset();
+                    startSearch(forward, from);
+                }
+                break;
+                
+            case 'x':
+                // Same mapping, shown as bytes until the hex view is closed
+                displayHexContent(filePath, mapped->file());
+                touchwin(fileWin);
+                break;
+                
+            case 'g':
+                topLine = 0;
+                topRow = 0;
+                break;
+                
+            case 'G':
+                jumpToEnd();
+                break;
+                
+            case ':':
+            case '%': {
+                // ":N" goes to line N, ":N%" (or "%N") to N percent of the file
+                std::string input = promptInput(fileWin, LINES - 3, ch == ':' ? ":" : "%");
+                if (input.empty()) {
+                    break;
+                }
+                bool percent = ch == '%' || input.back() == '%';
+                unsigned long long value = strtoull(input.c_str(), nullptr, 10);
+                if (percent) {
+                    jumpToLine(source.lineAtPercent(std::min(value, 100ULL)));
+                } else if (value > 0) {
+                    jumpToLine(value - 1);
+                }
+                break;
+            }
+                
+            case 'q':
+            case 'Q':
+                return;
+        }
+    }
+}
+#endif // USE_NCURSES
@@ -0,0 +1,132 @@
+#include "../../include/cli/FrameRenderer.h"
+#include <algorithm>
+
+void FrameRenderer::beginFrame(int rows) {
+    next_.assign(rows > 0 ? rows : 0, Row());
+    scrollTop_ = 0;
+    scrollBottom_ = 0;
+}
+
+void FrameRenderer::setRow(int row, const std::string& text, int attributes) {
+    if (row < 0 || row >= (int)next_.size()) {
+        return;
+    }
+    next_[row].text = text;
+    next_[row].attributes = attributes;
+}
+
+void FrameRenderer::setScrollRegion(int top, int bottom) {
+    scrollTop_ = top;
+    scrollBottom_ = bottom;
+}
+
+void FrameRenderer::invalidate() {
+    valid_ = false;
+}
+
+FrameRenderer::Plan FrameRenderer::plan(const std::vector<Row>& previous, const std::vector<Row>& next,
+                                        int top, int bottom) {
+    int rows = static_cast<int>(next.size());
+    bottom = std::min(bottom, rows);
+
+    // The previous row that ends up at `row` once the region is scrolled by `shift`
+    auto source = [&](int row, int shift) -> const Row* {
+        int from = row;
+        if (row >= top && row < bottom) {
+            from = row + shift;
+            if (from < top || from >= bottom) {
+                return nullptr; // Scrolled in: blank
+            }
+        }
+        return from < (int)previous.size() ? &previous[from] : nullptr;
+    };
+    auto changedRows = [&](int shift, std::vector<int>* dirty) {
+        int changed = 0;
+        for (int row = 0; row < rows; row++) {
+            const Row* old = source(row, shift);
+            if (old ? !(*old == next[row]) : !next[row].text.empty() || next[row].attributes != 0) {
+                changed++;
+                if (dirty) {
+                    dirty->push_back(row);
+                }
+            }
+        }
+        // Rows below the new frame that still show something
+        for (int row = rows; row < (int)previous.size(); row++) {
+            if (!previous[row].text.empty()) {
+                changed++;
+                if (dirty) {
+                    dirty->push_back(row);
+                }
+            }
+        }
+        return changed;
+    };
+
+    Plan result;
+    int best = changedRows(0, nullptr);
+    if (bottom - top > 2) {
+        // A scroll only pays off when it saves more than the one row it costs
+        for (int shift : {1, -1}) {
+            int changed = changedRows(shift, nullptr);
+            if (changed + 1 < best) {
+                best = changed;
+                result.scroll = shift;
+            }
+        }
+    }
+    changedRows(result.scroll, &result.dirty);
+    return result;
+}
+
+#ifdef USE_NCURSES
+void FrameRenderer::present(WINDOW* win) {
+    int height = getmaxy(win);
+    int width = getmaxx(win);
+    if (height != height_ || width != width_) {
+        height_ = height;
+        width_ = width;
+        valid_ = false;
+    }
+    if (next_.size() > static_cast<size_t>(height)) {
+        next_.resize(height);
+    }
+    if (!valid_) {
+        // Start from a blank window; curses still only sends what differs
+        // from the terminal
+        werase(win);
+        shown_.clear();
+    }
+
+    Plan steps = plan(shown_, next_, scrollTop_, scrollBottom_);
+    if (steps.scroll != 0) {
+        idlok(win, TRUE);
+        scrollok(win, TRUE);
+        wsetscrreg(win, scrollTop_, std::min(scrollBottom_, height) - 1);
+        wscrl(win, steps.scroll);
+        wsetscrreg(win, 0, height - 1);
+        scrollok(win, FALSE);
+    }
+    for (int row : steps.dirty) {
+        wmove(win, row, 0);
+        int length = 0;
+        if (row < (int)next_.size()) {
+            const Row& line = next_[row];
+            length = std::min<int>(line.text.size(), width);
+            wattrset(win, line.attributes);
+            waddnstr(win, line.text.c_str(), length);
+            wattrset(win, A_NORMAL);
+        }
+        // A full row leaves the cursor on the next one, with nothing to clear
+        if (length < width) {
+            wclrtoeol(win);
+        }
+        rowsDrawn_++;
+    }
+
+    wnoutrefresh(win);
+    doupdate();
+    shown_ = next_;
+    valid_ = true;
+}
+#endif
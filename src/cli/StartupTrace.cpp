@@ -0,0 +1,58 @@
+#include "../../include/cli/StartupTrace.h"
+#include <cstdio>
+#include <vector>
+
+namespace StartupTrace {
+
+namespace {
+
+struct Record {
+    const char* name;
+    double milliseconds;
+};
+
+bool tracing = false;
+std::chrono::steady_clock::time_point started;
+std::vector<Record> records;
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+void enable() {
+    tracing = true;
+    started = std::chrono::steady_clock::now();
+}
+
+bool enabled() {
+    return tracing;
+}
+
+void report() {
+    if (!tracing) {
+        return;
+    }
+    for (const auto& record : records) {
+        fprintf(stderr, "startup: %-24s %8.3f ms\n", record.name, record.milliseconds);
+    }
+    fprintf(stderr, "startup: %-24s %8.3f ms\n", "total since main", since(started));
+    // Only the first report: later work is no longer startup
+    records.clear();
+    tracing = false;
+}
+
+Phase::Phase(const char* name) : name_(name) {
+    if (tracing) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+Phase::~Phase() {
+    if (tracing) {
+        records.push_back(Record{name_, since(start_)});
+    }
+}
+
+} // namespace StartupTrace
@@ -0,0 +1,321 @@
+#include "../../include/du/DiskUsage.h"
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+int64_t nanoseconds(const struct timespec& time) {
+    return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+// A directory's mtime and ctime move with every entry added, removed or
+// renamed in it
+#ifdef __APPLE__
+int64_t modifiedAt(const struct stat& info) {
+    return nanoseconds(info.st_mtimespec);
+}
+int64_t changedAt(const struct stat& info) {
+    return nanoseconds(info.st_ctimespec);
+}
+#else
+int64_t modifiedAt(const struct stat& info) {
+    return nanoseconds(info.st_mtim);
+}
+int64_t changedAt(const struct stat& info) {
+    return nanoseconds(info.st_ctim);
+}
+#endif
+
+} // namespace
+#endif
+
+DiskUsage::DiskUsage(size_t threadCount) : pool_(threadCount) {}
+
+DiskUsage::~DiskUsage() {
+    // Outstanding scans bail out early instead of finishing whole trees
+    stopping_ = true;
+}
+
+DiskUsage::Usage DiskUsage::compute(const std::string& path) {
+    Usage usage;
+    if (lookup(path, usage)) {
+        return usage;
+    }
+
+    computeAsync(path);
+    std::unique_lock<std::mutex> lock(finishedMutex_);
+    finished_.wait(lock, [&] { return !isPending(path); });
+    lookup(path, usage);
+    return usage;
+}
+
+void DiskUsage::computeAsync(const std::string& path) {
+    std::shared_ptr<Job> job = startJob(path);
+    if (!job) {
+        return;
+    }
+    pool_.submit([this, job] { scanDirectory(job, job->root); });
+}
+
+bool DiskUsage::lookup(const std::string& path, Usage& usage) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(path);
+    if (it == cache_.end()) {
+        return false;
+    }
+    usage = it->second.usage;
+    return true;
+}
+
+bool DiskUsage::isPending(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.count(path) > 0;
+}
+
+size_t DiskUsage::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+uint64_t DiskUsage::generation() const {
+    return generation_;
+}
+
+void DiskUsage::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    invalidateLocked(path);
+}
+
+#ifndef _WIN32
+void DiskUsage::revalidate(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cache_.count(path) == 0) {
+            return;
+        }
+    }
+    // A stat can block on a slow mount, so not on the caller's thread
+    pool_.submit([this, path] {
+        if (stopping_) {
+            return;
+        }
+        struct stat info;
+        bool found = stat(path.c_str(), &info) == 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(path);
+        if (it != cache_.end() &&
+            (!found || modifiedAt(info) != it->second.modified || changedAt(info) != it->second.changed)) {
+            invalidateLocked(path);
+            generation_++;
+        }
+    });
+}
+#else
+void DiskUsage::revalidate(const std::string&) {}
+#endif
+
+void DiskUsage::invalidateLocked(const std::string& path) {
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        const std::string& cached = it->first;
+        bool below = cached.compare(0, path.size(), path) == 0 &&
+                     (cached.size() == path.size() || cached[path.size()] == '/');
+        bool above = path.compare(0, cached.size(), cached) == 0 &&
+                     (path.size() == cached.size() || path[cached.size()] == '/' || cached == "/");
+        if (below || above) {
+            it = cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DiskUsage::cancelPending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : pending_) {
+        entry.second->cancelled = true;
+    }
+}
+
+std::shared_ptr<DiskUsage::Job> DiskUsage::startJob(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_.count(path) > 0) {
+        return nullptr;
+    }
+    // A cancelled job may still be winding down; a new one takes its place
+    auto running = pending_.find(path);
+    if (running != pending_.end() && !running->second->cancelled) {
+        return nullptr;
+    }
+    auto job = std::make_shared<Job>();
+    job->root = path;
+    job->outstanding = 1;
+    pending_[path] = job;
+    return job;
+}
+
+#ifndef _WIN32
+// Account for one directory's entries and fan its subdirectories out to the pool
+void DiskUsage::scanDirectory(const std::shared_ptr<Job>& job, const std::string& path) {
+    bool stopped = stopping_ || job->cancelled;
+    DIR* dir = stopped ? nullptr : opendir(path.c_str());
+    if (!dir) {
+        if (!stopped) {
+            job->errors++;
+        }
+        finishDirectory(job);
+        return;
+    }
+
+    int dirFd = dirfd(dir);
+    struct stat dirStat;
+    if (fstat(dirFd, &dirStat) == 0) {
+        if (path == job->root) {
+            // Taken before reading, so a change during the scan makes the result stale
+            job->rootModified = modifiedAt(dirStat);
+            job->rootChanged = changedAt(dirStat);
+        }
+        job->apparentBytes += dirStat.st_size;
+        job->allocatedBytes += static_cast<uint64_t>(dirStat.st_blocks) * 512;
+        job->directories++;
+    }
+
+    std::string prefix = path;
+    if (prefix.back() != '/') {
+        prefix += "/";
+    }
+
+    uint64_t apparent = 0;
+    uint64_t allocated = 0;
+    uint64_t files = 0;
+    std::vector<std::string> subdirectories;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr && !stopping_ && !job->cancelled) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        // Never follow symlinks, like du
+        struct stat entryStat;
+        if (fstatat(dirFd, entry->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0) {
+            job->errors++;
+            continue;
+        }
+
+        if (S_ISDIR(entryStat.st_mode)) {
+            if (!addCached(job, prefix + entry->d_name, modifiedAt(entryStat), changedAt(entryStat))) {
+                subdirectories.push_back(prefix + entry->d_name);
+            }
+            continue;
+        }
+
+        uint64_t entryAllocated = static_cast<uint64_t>(entryStat.st_blocks) * 512;
+        if (entryStat.st_nlink > 1) {
+            std::pair<uint64_t, uint64_t> inode(entryStat.st_dev, entryStat.st_ino);
+            std::pair<uint64_t, uint64_t> bytes(entryStat.st_size, entryAllocated);
+            std::lock_guard<std::mutex> lock(job->inodesMutex);
+            if (!job->linkedInodes.emplace(inode, bytes).second) {
+                continue; // Another name for a file already counted
+            }
+        }
+
+        apparent += entryStat.st_size;
+        allocated += entryAllocated;
+        files++;
+    }
+    closedir(dir);
+
+    job->apparentBytes += apparent;
+    job->allocatedBytes += allocated;
+    job->files += files;
+
+    job->outstanding += subdirectories.size();
+    for (auto& subdirectory : subdirectories) {
+        pool_.submit([this, job, subdirectory] { scanDirectory(job, subdirectory); });
+    }
+    finishDirectory(job);
+}
+#else
+void DiskUsage::scanDirectory(const std::shared_ptr<Job>& job, const std::string&) {
+    job->errors++;
+    finishDirectory(job);
+}
+#endif
+
+// Count a subdirectory from its cached result instead of walking it; a
+// hardlinked file the job has already seen elsewhere is taken off again.
+// A result from before the directory last changed is dropped instead.
+bool DiskUsage::addCached(const std::shared_ptr<Job>& job, const std::string& path, int64_t modified,
+                          int64_t changed) {
+    Usage usage;
+    LinkedInodes linked;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(path);
+        if (it == cache_.end()) {
+            return false;
+        }
+        if (it->second.modified != modified || it->second.changed != changed) {
+            invalidateLocked(path);
+            return false;
+        }
+        usage = it->second.usage;
+        linked = it->second.linkedInodes;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job->inodesMutex);
+        for (const auto& inode : linked) {
+            if (!job->linkedInodes.insert(inode).second) {
+                usage.apparentBytes -= inode.second.first;
+                usage.allocatedBytes -= inode.second.second;
+                usage.files--;
+            }
+        }
+    }
+    job->apparentBytes += usage.apparentBytes;
+    job->allocatedBytes += usage.allocatedBytes;
+    job->files += usage.files;
+    job->directories += usage.directories;
+    job->errors += usage.errors;
+    return true;
+}
+
+// The last directory of a job to finish publishes the result
+void DiskUsage::finishDirectory(const std::shared_ptr<Job>& job) {
+    if (--job->outstanding > 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_ && !job->cancelled) {
+            Cached& cached = cache_[job->root];
+            cached.usage.apparentBytes = job->apparentBytes;
+            cached.usage.allocatedBytes = job->allocatedBytes;
+            cached.usage.files = job->files;
+            cached.usage.directories = job->directories;
+            cached.usage.errors = job->errors;
+            cached.modified = job->rootModified;
+            cached.changed = job->rootChanged;
+            std::lock_guard<std::mutex> inodesLock(job->inodesMutex);
+            cached.linkedInodes = std::move(job->linkedInodes);
+        }
+        auto it = pending_.find(job->root);
+        if (it != pending_.end() && it->second == job) {
+            pending_.erase(it);
+        }
+    }
+    generation_++;
+
+    std::lock_guard<std::mutex> lock(finishedMutex_);
+    finished_.notify_all();
+}
@@ -0,0 +1,211 @@
+#include "../../include/dupes/DuplicateFinder.h"
+#include "../../include/concurrency/ThreadPool.h"
+#include "../../include/hash/FastHash.h"
+#include "../../include/search/Search.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+DuplicateFinder::Report DuplicateFinder::findDuplicates(const std::string& directory) {
+    Report report;
+
+    // Stage 1: bucket regular files by size straight from the traversal metadata
+    std::map<uint64_t, std::vector<Candidate>> bySize;
+    std::set<std::pair<uint64_t, uint64_t>> seenInodes;
+    Search::walk(directory, true, [&](const std::string& path, const FileInfo& info) {
+        if (info.getType() != FileInfo::FileType::FILE || info.getSize() == 0) {
+            return;
+        }
+        report.filesScanned++;
+        // A second name for an inode already seen would free nothing
+        if (info.getInode() != 0 && !seenInodes.insert({info.getDevice(), info.getInode()}).second) {
+            report.hardlinksSkipped++;
+            return;
+        }
+        bySize[info.getSize()].push_back({path, info.getSize(), 0, false});
+    });
+
+    std::vector<Candidate> edgeCandidates;
+    for (auto& bucket : bySize) {
+        if (bucket.second.size() > 1) {
+            for (auto& candidate : bucket.second) {
+                edgeCandidates.push_back(std::move(candidate));
+            }
+        }
+    }
+    bySize.clear();
+
+    // Stage 2: cheap hash of both ends of every same-size file
+    hashAll(edgeCandidates, false);
+
+    std::vector<Candidate> fullCandidates;
+    std::vector<std::vector<Candidate>> confirmed;
+    std::map<uint64_t, std::vector<Candidate>> regrouped;
+    for (auto& candidate : edgeCandidates) {
+        regrouped[candidate.size].push_back(std::move(candidate));
+    }
+    for (auto& bucket : regrouped) {
+        for (auto& group : splitByHash(bucket.second)) {
+            if (group.front().size <= 2 * EDGE_BYTES) {
+                // The edges already covered the whole file
+                confirmed.push_back(std::move(group));
+            } else {
+                for (auto& candidate : group) {
+                    fullCandidates.push_back(std::move(candidate));
+                }
+            }
+        }
+    }
+
+    // Stage 3: full content hash of the survivors
+    hashAll(fullCandidates, true);
+    report.filesFullyHashed = fullCandidates.size();
+
+    regrouped.clear();
+    for (auto& candidate : fullCandidates) {
+        regrouped[candidate.size].push_back(std::move(candidate));
+    }
+    for (auto& bucket : regrouped) {
+        for (auto& group : splitByHash(bucket.second)) {
+            confirmed.push_back(std::move(group));
+        }
+    }
+
+    for (auto& group : confirmed) {
+        DuplicateGroup duplicates;
+        duplicates.size = group.front().size;
+        for (auto& candidate : group) {
+            duplicates.paths.push_back(std::move(candidate.path));
+        }
+        std::sort(duplicates.paths.begin(), duplicates.paths.end());
+        report.reclaimableBytes += duplicates.size * (duplicates.paths.size() - 1);
+        report.groups.push_back(std::move(duplicates));
+    }
+
+    // Largest savings first
+    std::sort(report.groups.begin(), report.groups.end(), [](const DuplicateGroup& a, const DuplicateGroup& b) {
+        uint64_t savingsA = a.size * (a.paths.size() - 1);
+        uint64_t savingsB = b.size * (b.paths.size() - 1);
+        if (savingsA != savingsB) {
+            return savingsA > savingsB;
+        }
+        return a.paths.front() < b.paths.front();
+    });
+
+    return report;
+}
+
+void DuplicateFinder::hashAll(std::vector<Candidate>& candidates, bool fullContents) {
+    if (candidates.empty()) {
+        return;
+    }
+
+    ThreadPool pool(std::min(ThreadPool::defaultThreadCount(), candidates.size()));
+    for (auto& candidate : candidates) {
+        pool.submit([&candidate, fullContents] {
+            candidate.readable = fullContents
+                ? hashContents(candidate.path, candidate.hash)
+                : hashEdges(candidate.path, candidate.size, candidate.hash);
+        });
+    }
+    pool.wait();
+}
+
+// Split one size bucket into groups of two or more files with equal hashes
+std::vector<std::vector<DuplicateFinder::Candidate>> DuplicateFinder::splitByHash(std::vector<Candidate>& group) {
+    std::unordered_map<uint64_t, std::vector<Candidate>> byHash;
+    for (auto& candidate : group) {
+        if (candidate.readable) {
+            byHash[candidate.hash].push_back(std::move(candidate));
+        }
+    }
+
+    std::vector<std::vector<Candidate>> groups;
+    for (auto& entry : byHash) {
+        if (entry.second.size() > 1) {
+            groups.push_back(std::move(entry.second));
+        }
+    }
+    return groups;
+}
+
+#ifndef _WIN32
+bool DuplicateFinder::hashEdges(const std::string& path, uint64_t size, uint64_t& hash) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Small files are read whole; larger ones contribute their head and tail
+    std::vector<char> buffer(2 * EDGE_BYTES);
+    size_t headBytes = static_cast<size_t>(std::min<uint64_t>(size, buffer.size()));
+    if (size > buffer.size()) {
+        headBytes = EDGE_BYTES;
+    }
+
+    bool ok = pread(fd, buffer.data(), headBytes, 0) == static_cast<ssize_t>(headBytes);
+    size_t total = headBytes;
+    if (ok && size > buffer.size()) {
+        ok = pread(fd, buffer.data() + EDGE_BYTES, EDGE_BYTES, static_cast<off_t>(size - EDGE_BYTES)) ==
+             static_cast<ssize_t>(EDGE_BYTES);
+        total += EDGE_BYTES;
+    }
+    close(fd);
+
+    if (ok) {
+        hash = FastHash::hash(buffer.data(), total);
+    }
+    return ok;
+}
+
+bool DuplicateFinder::hashContents(const std::string& path, uint64_t& hash) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    FastHash hasher;
+    std::vector<char> buffer(1 << 20);
+    bool ok = true;
+    while (true) {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        hasher.update(buffer.data(), static_cast<size_t>(n));
+    }
+    close(fd);
+
+    if (ok) {
+        hash = hasher.digest();
+    }
+    return ok;
+}
+#else
+bool DuplicateFinder::hashEdges(const std::string&, uint64_t, uint64_t&) {
+    return false;
+}
+
+bool DuplicateFinder::hashContents(const std::string&, uint64_t&) {
+    return false;
+}
+#endif
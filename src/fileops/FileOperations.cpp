@@ -7,6 +7,8 @@
 #include <ctime>
 #include <sstream>
 #include <filesystem>
+#include <vector>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -16,6 +18,10 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <climits>
+#include <cstring>
+#include <cerrno>
 #endif
 
 bool FileOperations::createFile(const std::string& path) {
@@ -55,7 +61,13 @@ bool FileOperations::deleteDirectory(const std::string& dirPath) {
 }
 
 bool FileOperations::renameFile(const std::string& oldPath, const std::string& newPath) {
+    CopyStats stats;
+    return moveFile(oldPath, newPath, stats);
+}
+
+bool FileOperations::moveFile(const std::string& oldPath, const std::string& newPath, CopyStats& stats) {
 #ifdef _WIN32
+    (void)stats;
     if (MoveFile(oldPath.c_str(), newPath.c_str())) {
         return true;
     }
@@ -63,19 +75,244 @@ bool FileOperations::renameFile(const std::string& oldPath, const std::string& n
     if (rename(oldPath.c_str(), newPath.c_str()) == 0) {
         return true;
     }
+    if (errno == EXDEV) {
+        // Different filesystems: copy to the target device, then swap in atomically
+        return moveAcrossDevices(oldPath, newPath, stats);
+    }
 #endif
     return false;
 }
 
 bool FileOperations::copyFile(const std::string& sourcePath, const std::string& destinationPath) {
+    CopyStats stats;
+    return copyFile(sourcePath, destinationPath, stats);
+}
+
+bool FileOperations::copyFile(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats) {
+#ifdef _WIN32
     try {
-        std::filesystem::copy(sourcePath, destinationPath, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::copy(sourcePath, destinationPath,
+                              std::filesystem::copy_options::overwrite_existing |
+                              std::filesystem::copy_options::recursive);
         return true;
     } catch (const std::filesystem::filesystem_error& ex) {
         std::cerr << "Copy failed: " << ex.what() << std::endl;
         return false;
     }
+#else
+    struct stat sourceStat;
+    if (lstat(sourcePath.c_str(), &sourceStat) != 0) {
+        std::cerr << "Copy failed: cannot stat " << sourcePath << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (S_ISREG(sourceStat.st_mode)) {
+        return copyRegularFile(sourcePath, destinationPath, stats);
+    }
+
+    if (S_ISLNK(sourceStat.st_mode)) {
+        // Recreate the link itself rather than copying its target
+        std::vector<char> target(sourceStat.st_size > 0 ? sourceStat.st_size + 1 : PATH_MAX);
+        ssize_t len = readlink(sourcePath.c_str(), target.data(), target.size() - 1);
+        if (len < 0) {
+            std::cerr << "Copy failed: cannot read link " << sourcePath << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        target[len] = '\0';
+        unlink(destinationPath.c_str());
+        if (symlink(target.data(), destinationPath.c_str()) != 0) {
+            std::cerr << "Copy failed: cannot create link " << destinationPath << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (S_ISDIR(sourceStat.st_mode)) {
+        // Writable until the children are in; a read-only source directory
+        // gets its own mode back at the end
+        bool created = mkdir(destinationPath.c_str(), 0700) == 0;
+        if (!created && errno != EEXIST) {
+            std::cerr << "Copy failed: cannot create directory " << destinationPath << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        DIR* dir = opendir(sourcePath.c_str());
+        if (!dir) {
+            std::cerr << "Copy failed: cannot open directory " << sourcePath << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        bool success = true;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+            std::string childSource = sourcePath + "/" + entry->d_name;
+            std::string childDestination = destinationPath + "/" + entry->d_name;
+            if (!copyFile(childSource, childDestination, stats)) {
+                success = false;
+            }
+        }
+        closedir(dir);
+        if (created && chmod(destinationPath.c_str(), sourceStat.st_mode & 07777) != 0) {
+            std::cerr << "Copy failed: cannot set mode of " << destinationPath << ": " << strerror(errno) << std::endl;
+            success = false;
+        }
+        return success;
+    }
+
+    std::cerr << "Copy failed: unsupported file type: " << sourcePath << std::endl;
+    return false;
+#endif
+}
+
+#ifndef _WIN32
+// Copy one regular file. Sparse sources are walked extent by extent with
+// SEEK_DATA/SEEK_HOLE so only the data regions are read and written; the
+// holes are recreated by seeking past them and truncating to the full size.
+bool FileOperations::copyRegularFile(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats,
+                                     bool durable) {
+    int inFd = open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd < 0) {
+        std::cerr << "Copy failed: cannot open " << sourcePath << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat sourceStat;
+    if (fstat(inFd, &sourceStat) != 0) {
+        std::cerr << "Copy failed: cannot stat " << sourcePath << ": " << strerror(errno) << std::endl;
+        close(inFd);
+        return false;
+    }
+
+    int outFd = open(destinationPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, sourceStat.st_mode & 07777);
+    if (outFd < 0) {
+        std::cerr << "Copy failed: cannot create " << destinationPath << ": " << strerror(errno) << std::endl;
+        close(inFd);
+        return false;
+    }
+
+    const uint64_t fileSize = static_cast<uint64_t>(sourceStat.st_size);
+    // Fewer allocated blocks than the apparent size means there are holes
+    const bool sparse = static_cast<uint64_t>(sourceStat.st_blocks) * 512 < fileSize;
+    uint64_t copied = 0;
+    bool success = true;
+    bool extentsWalked = false;
+
+    if (sparse) {
+        extentsWalked = true;
+        off_t pos = 0;
+        while (static_cast<uint64_t>(pos) < fileSize) {
+            off_t dataStart = lseek(inFd, pos, SEEK_DATA);
+            if (dataStart < 0) {
+                if (errno == ENXIO) {
+                    break; // Only a hole remains up to EOF
+                }
+                // Filesystem without SEEK_DATA support; fall back to a dense copy
+                extentsWalked = false;
+                copied = 0;
+                break;
+            }
+            off_t dataEnd = lseek(inFd, dataStart, SEEK_HOLE);
+            if (dataEnd < 0) {
+                dataEnd = static_cast<off_t>(fileSize);
+            }
+            if (!copyRange(inFd, outFd, dataStart, dataEnd - dataStart)) {
+                success = false;
+                break;
+            }
+            copied += dataEnd - dataStart;
+            pos = dataEnd;
+        }
+    }
+
+    if (success && !extentsWalked && fileSize > 0) {
+        success = copyRange(inFd, outFd, 0, fileSize);
+        copied = fileSize;
+    }
+
+    // Extend the destination over any trailing hole
+    if (success && ftruncate(outFd, static_cast<off_t>(fileSize)) != 0) {
+        success = false;
+    }
+
+    if (success && durable && fsync(outFd) != 0) {
+        success = false;
+    }
+
+    if (!success) {
+        std::cerr << "Copy failed: " << sourcePath << " -> " << destinationPath << ": " << strerror(errno) << std::endl;
+    } else {
+        stats.logicalBytes += fileSize;
+        stats.physicalBytes += copied;
+        stats.filesCopied++;
+        if (extentsWalked) {
+            stats.sparseFiles++;
+        }
+    }
+
+    close(inFd);
+    if (close(outFd) != 0) {
+        success = false;
+    }
+    return success;
+}
+
+// Copy [offset, offset + length) to the same offset in outFd
+bool FileOperations::copyRange(int inFd, int outFd, uint64_t offset, uint64_t length) {
+#ifdef __linux__
+    // Let the kernel move the bytes (and reflink where the filesystem supports it)
+    loff_t inOffset = static_cast<loff_t>(offset);
+    loff_t outOffset = static_cast<loff_t>(offset);
+    uint64_t remaining = length;
+    while (remaining > 0) {
+        ssize_t n = copy_file_range(inFd, &inOffset, outFd, &outOffset, remaining, 0);
+        if (n < 0) {
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) {
+                break; // Not supported for this pair; finish with read/write below
+            }
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        remaining -= n;
+    }
+    offset = static_cast<uint64_t>(inOffset);
+    length = remaining;
+#endif
+
+    std::vector<char> buffer(1 << 20);
+    while (length > 0) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length, buffer.size()));
+        ssize_t n = pread(inFd, buffer.data(), chunk, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (n == 0) {
+            break; // Source shrank while copying
+        }
+        ssize_t written = 0;
+        while (written < n) {
+            ssize_t w = pwrite(outFd, buffer.data() + written, n - written, static_cast<off_t>(offset + written));
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            written += w;
+        }
+        offset += n;
+        length -= n;
+    }
+    return true;
 }
+#endif
 
 bool FileOperations::exists(const std::string& path) {
 #ifdef _WIN32
@@ -154,4 +391,16 @@ std::string FileOperations::formatPermissions(uint32_t permissions) {
 #endif
     
     return oss.str();
-}
\ No newline at end of file
+}
+
+// Summarise a copy as logical (apparent) versus physical (transferred) bytes
+std::string FileOperations::formatCopyStats(const CopyStats& stats) {
+    std::ostringstream oss;
+    oss << stats.filesCopied << (stats.filesCopied == 1 ? " file, " : " files, ")
+        << formatFileSize(stats.logicalBytes) << " logical, "
+        << formatFileSize(stats.physicalBytes) << " physical";
+    if (stats.sparseFiles > 0) {
+        oss << " (" << stats.sparseFiles << " sparse)";
+    }
+    return oss.str();
+}
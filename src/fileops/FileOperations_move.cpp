@@ -0,0 +1,186 @@
+#include "../../include/fileops/FileOperations.h"
+#include "../../include/concurrency/ThreadPool.h"
+
+#ifndef _WIN32
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string parentOf(const std::string& path) {
+    size_t pos = path.find_last_of('/');
+    if (pos == std::string::npos) {
+        return ".";
+    }
+    if (pos == 0) {
+        return "/";
+    }
+    return path.substr(0, pos);
+}
+
+// Hidden sibling of the destination, so the copy lands on the target device
+std::string temporarySibling(const std::string& path) {
+    std::string parent = parentOf(path);
+    size_t pos = path.find_last_of('/');
+    std::string name = (pos == std::string::npos) ? path : path.substr(pos + 1);
+    return parent + "/." + name + ".moving-" + std::to_string(getpid());
+}
+
+void addStats(FileOperations::CopyStats& total, const FileOperations::CopyStats& part) {
+    total.logicalBytes += part.logicalBytes;
+    total.physicalBytes += part.physicalBytes;
+    total.filesCopied += part.filesCopied;
+    total.sparseFiles += part.sparseFiles;
+}
+
+} // namespace
+
+// Move between filesystems: copy into a temporary name next to the
+// destination, fsync it, rename it into place and only then remove the
+// source. A failure at any point before the rename leaves the source intact;
+// once the rename is done the move has succeeded, and a source that cannot
+// be removed is only reported (stats.sourceLeftBehind).
+bool FileOperations::moveAcrossDevices(const std::string& oldPath, const std::string& newPath, CopyStats& stats) {
+    struct stat sourceStat;
+    if (lstat(oldPath.c_str(), &sourceStat) != 0) {
+        return false;
+    }
+
+    std::string tempPath = temporarySibling(newPath);
+    CopyStats moveStats;
+    bool copied;
+    if (S_ISDIR(sourceStat.st_mode)) {
+        copied = copyTreeParallel(oldPath, tempPath, moveStats);
+    } else if (S_ISREG(sourceStat.st_mode)) {
+        copied = copyRegularFile(oldPath, tempPath, moveStats, true);
+    } else {
+        copied = copyFile(oldPath, tempPath, moveStats);
+    }
+
+    if (!copied) {
+        removeTree(tempPath);
+        return false;
+    }
+
+    if (rename(tempPath.c_str(), newPath.c_str()) != 0) {
+        std::cerr << "Move failed: cannot rename " << tempPath << " -> " << newPath << ": " << strerror(errno) << std::endl;
+        removeTree(tempPath);
+        return false;
+    }
+    syncDirectory(parentOf(newPath));
+    addStats(stats, moveStats);
+
+    if (!removeTree(oldPath)) {
+        std::cerr << "Warning: moved to " << newPath << " but could not remove the source: " << oldPath << std::endl;
+        stats.sourceLeftBehind = true;
+        return true;
+    }
+    syncDirectory(parentOf(oldPath));
+    return true;
+}
+
+// Recreate the directory structure on this thread and fan the file copies
+// out over a thread pool. Every file is fsynced, then every directory.
+bool FileOperations::copyTreeParallel(const std::string& sourcePath, const std::string& destinationPath, CopyStats& stats) {
+    ThreadPool pool;
+    std::atomic<bool> success{true};
+    std::mutex statsMutex;
+
+    // Directories are created writable and get their real mode afterwards,
+    // otherwise read-only source directories could not be populated
+    std::vector<std::pair<std::string, mode_t>> createdDirectories;
+    std::vector<std::pair<std::string, std::string>> pending;
+    pending.emplace_back(sourcePath, destinationPath);
+
+    while (!pending.empty() && success) {
+        auto [source, destination] = pending.back();
+        pending.pop_back();
+
+        struct stat dirStat;
+        if (lstat(source.c_str(), &dirStat) != 0 || mkdir(destination.c_str(), 0700) != 0) {
+            std::cerr << "Move failed: cannot create directory " << destination << ": " << strerror(errno) << std::endl;
+            success = false;
+            break;
+        }
+        createdDirectories.emplace_back(destination, dirStat.st_mode & 07777);
+
+        DIR* dir = opendir(source.c_str());
+        if (!dir) {
+            std::cerr << "Move failed: cannot open directory " << source << ": " << strerror(errno) << std::endl;
+            success = false;
+            break;
+        }
+
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+            std::string childSource = source + "/" + entry->d_name;
+            std::string childDestination = destination + "/" + entry->d_name;
+
+            unsigned char type = entry->d_type;
+            if (type == DT_UNKNOWN) {
+                struct stat childStat;
+                if (lstat(childSource.c_str(), &childStat) == 0) {
+                    type = S_ISDIR(childStat.st_mode) ? DT_DIR : S_ISREG(childStat.st_mode) ? DT_REG : DT_UNKNOWN;
+                }
+            }
+
+            if (type == DT_DIR) {
+                pending.emplace_back(childSource, childDestination);
+                continue;
+            }
+
+            pool.submit([&, type, childSource, childDestination] {
+                CopyStats fileStats;
+                bool ok = (type == DT_REG)
+                    ? copyRegularFile(childSource, childDestination, fileStats, true)
+                    : copyFile(childSource, childDestination, fileStats);
+                if (!ok) {
+                    success = false;
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(statsMutex);
+                addStats(stats, fileStats);
+            });
+        }
+        closedir(dir);
+    }
+
+    pool.wait();
+
+    // Deepest directories first, so a read-only parent is locked down last
+    for (auto it = createdDirectories.rbegin(); it != createdDirectories.rend(); ++it) {
+        syncDirectory(it->first);
+        chmod(it->first.c_str(), it->second);
+    }
+    return success;
+}
+
+bool FileOperations::removeTree(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+    return !ec;
+}
+
+bool FileOperations::syncDirectory(const std::string& dirPath) {
+    int fd = open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+}
+#endif // _WIN32
@@ -0,0 +1,187 @@
+#include "../../include/hash/Checksum.h"
+#include "../../include/concurrency/ThreadPool.h"
+#include "../../include/hash/FastHash.h"
+#include "../../include/hash/Sha256.h"
+#include "../../include/search/Search.h"
+#include "../../include/FileSystem.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const uint64_t Checksum::CHUNK_SIZE;
+
+std::vector<Checksum::Result> Checksum::hashPaths(const std::vector<std::string>& paths, Algorithm algorithm,
+                                                  uint64_t chunkSize) {
+    std::vector<Result> results;
+
+    // Expand directories into the files below them
+    for (const auto& path : paths) {
+        if (FileSystem::isDirectory(path)) {
+            std::vector<Result> tree;
+            Search::walk(path, true, [&](const std::string& filePath, const FileInfo& info) {
+                if (info.getType() == FileInfo::FileType::FILE) {
+                    Result result;
+                    result.path = filePath;
+                    result.size = info.getSize();
+                    tree.push_back(std::move(result));
+                }
+            });
+            std::sort(tree.begin(), tree.end(), [](const Result& a, const Result& b) { return a.path < b.path; });
+            for (auto& result : tree) {
+                results.push_back(std::move(result));
+            }
+            continue;
+        }
+
+        Result result;
+        result.path = path;
+        struct stat statBuf;
+        if (stat(path.c_str(), &statBuf) != 0) {
+            result.error = strerror(errno);
+        } else {
+            result.size = static_cast<uint64_t>(statBuf.st_size);
+        }
+        results.push_back(std::move(result));
+    }
+
+    // One unit per file, or per chunk of a large file
+    std::vector<WorkUnit> units;
+    std::vector<std::vector<std::string>> chunkDigests(results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].error.empty()) {
+            continue;
+        }
+        uint64_t size = results[i].size;
+        if (algorithm == Algorithm::FAST && chunkSize > 0 && size > chunkSize) {
+            size_t chunks = static_cast<size_t>((size + chunkSize - 1) / chunkSize);
+            chunkDigests[i].resize(chunks);
+            for (size_t c = 0; c < chunks; c++) {
+                uint64_t offset = c * chunkSize;
+                units.push_back({i, offset, std::min(chunkSize, size - offset), c});
+            }
+        } else {
+            chunkDigests[i].resize(1);
+            units.push_back({i, 0, UINT64_MAX, 0});
+        }
+    }
+
+    std::mutex errorMutex;
+    ThreadPool pool(std::min<size_t>(ThreadPool::defaultThreadCount(), std::max<size_t>(units.size(), 1)));
+    for (const auto& unit : units) {
+        pool.submit([&, unit] {
+            std::string error;
+            if (!hashRange(results[unit.resultIndex].path, unit.offset, unit.length, algorithm,
+                           chunkDigests[unit.resultIndex][unit.chunkIndex], error)) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                results[unit.resultIndex].error = error;
+            }
+        });
+    }
+    pool.wait();
+
+    // Fold chunk digests, in chunk order, into the file digest
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].error.empty() || chunkDigests[i].empty()) {
+            continue;
+        }
+        if (chunkDigests[i].size() == 1) {
+            results[i].digest = chunkDigests[i][0];
+            continue;
+        }
+        FastHash combined(results[i].size);
+        for (const auto& digest : chunkDigests[i]) {
+            combined.update(digest.data(), digest.size());
+        }
+        results[i].digest = FastHash::toHex(combined.digest());
+    }
+
+    return results;
+}
+
+std::string Checksum::combineTree(const std::string& root, const std::vector<Result>& results, Algorithm algorithm) {
+    std::string prefix = root;
+    if (prefix.empty() || prefix.back() != '/') {
+        prefix += "/";
+    }
+
+    FastHash fast;
+    Sha256 sha;
+    for (const auto& result : results) {
+        if (result.path.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        if (!result.error.empty()) {
+            return "";
+        }
+        // Relative paths, so identical trees at different locations match
+        std::string line = result.path.substr(prefix.size()) + '\0' + result.digest + '\n';
+        if (algorithm == Algorithm::SHA256) {
+            sha.update(line.data(), line.size());
+        } else {
+            fast.update(line.data(), line.size());
+        }
+    }
+    return algorithm == Algorithm::SHA256 ? Sha256::toHex(sha.digest()) : FastHash::toHex(fast.digest());
+}
+
+#ifndef _WIN32
+bool Checksum::hashRange(const std::string& path, uint64_t offset, uint64_t length, Algorithm algorithm,
+                         std::string& digest, std::string& error) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = strerror(errno);
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, static_cast<off_t>(offset), length == UINT64_MAX ? 0 : static_cast<off_t>(length),
+                  POSIX_FADV_SEQUENTIAL);
+#endif
+
+    FastHash fast;
+    Sha256 sha;
+    std::vector<char> buffer(1 << 20);
+    bool ok = true;
+    while (length > 0) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(length, buffer.size()));
+        ssize_t n = pread(fd, buffer.data(), want, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = strerror(errno);
+            ok = false;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (algorithm == Algorithm::SHA256) {
+            sha.update(buffer.data(), static_cast<size_t>(n));
+        } else {
+            fast.update(buffer.data(), static_cast<size_t>(n));
+        }
+        offset += n;
+        if (length != UINT64_MAX) {
+            length -= n;
+        }
+    }
+    close(fd);
+
+    if (ok) {
+        digest = algorithm == Algorithm::SHA256 ? Sha256::toHex(sha.digest()) : FastHash::toHex(fast.digest());
+    }
+    return ok;
+}
+#else
+bool Checksum::hashRange(const std::string&, uint64_t, uint64_t, Algorithm, std::string&, std::string& error) {
+    error = "not supported on this platform";
+    return false;
+}
+#endif
@@ -0,0 +1,163 @@
+#include "../../include/hash/FastHash.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// xxHash is defined over little-endian reads
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round64(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+// Consume whole 32-byte stripes; returns the number of bytes consumed
+inline size_t consumeStripes(uint64_t acc[4], const unsigned char* p, size_t length) {
+    const unsigned char* const start = p;
+    const unsigned char* const limit = p + (length & ~size_t(31));
+    while (p < limit) {
+        acc[0] = round64(acc[0], read64(p));
+        acc[1] = round64(acc[1], read64(p + 8));
+        acc[2] = round64(acc[2], read64(p + 16));
+        acc[3] = round64(acc[3], read64(p + 24));
+        p += 32;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+uint64_t finalize(uint64_t h, const unsigned char* p, size_t length) {
+    while (length >= 8) {
+        h ^= round64(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+        length -= 8;
+    }
+    if (length >= 4) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        length -= 4;
+    }
+    while (length > 0) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+        length--;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+FastHash::FastHash(uint64_t seed) {
+    reset(seed);
+}
+
+void FastHash::reset(uint64_t seed) {
+    seed_ = seed;
+    accumulators_[0] = seed + PRIME64_1 + PRIME64_2;
+    accumulators_[1] = seed + PRIME64_2;
+    accumulators_[2] = seed;
+    accumulators_[3] = seed - PRIME64_1;
+    totalLength_ = 0;
+    bufferedBytes_ = 0;
+}
+
+void FastHash::update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLength_ += length;
+
+    // Top up a partially filled stripe first
+    if (bufferedBytes_ > 0) {
+        size_t fill = sizeof(buffer_) - bufferedBytes_;
+        if (length < fill) {
+            std::memcpy(buffer_ + bufferedBytes_, p, length);
+            bufferedBytes_ += length;
+            return;
+        }
+        std::memcpy(buffer_ + bufferedBytes_, p, fill);
+        consumeStripes(accumulators_, buffer_, sizeof(buffer_));
+        bufferedBytes_ = 0;
+        p += fill;
+        length -= fill;
+    }
+
+    size_t consumed = consumeStripes(accumulators_, p, length);
+    p += consumed;
+    length -= consumed;
+
+    if (length > 0) {
+        std::memcpy(buffer_, p, length);
+        bufferedBytes_ = length;
+    }
+}
+
+uint64_t FastHash::digest() const {
+    uint64_t h;
+    if (totalLength_ >= 32) {
+        const uint64_t* acc = accumulators_;
+        h = rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18);
+        h = mergeRound(h, acc[0]);
+        h = mergeRound(h, acc[1]);
+        h = mergeRound(h, acc[2]);
+        h = mergeRound(h, acc[3]);
+    } else {
+        h = seed_ + PRIME64_5;
+    }
+    h += totalLength_;
+    return finalize(h, buffer_, bufferedBytes_);
+}
+
+uint64_t FastHash::hash(const void* data, size_t length, uint64_t seed) {
+    FastHash hasher(seed);
+    hasher.update(data, length);
+    return hasher.digest();
+}
+
+std::string FastHash::toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; i--) {
+        hex[i] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return hex;
+}
@@ -0,0 +1,150 @@
+#include "../../include/hash/Sha256.h"
+#include <cstring>
+
+namespace {
+
+const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr32(uint32_t x, int r) {
+    return (x >> r) | (x << (32 - r));
+}
+
+} // namespace
+
+Sha256::Sha256() {
+    reset();
+}
+
+void Sha256::reset() {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    std::memcpy(state_, initial, sizeof(state_));
+    totalLength_ = 0;
+    bufferedBytes_ = 0;
+}
+
+void Sha256::compress(uint32_t state[8], const unsigned char block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+        uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void Sha256::update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLength_ += length;
+
+    if (bufferedBytes_ > 0) {
+        size_t fill = sizeof(buffer_) - bufferedBytes_;
+        if (length < fill) {
+            std::memcpy(buffer_ + bufferedBytes_, p, length);
+            bufferedBytes_ += length;
+            return;
+        }
+        std::memcpy(buffer_ + bufferedBytes_, p, fill);
+        compress(state_, buffer_);
+        bufferedBytes_ = 0;
+        p += fill;
+        length -= fill;
+    }
+
+    while (length >= 64) {
+        compress(state_, p);
+        p += 64;
+        length -= 64;
+    }
+
+    if (length > 0) {
+        std::memcpy(buffer_, p, length);
+        bufferedBytes_ = length;
+    }
+}
+
+Sha256::Digest Sha256::digest() const {
+    uint32_t state[8];
+    std::memcpy(state, state_, sizeof(state));
+
+    // Pad with 0x80, zeros, then the bit length as a big-endian 64-bit value
+    unsigned char tail[128] = {0};
+    std::memcpy(tail, buffer_, bufferedBytes_);
+    tail[bufferedBytes_] = 0x80;
+    size_t tailLength = (bufferedBytes_ < 56) ? 64 : 128;
+    uint64_t bitLength = totalLength_ * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tailLength - 1 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+    }
+    compress(state, tail);
+    if (tailLength == 128) {
+        compress(state, tail + 64);
+    }
+
+    Digest result;
+    for (int i = 0; i < 8; i++) {
+        result[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        result[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        result[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        result[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return result;
+}
+
+Sha256::Digest Sha256::hash(const void* data, size_t length) {
+    Sha256 hasher;
+    hasher.update(data, length);
+    return hasher.digest();
+}
+
+std::string Sha256::toHex(const Digest& digest) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(digest.size() * 2);
+    for (uint8_t byte : digest) {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0xF]);
+    }
+    return hex;
+}
@@ -0,0 +1,127 @@
+#include "../../include/io/AccessHints.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+uint64_t pageSize() {
+    static const uint64_t size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// madvise needs a page-aligned start
+void adviseMapping(const void* address, uint64_t length, int advice) {
+    if (!address || length == 0) {
+        return;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(address);
+    uintptr_t aligned = start & ~static_cast<uintptr_t>(pageSize() - 1);
+    madvise(reinterpret_cast<void*>(aligned), length + (start - aligned), advice);
+}
+
+} // namespace
+#endif
+
+namespace AccessHints {
+
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+void sequential(int fd) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+void willNeed(int fd, uint64_t offset, uint64_t length) {
+    posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+}
+
+void dontNeed(int fd, uint64_t offset, uint64_t length) {
+    posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+}
+#else
+void sequential(int) {}
+void willNeed(int, uint64_t, uint64_t) {}
+void dontNeed(int, uint64_t, uint64_t) {}
+#endif
+
+#ifndef _WIN32
+void mappedWillNeed(const void* address, uint64_t length) {
+    adviseMapping(address, length, MADV_WILLNEED);
+}
+
+void mappedSequential(const void* address, uint64_t length) {
+    adviseMapping(address, length, MADV_SEQUENTIAL);
+}
+#else
+void mappedWillNeed(const void*, uint64_t) {}
+void mappedSequential(const void*, uint64_t) {}
+#endif
+
+} // namespace AccessHints
+
+CacheFootprint::CacheFootprint(int fd, uint64_t size) : fd_(fd), size_(size) {
+    valid_ = snapshot(fd, size, resident_);
+}
+
+void CacheFootprint::release() {
+    // Without a snapshot nothing is known to be ours, so nothing is dropped
+    if (!valid_) {
+        return;
+    }
+#ifndef _WIN32
+    // Drop runs of pages that were not cached before
+    const uint64_t page = pageSize();
+    size_t count = resident_.size();
+    size_t i = 0;
+    while (i < count) {
+        if (resident_[i] & 1) {
+            i++;
+            continue;
+        }
+        size_t run = i;
+        while (run < count && !(resident_[run] & 1)) {
+            run++;
+        }
+        AccessHints::dontNeed(fd_, i * page, (run - i) * page);
+        i = run;
+    }
+#endif
+    valid_ = false;
+}
+
+uint64_t CacheFootprint::residentPages(int fd, uint64_t size) {
+    std::vector<unsigned char> pages;
+    if (!snapshot(fd, size, pages)) {
+        return 0;
+    }
+    uint64_t resident = 0;
+    for (unsigned char page : pages) {
+        resident += page & 1;
+    }
+    return resident;
+}
+
+bool CacheFootprint::snapshot(int fd, uint64_t size, std::vector<unsigned char>& pages) {
+#ifndef _WIN32
+    if (size == 0) {
+        return false;
+    }
+    // Mapping without touching the pages does not change what is cached
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    pages.assign((size + pageSize() - 1) / pageSize(), 0);
+    bool ok = mincore(mapping, size, pages.data()) == 0;
+    munmap(mapping, size);
+    return ok;
+#else
+    (void)fd;
+    (void)size;
+    (void)pages;
+    return false;
+#endif
+}
@@ -0,0 +1,342 @@
+#include "../../include/io/PathResolver.h"
+#include "../../include/FileSystem.h"
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#if defined(SYS_openat2) && __has_include(<linux/openat2.h>)
+#define PATHRESOLVER_OPENAT2
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <linux/openat2.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+const int PathResolver::MAX_LINKS;
+
+#ifdef PATHRESOLVER_OPENAT2
+
+PathResolver::~PathResolver() {
+    clear();
+    if (cwdFd_ >= 0) {
+        close(cwdFd_);
+    }
+}
+
+bool PathResolver::resolve(const std::string& current, const std::string& target, std::string& resolved) {
+    if (target.empty()) {
+        return false;
+    }
+
+    if (!unsupported_) {
+        readEvents();
+
+        std::string path = target;
+        if (target == "~" || target.compare(0, 2, "~/") == 0) {
+            const char* home = getenv("HOME");
+            if (!home || !*home) {
+                return false;
+            }
+            path = home + target.substr(1);
+        }
+
+        std::string base = "/";
+        Lookup found = Lookup::FOUND;
+        if (path[0] != '/') {
+            found = enter(current);
+            base = cwdCanonical_;
+        }
+        std::string canonical;
+        int fd = -1;
+        if (found == Lookup::FOUND) {
+            found = open(base, path, canonical, fd);
+        }
+        if (found == Lookup::FOUND) {
+            hold(fd, canonical, canonical);
+            resolved = canonical;
+            return true;
+        }
+        if (found == Lookup::MISSING) {
+            return false;
+        }
+    }
+
+    // No openat2() or inotify, or a current directory that is not an absolute path
+    std::string path = current;
+    if (!FileSystem::changeDirectory(path, target)) {
+        return false;
+    }
+    resolved = path;
+    return true;
+}
+
+void PathResolver::clear() {
+    links_.clear();
+    // Closing the inotify instance drops its watches as well
+    if (notifyFd_ >= 0) {
+        close(notifyFd_);
+        notifyFd_ = -1;
+    }
+}
+
+PathResolver::Lookup PathResolver::enter(const std::string& current) {
+    if (current == cwdPath_ && (cwdFd_ >= 0 || textOnly_)) {
+        if (cwdFd_ >= 0 && !stillNamed()) {
+            // Renamed or deleted: the caller means the path, not where the
+            // directory went, so look up from the text from now on
+            close(cwdFd_);
+            cwdFd_ = -1;
+            textOnly_ = true;
+        }
+        return Lookup::FOUND;
+    }
+    textOnly_ = false;
+    if (cwdFd_ >= 0) {
+        close(cwdFd_);
+        cwdFd_ = -1;
+    }
+    if (current.empty() || current[0] != '/') {
+        return Lookup::UNSUPPORTED;
+    }
+    std::string canonical;
+    int fd = -1;
+    Lookup found = open("/", current, canonical, fd);
+    if (found == Lookup::FOUND) {
+        hold(fd, current, canonical);
+    }
+    return found;
+}
+
+PathResolver::Lookup PathResolver::open(const std::string& base, const std::string& path, std::string& canonical,
+                                        int& fd) {
+    bool retried = false;
+    for (int links = 0; links <= MAX_LINKS; links++) {
+        // Build the canonical path from the text, rewriting cached links as
+        // they are reached; only its final lookup touches the file system
+        std::string candidate = base;
+        bool unverified = false; // Names appended since the last lookup
+        bool usedCache = false;
+        Lookup found = Lookup::FOUND;
+        fd = -1;
+        size_t pos = 0;
+        while (found == Lookup::FOUND && pos < path.size()) {
+            size_t slash = path.find('/', pos);
+            if (slash == std::string::npos) {
+                slash = path.size();
+            }
+            std::string part = path.substr(pos, slash - pos);
+            pos = slash + 1;
+            if (part.empty() || part == ".") {
+                continue;
+            }
+            if (part == "..") {
+                // Dropping the last name is only right if it was not an
+                // uncached symlink, so check the path up to here first
+                if (unverified) {
+                    found = openCanonical(candidate, fd);
+                    if (found == Lookup::FOUND) {
+                        close(fd);
+                        fd = -1;
+                        unverified = false;
+                    }
+                }
+                if (found == Lookup::FOUND) {
+                    size_t last = candidate.find_last_of('/');
+                    candidate.erase(last == 0 ? 1 : last);
+                }
+                continue;
+            }
+            candidate += candidate.size() == 1 ? part : "/" + part;
+            unverified = true;
+            auto link = links_.find(candidate);
+            if (link != links_.end()) {
+                candidate = link->second;
+                usedCache = true;
+            }
+        }
+        if (found == Lookup::FOUND) {
+            found = openCanonical(candidate, fd);
+        }
+        if (found == Lookup::FOUND) {
+            canonical = candidate;
+            return Lookup::FOUND;
+        }
+        if (found == Lookup::UNSUPPORTED) {
+            return found;
+        }
+
+        if (errno == ELOOP) {
+            // A symlink that is not cached yet; resolve it and go again
+            found = cacheFirstLink(candidate);
+            if (found != Lookup::FOUND) {
+                return found;
+            }
+        } else if (usedCache && !retried) {
+            // A cached link may be stale in a way the watch did not see
+            clear();
+            retried = true;
+        } else {
+            return Lookup::MISSING;
+        }
+    }
+    errno = ELOOP;
+    return Lookup::MISSING;
+}
+
+// Path relative to the held directory where it lies inside it, so the
+// lookup does not walk the components leading there again
+static const char* relativeTo(const std::string& path, int cwdFd, const std::string& cwdCanonical, int& dirFd) {
+    dirFd = AT_FDCWD;
+    if (cwdFd < 0) {
+        return path.c_str();
+    }
+    if (path == cwdCanonical) {
+        dirFd = cwdFd;
+        return ".";
+    }
+    size_t prefix = cwdCanonical.size() == 1 ? 1 : cwdCanonical.size() + 1;
+    if (path.size() > prefix && path.compare(0, cwdCanonical.size(), cwdCanonical) == 0 &&
+        path[prefix - 1] == '/') {
+        dirFd = cwdFd;
+        return path.c_str() + prefix;
+    }
+    return path.c_str();
+}
+
+PathResolver::Lookup PathResolver::openCanonical(const std::string& canonical, int& fd) {
+    int dirFd;
+    const char* name = relativeTo(canonical, cwdFd_, cwdCanonical_, dirFd);
+    struct open_how how = {};
+    how.flags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+    how.resolve = RESOLVE_NO_SYMLINKS;
+    lookups_++;
+    fd = static_cast<int>(syscall(SYS_openat2, dirFd, name, &how, sizeof(how)));
+    if (fd >= 0) {
+        return Lookup::FOUND;
+    }
+    if (errno == ENOSYS) {
+        unsupported_ = true;
+        return Lookup::UNSUPPORTED;
+    }
+    return Lookup::MISSING;
+}
+
+PathResolver::Lookup PathResolver::cacheFirstLink(const std::string& path) {
+    // Components up to the held directory are known not to be links
+    int dirFd;
+    const char* name = relativeTo(path, cwdFd_, cwdCanonical_, dirFd);
+    size_t skip = 1;
+    if (dirFd != AT_FDCWD && path != cwdCanonical_) {
+        skip = name - path.c_str();
+    } else {
+        dirFd = AT_FDCWD;
+    }
+
+    size_t pos = skip;
+    while (pos < path.size()) {
+        size_t slash = path.find('/', pos);
+        if (slash == std::string::npos) {
+            slash = path.size();
+        }
+        std::string prefix = path.substr(0, slash);
+        pos = slash + 1;
+
+        struct stat st;
+        lookups_++;
+        if (fstatat(dirFd, dirFd == AT_FDCWD ? prefix.c_str() : prefix.c_str() + skip, &st,
+                    AT_SYMLINK_NOFOLLOW) != 0) {
+            return Lookup::MISSING;
+        }
+        if (!S_ISLNK(st.st_mode)) {
+            continue;
+        }
+
+        char target[PATH_MAX];
+        lookups_++;
+        if (realpath(prefix.c_str(), target) == nullptr) {
+            return Lookup::MISSING;
+        }
+        size_t last = prefix.find_last_of('/');
+        if (!watch(last == 0 ? "/" : prefix.substr(0, last))) {
+            return Lookup::UNSUPPORTED;
+        }
+        links_[prefix] = target;
+        return Lookup::FOUND;
+    }
+    // The link was replaced while we looked
+    errno = ELOOP;
+    return Lookup::MISSING;
+}
+
+bool PathResolver::watch(const std::string& directory) {
+    if (notifyFd_ < 0) {
+        notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notifyFd_ < 0) {
+            unsupported_ = true;
+            return false;
+        }
+    }
+    lookups_++;
+    return inotify_add_watch(notifyFd_, directory.c_str(),
+                             IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                 IN_MOVE_SELF | IN_ONLYDIR) >= 0;
+}
+
+void PathResolver::readEvents() {
+    if (notifyFd_ < 0) {
+        return;
+    }
+    // Which link changed does not matter; any change drops them all
+    char buffer[4096];
+    bool changed = false;
+    while (read(notifyFd_, buffer, sizeof(buffer)) > 0) {
+        changed = true;
+    }
+    if (changed) {
+        clear();
+    }
+}
+
+bool PathResolver::stillNamed() const {
+    // The kernel's name for the open directory, kept up to date through
+    // renames of it or any parent; no lookup on the file system itself
+    char name[PATH_MAX];
+    std::string link = "/proc/self/fd/" + std::to_string(cwdFd_);
+    ssize_t length = readlink(link.c_str(), name, sizeof(name));
+    return length > 0 && cwdCanonical_.compare(0, std::string::npos, name, length) == 0;
+}
+
+void PathResolver::hold(int fd, const std::string& path, const std::string& canonical) {
+    if (fd != cwdFd_ && cwdFd_ >= 0) {
+        close(cwdFd_);
+    }
+    cwdFd_ = fd;
+    cwdPath_ = path;
+    cwdCanonical_ = canonical;
+    textOnly_ = false;
+}
+
+#else
+
+PathResolver::~PathResolver() {
+}
+
+bool PathResolver::resolve(const std::string& current, const std::string& target, std::string& resolved) {
+    std::string path = current;
+    lookups_++;
+    if (!FileSystem::changeDirectory(path, target)) {
+        return false;
+    }
+    resolved = path;
+    return true;
+}
+
+void PathResolver::clear() {
+    links_.clear();
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include "../../include/listing/DirectoryLoader.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+constexpr std::chrono::milliseconds DirectoryLoader::DEFAULT_TIMEOUT;
+
+DirectoryLoader::DirectoryLoader(std::chrono::milliseconds timeout, Lister lister)
+    : timeout_(timeout), lister_(std::move(lister)), shared_(std::make_shared<Shared>()) {
+    if (!lister_) {
+        lister_ = [](const std::string& path, const std::atomic<bool>* cancelled) {
+            return FileSystem::listDirectory(path, cancelled);
+        };
+    }
+}
+
+DirectoryLoader::~DirectoryLoader() {
+    cancel();
+}
+
+uint64_t DirectoryLoader::request(const std::string& path) {
+    cancel();
+
+    uint64_t id = ++nextRequest_;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->current = id;
+        shared_->ready = false;
+    }
+    cancelled_ = cancelled;
+    state_ = State::LOADING;
+    path_ = path;
+    started_ = std::chrono::steady_clock::now();
+
+    // The thread holds its own references, so it can finish after the loader is gone
+    std::shared_ptr<Shared> shared = shared_;
+    Lister lister = lister_;
+    std::thread([shared, cancelled, lister, path, id] {
+        Result result;
+        result.request = id;
+        result.path = path;
+        try {
+            result.entries = lister(path, cancelled.get());
+            result.state = State::DONE;
+        } catch (const std::exception& ex) {
+            result.state = State::FAILED;
+            result.error = ex.what();
+        }
+        if (*cancelled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (shared->current == id) {
+            shared->result = std::move(result);
+            shared->ready = true;
+            shared->finished.notify_all();
+        }
+    }).detach();
+    return id;
+}
+
+void DirectoryLoader::cancel() {
+    if (cancelled_) {
+        *cancelled_ = true;
+        cancelled_.reset();
+    }
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->current = 0;
+    shared_->ready = false;
+    if (state_ == State::LOADING) {
+        state_ = State::IDLE;
+    }
+}
+
+bool DirectoryLoader::poll(Result& result, std::chrono::milliseconds wait) {
+    if (state_ != State::LOADING) {
+        return false;
+    }
+    {
+        std::unique_lock<std::mutex> lock(shared_->mutex);
+        shared_->finished.wait_for(lock, std::min(wait, timeout_ - elapsed()), [&] { return shared_->ready; });
+        if (shared_->ready) {
+            result = std::move(shared_->result);
+            shared_->ready = false;
+            shared_->current = 0;
+            state_ = result.state;
+            cancelled_.reset();
+            return true;
+        }
+    }
+    if (elapsed() < timeout_) {
+        return false;
+    }
+
+    // Give up on it; the worker is left to finish (or hang) on its own
+    uint64_t id = nextRequest_;
+    cancel();
+    state_ = State::TIMED_OUT;
+    result = Result();
+    result.request = id;
+    result.path = path_;
+    result.state = State::TIMED_OUT;
+    char message[64];
+    snprintf(message, sizeof(message), "No response after %.1f s", timeout_.count() / 1000.0);
+    result.error = message;
+    return true;
+}
+
+DirectoryLoader::State DirectoryLoader::state() const {
+    return state_;
+}
+
+const std::string& DirectoryLoader::path() const {
+    return path_;
+}
+
+std::chrono::milliseconds DirectoryLoader::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_);
+}
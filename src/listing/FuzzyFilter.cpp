@@ -0,0 +1,300 @@
+#include "../../include/listing/FuzzyFilter.h"
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define FUZZYFILTER_USE_SSE2 1
+#endif
+
+const size_t FuzzyFilter::RANK_TOP;
+
+namespace {
+
+// Bytes after the last name, so 16-byte loads never leave the buffer
+const size_t PADDING = 16;
+// Candidates preselected for full scoring, per ranked slot
+const size_t RANK_POOL_FACTOR = 4;
+// Match starts tried when scoring a name
+const int MAX_ANCHORS = 8;
+
+inline char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Marks a first-character match whose position has not been looked up
+const uint32_t UNRESOLVED = 0xffffffff;
+
+// One bit per letter, digit and common separator; other bytes share the rest
+inline uint64_t charBit(unsigned char c) {
+    if (c >= 'a' && c <= 'z') {
+        return 1ULL << (c - 'a');
+    }
+    if (c >= '0' && c <= '9') {
+        return 1ULL << (26 + c - '0');
+    }
+    switch (c) {
+        case '.': return 1ULL << 36;
+        case '_': return 1ULL << 37;
+        case '-': return 1ULL << 38;
+        case ' ': return 1ULL << 39;
+        default: return 1ULL << (40 + c % 24);
+    }
+}
+
+// First position >= from holding c, or length if there is none
+inline size_t findChar(const char* name, size_t from, size_t length, char c) {
+#ifdef FUZZYFILTER_USE_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    for (size_t pos = from; pos < length; pos += 16) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(name + pos)), needle)));
+        if (mask != 0) {
+            size_t hit = pos + __builtin_ctz(mask);
+            return hit < length ? hit : length;
+        }
+    }
+    return length;
+#else
+    const void* hit = from < length ? memchr(name + from, c, length - from) : nullptr;
+    return hit ? static_cast<const char*>(hit) - name : length;
+#endif
+}
+
+// Whether charBit(c) is set only by c itself
+inline bool hasOwnBit(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-' || c == ' ';
+}
+
+inline bool isBoundary(char c) {
+    return c == '.' || c == '_' || c == '-' || c == ' ' || c == '/';
+}
+
+} // namespace
+
+FuzzyFilter::FuzzyFilter(size_t rankTop) : rankTop_(rankTop) {
+    clear();
+}
+
+void FuzzyFilter::clear() {
+    text_.assign(PADDING, '\0');
+    starts_.assign(1, 0);
+    masks_.clear();
+    query_.clear();
+    levels_.clear();
+    depth_ = 0;
+    matches_.clear();
+}
+
+void FuzzyFilter::add(const std::string& name) {
+    text_.resize(text_.size() - PADDING);
+    uint64_t mask = 0;
+    for (char c : name) {
+        char folded = fold(c);
+        text_ += folded;
+        mask |= charBit(static_cast<unsigned char>(folded));
+    }
+    text_.append(PADDING, '\0');
+    starts_.push_back(static_cast<uint32_t>(text_.size() - PADDING));
+    masks_.push_back(mask);
+    matches_.push_back(static_cast<uint32_t>(masks_.size() - 1));
+}
+
+size_t FuzzyFilter::size() const {
+    return masks_.size();
+}
+
+void FuzzyFilter::setQuery(const std::string& query) {
+    std::string folded(query);
+    std::transform(folded.begin(), folded.end(), folded.begin(), fold);
+
+    // Keep the candidate sets of the longest common prefix
+    size_t common = 0;
+    while (common < folded.size() && common < query_.size() && folded[common] == query_[common]) {
+        common++;
+    }
+    depth_ = std::min(depth_, common);
+    query_ = folded;
+    while (depth_ < query_.size()) {
+        extend(depth_++);
+    }
+    rank();
+}
+
+const std::string& FuzzyFilter::query() const {
+    return query_;
+}
+
+const std::vector<uint32_t>& FuzzyFilter::matches() const {
+    return matches_;
+}
+
+// Candidates for query_[0..depth] from those for one character less
+void FuzzyFilter::extend(size_t depth) {
+    char c = query_[depth];
+    uint64_t bit = charBit(static_cast<unsigned char>(c));
+    const char* text = text_.data();
+    if (levels_.size() <= depth) {
+        levels_.resize(depth + 1);
+    }
+    Level& level = levels_[depth];
+    size_t limit = depth == 0 ? masks_.size() : levels_[depth - 1].count;
+    if (level.candidates.size() < limit + 1) {
+        level.candidates.resize(limit + 1);
+    }
+    Candidate* out = level.candidates.data();
+    size_t count = 0;
+
+    if (depth == 0 && hasOwnBit(static_cast<unsigned char>(c))) {
+        // The mask alone decides; where in the name the character is is only
+        // looked up if the query grows. Written unconditionally, since the
+        // outcome is unpredictable from one name to the next.
+        for (uint32_t i = 0; i < masks_.size(); i++) {
+            out[count] = {i, 0, UNRESOLVED};
+            count += (masks_[i] & bit) != 0;
+        }
+    } else if (depth == 0) {
+        for (uint32_t i = 0; i < masks_.size(); i++) {
+            if (!(masks_[i] & bit)) {
+                continue;
+            }
+            size_t length = starts_[i + 1] - starts_[i];
+            size_t hit = findChar(text + starts_[i], 0, length, c);
+            if (hit < length) {
+                out[count++] = {i, static_cast<uint32_t>(hit), static_cast<uint32_t>(hit + 1)};
+            }
+        }
+    } else {
+        const Level& previous = levels_[depth - 1];
+        for (size_t k = 0; k < previous.count; k++) {
+            const Candidate& candidate = previous.candidates[k];
+            if (!(masks_[candidate.index] & bit)) {
+                continue;
+            }
+            const char* name = text + starts_[candidate.index];
+            size_t length = starts_[candidate.index + 1] - starts_[candidate.index];
+            uint32_t first = candidate.first;
+            size_t from = candidate.next;
+            if (from == UNRESOLVED) {
+                first = static_cast<uint32_t>(findChar(name, 0, length, query_[0]));
+                from = first + 1;
+            }
+            size_t hit = findChar(name, from, length, c);
+            if (hit < length) {
+                out[count++] = {candidate.index, first, static_cast<uint32_t>(hit + 1)};
+            }
+        }
+    }
+    level.count = count;
+}
+
+void FuzzyFilter::rank() {
+    matches_.clear();
+    if (query_.empty()) {
+        for (uint32_t i = 0; i < masks_.size(); i++) {
+            matches_.push_back(i);
+        }
+        return;
+    }
+    const Candidate* candidates = levels_[depth_ - 1].candidates.data();
+    size_t candidateCount = levels_[depth_ - 1].count;
+
+    // Preselect by match span, then length: a bounded max-heap of the best
+    // positions seen so far. Unresolved single-character matches count as
+    // starting at 0.
+    size_t poolSize = std::min(candidateCount, rankTop_ * RANK_POOL_FACTOR);
+    auto key = [&](uint32_t position) {
+        const Candidate& candidate = candidates[position];
+        uint64_t span = candidate.next == UNRESOLVED ? 1 : candidate.next - candidate.first;
+        uint64_t length = starts_[candidate.index + 1] - starts_[candidate.index];
+        return (span << 40) | (length << 20) | std::min<uint64_t>(candidate.first, 0xfffff);
+    };
+    std::priority_queue<std::pair<uint64_t, uint32_t>> pool;
+    for (uint32_t position = 0; position < candidateCount; position++) {
+        if (pool.size() < poolSize) {
+            pool.emplace(key(position), position);
+        } else if (poolSize > 0) {
+            uint64_t k = key(position);
+            if (k < pool.top().first) {
+                pool.pop();
+                pool.emplace(k, position);
+            }
+        }
+    }
+
+    // Full scores for the pool only
+    std::vector<std::pair<int, uint32_t>> scored;
+    scored.reserve(pool.size());
+    while (!pool.empty()) {
+        uint32_t position = pool.top().second;
+        pool.pop();
+        const Candidate& candidate = candidates[position];
+        size_t length = starts_[candidate.index + 1] - starts_[candidate.index];
+        scored.emplace_back(-score(text_.data() + starts_[candidate.index], length, query_), position);
+    }
+    std::sort(scored.begin(), scored.end());
+    if (scored.size() > rankTop_) {
+        scored.resize(rankTop_);
+    }
+
+    std::vector<uint32_t> ranked;
+    ranked.reserve(scored.size());
+    for (const auto& entry : scored) {
+        matches_.push_back(candidates[entry.second].index);
+        ranked.push_back(entry.second);
+    }
+    std::sort(ranked.begin(), ranked.end());
+
+    matches_.reserve(candidateCount);
+    auto skip = ranked.begin();
+    for (uint32_t position = 0; position < candidateCount; position++) {
+        if (skip != ranked.end() && *skip == position) {
+            ++skip;
+            continue;
+        }
+        matches_.push_back(candidates[position].index);
+    }
+}
+
+// Rewards matches at the start, after separators and in runs; penalises
+// spread-out matches and long names. Tries several places for the first
+// character, since the leftmost is not always the best.
+int FuzzyFilter::score(const char* folded, size_t length, const std::string& foldedQuery) {
+    if (foldedQuery.empty()) {
+        return 0;
+    }
+    int best = -(1 << 30);
+    size_t anchor = findChar(folded, 0, length, foldedQuery[0]);
+    for (int tries = 0; anchor < length && tries < MAX_ANCHORS; tries++) {
+        int total = 0;
+        size_t pos = anchor;
+        size_t previous = anchor;
+        bool matched = true;
+        for (size_t j = 0; j < foldedQuery.size(); j++) {
+            if (j > 0) {
+                pos = findChar(folded, previous + 1, length, foldedQuery[j]);
+                if (pos >= length) {
+                    matched = false;
+                    break;
+                }
+                if (pos == previous + 1) {
+                    total += 12;
+                }
+            }
+            if (pos == 0) {
+                total += 15;
+            } else if (isBoundary(folded[pos - 1])) {
+                total += 8;
+            }
+            previous = pos;
+        }
+        if (!matched) {
+            break; // Later anchors cannot match either
+        }
+        total -= static_cast<int>(previous - anchor);
+        best = std::max(best, total);
+        anchor = findChar(folded, anchor + 1, length, foldedQuery[0]);
+    }
+    return best - static_cast<int>(length / 8);
+}
@@ -0,0 +1,145 @@
+#include "../../include/listing/ListingPrefetcher.h"
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+constexpr std::chrono::milliseconds ListingPrefetcher::DEFAULT_DELAY;
+constexpr std::chrono::milliseconds ListingPrefetcher::DEFAULT_STALL_TIMEOUT;
+const size_t ListingPrefetcher::MAX_ABANDONED;
+
+namespace {
+
+// Lowest I/O and CPU priority for the calling thread; best effort
+void lowerPriority() {
+#if defined(__linux__) && defined(SYS_ioprio_set)
+    const int whoProcess = 1;   // IOPRIO_WHO_PROCESS; with id 0, the calling thread
+    const int classIdle = 3;    // IOPRIO_CLASS_IDLE
+    const int classShift = 13;  // IOPRIO_CLASS_SHIFT
+    syscall(SYS_ioprio_set, whoProcess, 0, classIdle << classShift);
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+}
+
+} // namespace
+
+ListingPrefetcher::ListingPrefetcher(SnapshotCache& cache, std::chrono::milliseconds delay, Lister lister,
+                                     std::chrono::milliseconds stallTimeout)
+    : shared_(std::make_shared<Shared>()), stallTimeout_(stallTimeout) {
+    shared_->cache = &cache;
+    shared_->delay = delay;
+    shared_->lister = std::move(lister);
+    if (!shared_->lister) {
+        shared_->lister = [](const std::string& path, const std::atomic<bool>* cancelled) {
+            return FileSystem::listDirectory(path, cancelled);
+        };
+    }
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    startWorker();
+}
+
+ListingPrefetcher::~ListingPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->cache = nullptr;
+        if (shared_->cancelled) {
+            *shared_->cancelled = true;
+        }
+    }
+    shared_->changed.notify_all();
+}
+
+void ListingPrefetcher::hint(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        if (path == shared_->target) {
+            return;
+        }
+        shared_->target = path;
+        shared_->hinted = std::chrono::steady_clock::now();
+        if (shared_->cancelled) {
+            *shared_->cancelled = true; // Whatever is being read is no longer wanted
+        }
+
+        // A worker stuck in a read (a hung mount) would keep every later
+        // directory from being read ahead; leave it behind
+        if (shared_->reading && shared_->hinted - shared_->readStarted > stallTimeout_ &&
+            shared_->abandoned < MAX_ABANDONED) {
+            try {
+                startWorker();
+                shared_->abandoned++;
+                shared_->reading = false;
+            } catch (const std::system_error&) {
+                // Out of threads: keep waiting for the stuck one
+            }
+        }
+    }
+    shared_->changed.notify_all();
+}
+
+uint64_t ListingPrefetcher::completed() const {
+    return shared_->completed;
+}
+
+// Called with the mutex held, so the new worker only looks at its id once it is set
+void ListingPrefetcher::startWorker() {
+    uint64_t id = shared_->worker + 1;
+    std::shared_ptr<Shared> shared = shared_;
+    std::thread([shared, id] { run(shared, id); }).detach();
+    shared_->worker = id;
+}
+
+void ListingPrefetcher::run(std::shared_ptr<Shared> shared, uint64_t id) {
+    lowerPriority();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    while (shared->cache && shared->worker == id) {
+        if (shared->target.empty() || shared->cache->contains(shared->target)) {
+            shared->changed.wait(lock);
+            continue;
+        }
+        // Wait for the cursor to settle
+        auto due = shared->hinted + shared->delay;
+        if (std::chrono::steady_clock::now() < due) {
+            shared->changed.wait_until(lock, due);
+            continue;
+        }
+
+        std::string path = shared->target;
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        shared->cancelled = cancelled;
+        shared->reading = true;
+        shared->readStarted = std::chrono::steady_clock::now();
+        Lister lister = shared->lister;
+        lock.unlock();
+        std::vector<FileInfo> entries;
+        bool ok = true;
+        try {
+            entries = lister(path, cancelled.get());
+        } catch (const std::runtime_error&) {
+            ok = false;
+        }
+        lock.lock();
+
+        if (shared->worker != id) {
+            shared->abandoned--; // Replaced while stalled
+            return;
+        }
+        shared->reading = false;
+        if (*cancelled || !shared->cache) {
+            continue; // Cursor moved, or shutting down; the listing may be partial
+        }
+        if (ok) {
+            shared->cache->put(path, entries);
+            shared->completed++;
+        }
+        if (shared->target == path) {
+            shared->target.clear(); // Done, or unreadable: do not retry until hinted again
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include "../../include/listing/SnapshotCache.h"
+
+const size_t SnapshotCache::DEFAULT_CAPACITY;
+
+SnapshotCache::SnapshotCache(size_t capacityBytes) : capacity_(capacityBytes) {}
+
+void SnapshotCache::put(const std::string& path, const std::vector<FileInfo>& entries) {
+    size_t bytes = footprint(entries) + path.capacity();
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(path);
+    if (bytes > capacity_) {
+        return; // Would evict everything else and still not fit
+    }
+    lru_.push_front(path);
+    Snapshot& snapshot = snapshots_[path];
+    snapshot.entries = entries;
+    snapshot.bytes = bytes;
+    snapshot.position = lru_.begin();
+    bytes_ += bytes;
+    evict();
+}
+
+bool SnapshotCache::get(const std::string& path, std::vector<FileInfo>& entries) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = snapshots_.find(path);
+    if (it == snapshots_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, it->second.position);
+    entries = it->second.entries;
+    return true;
+}
+
+bool SnapshotCache::contains(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshots_.count(path) > 0;
+}
+
+void SnapshotCache::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(path);
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) {
+        erase(slash == 0 ? "/" : path.substr(0, slash));
+    }
+}
+
+void SnapshotCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshots_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+size_t SnapshotCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshots_.size();
+}
+
+size_t SnapshotCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t SnapshotCache::capacity() const {
+    return capacity_;
+}
+
+uint64_t SnapshotCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t SnapshotCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t SnapshotCache::footprint(const std::vector<FileInfo>& entries) {
+    size_t bytes = entries.size() * sizeof(FileInfo);
+    for (const auto& entry : entries) {
+        // Short names live inside the string itself
+        if (entry.getName().capacity() > 15) {
+            bytes += entry.getName().capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+void SnapshotCache::evict() {
+    while (bytes_ > capacity_ && !lru_.empty()) {
+        std::string oldest = lru_.back();
+        erase(oldest);
+    }
+}
+
+void SnapshotCache::erase(const std::string& path) {
+    auto it = snapshots_.find(path);
+    if (it == snapshots_.end()) {
+        return;
+    }
+    bytes_ -= it->second.bytes;
+    lru_.erase(it->second.position);
+    snapshots_.erase(it);
+}
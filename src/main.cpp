@@ -1,20 +1,25 @@
 #include "cli/CommandLineInterface.h"
 #include "bookmark/BookMark.h"
+#include "cli/StartupTrace.h"
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unistd.h>
 
-int main(int argc, char* argv[]) {
+static int run(int argc, char* argv[]) {
     // Check for non-interactive commands
     if (argc > 1) {
-        // Load bookmarks first
-        BookMark::loadBookMarks();
-        
         std::string command = argv[1];
         
         if (command == "bookmark") {
             if (argc > 2) {
+                {
+                    StartupTrace::Phase phase("load bookmarks");
+                    BookMark::loadBookMarks();
+                }
+
                 std::string subcommand = argv[2];
                 
                 if (subcommand == "add" && argc > 3) {
@@ -48,6 +53,9 @@ int main(int argc, char* argv[]) {
                     for (const auto& bookmark : BookMark::bookMarks) {
                         std::cout << "  " << bookmark << std::endl;
                     }
+                } else if (subcommand == "check" || subcommand == "prune") {
+                    CommandLineInterface cli;
+                    cli.checkBookmarks(subcommand == "prune");
                 } else if (subcommand == "clear") {
                     if (BookMark::emptyBookMarks()) {
                         std::cout << "All bookmarks cleared." << std::endl;
@@ -55,27 +63,60 @@ int main(int argc, char* argv[]) {
                         std::cout << "No bookmarks to clear." << std::endl;
                     }
                 } else {
-                    std::cout << "Invalid bookmark command. Use 'bookmark add <path>', 'bookmark remove <path>', 'bookmark list', or 'bookmark clear'." << std::endl;
+                    std::cout << "Invalid bookmark command. Use 'bookmark add <path>', 'bookmark remove <path>', 'bookmark list', 'bookmark check', 'bookmark prune', or 'bookmark clear'." << std::endl;
                     return 1;
                 }
                 
-                // Save bookmarks after modification
+                // Only changes are written; list writes nothing
+                StartupTrace::Phase phase("save bookmarks");
                 BookMark::saveBookMarks();
                 return 0;
             } else {
-                std::cout << "Usage: " << argv[0] << " bookmark [add|remove|list|clear] [path]" << std::endl;
+                std::cout << "Usage: " << argv[0] << " bookmark [add|remove|list|check|prune|clear] [path]" << std::endl;
                 return 1;
             }
+        } else if (command == "dupes") {
+            CommandLineInterface cli;
+            StartupTrace::Phase phase("dupes");
+            cli.findDuplicates(argc > 2 ? argv[2] : "");
+            return 0;
+        } else if (command == "hash") {
+            CommandLineInterface cli;
+            StartupTrace::Phase phase("hash");
+            return cli.hashPaths(std::vector<std::string>(argv + 2, argv + argc)) ? 0 : 1;
         } else {
             std::cout << "Unknown command: " << command << std::endl;
-            std::cout << "Available non-interactive commands: bookmark" << std::endl;
+            std::cout << "Available non-interactive commands: bookmark, dupes, hash" << std::endl;
             return 1;
         }
     }
     
     // Start interactive mode
-    CommandLineInterface cli;
-    cli.start();
+    std::unique_ptr<CommandLineInterface> cli;
+    {
+        StartupTrace::Phase phase("create interface");
+        cli.reset(new CommandLineInterface());
+    }
+    // Startup ends at the first prompt
+    StartupTrace::report();
+    cli->start();
     
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    // --startup-trace prints how long each startup phase took; it is taken
+    // out of the arguments wherever it appears
+    std::vector<char*> args(argv, argv + argc + 1); // With the terminating null
+    for (auto it = args.begin() + 1; *it; ++it) {
+        if (strcmp(*it, "--startup-trace") == 0) {
+            StartupTrace::enable();
+            args.erase(it);
+            break;
+        }
+    }
+    
+    int status = run(static_cast<int>(args.size()) - 1, args.data());
+    StartupTrace::report();
+    return status;
+}
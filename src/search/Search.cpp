@@ -1,8 +1,21 @@
 #include "../../include/search/Search.h"
+#include "../../include/io/AccessHints.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <queue>
+#include <set>
+#include <utility>
 #include <filesystem>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 std::vector<std::string> Search::searchByName(const std::string& directory, const std::string& pattern, bool recursive) {
     std::vector<std::string> results;
@@ -12,16 +25,11 @@ std::vector<std::string> Search::searchByName(const std::string& directory, cons
         searchByNameRecursive(directory, regexPattern, results);
     } else {
         // Non-recursive search in single directory
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
-                std::string filename = entry.path().filename().string();
-                if (std::regex_search(filename, regexPattern)) {
-                    results.push_back(entry.path().string());
-                }
+        walk(directory, false, [&](const std::string& path, const FileInfo& info) {
+            if (std::regex_search(info.getName(), regexPattern)) {
+                results.push_back(path);
             }
-        } catch (const std::filesystem::filesystem_error& ex) {
-            std::cerr << "Error accessing directory: " << ex.what() << std::endl;
-        }
+        });
     }
     
     return results;
@@ -34,82 +42,121 @@ std::vector<std::string> Search::searchByContent(const std::string& directory, c
         searchByContentRecursive(directory, pattern, results);
     } else {
         // Non-recursive search in single directory
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
-                if (entry.is_regular_file()) {
-                    std::ifstream file(entry.path());
-                    std::string line;
-                    bool found = false;
-                    
-                    while (std::getline(file, line) && !found) {
-                        if (line.find(pattern) != std::string::npos) {
-                            results.push_back(entry.path().string());
-                            found = true;
-                        }
-                    }
-                }
+        walk(directory, false, [&](const std::string& path, const FileInfo& info) {
+            if (info.getType() == FileInfo::FileType::FILE && fileContains(path, pattern)) {
+                results.push_back(path);
             }
-        } catch (const std::filesystem::filesystem_error& ex) {
-            std::cerr << "Error accessing directory: " << ex.what() << std::endl;
-        }
+        });
     }
     
     return results;
 }
 
-void Search::searchByNameRecursive(const std::string& directory, const std::regex& pattern, std::vector<std::string>& results) {
+void Search::walk(const std::string& directory, bool recursive, const Visitor& visitor) {
     std::queue<std::string> directories;
+    std::set<std::pair<uint64_t, uint64_t>> visited;
     directories.push(directory);
     
     while (!directories.empty()) {
         std::string currentDir = directories.front();
         directories.pop();
         
+        std::vector<FileInfo> entries;
         try {
-            for (const auto& entry : std::filesystem::directory_iterator(currentDir)) {
-                std::string filename = entry.path().filename().string();
-                
-                if (std::regex_search(filename, pattern)) {
-                    results.push_back(entry.path().string());
-                }
-                
-                if (entry.is_directory()) {
-                    directories.push(entry.path().string());
-                }
-            }
-        } catch (const std::filesystem::filesystem_error& ex) {
+            entries = FileSystem::listDirectory(currentDir);
+        } catch (const std::runtime_error& ex) {
             std::cerr << "Error accessing directory: " << ex.what() << std::endl;
+            continue;
+        }
+
+        std::string prefix = currentDir;
+        if (prefix.empty() || prefix.back() != '/') {
+            prefix += "/";
+        }
+        
+        for (const auto& entry : entries) {
+            std::string path = prefix + entry.getName();
+            visitor(path, entry);
+            
+            if (recursive && entry.getType() == FileInfo::FileType::DIRECTORY &&
+                visited.insert({entry.getDevice(), entry.getInode()}).second) {
+                directories.push(path);
+            }
         }
     }
 }
 
+void Search::searchByNameRecursive(const std::string& directory, const std::regex& pattern, std::vector<std::string>& results) {
+    walk(directory, true, [&](const std::string& path, const FileInfo& info) {
+        if (std::regex_search(info.getName(), pattern)) {
+            results.push_back(path);
+        }
+    });
+}
+
 void Search::searchByContentRecursive(const std::string& directory, const std::string& pattern, std::vector<std::string>& results) {
-    std::queue<std::string> directories;
-    directories.push(directory);
+    walk(directory, true, [&](const std::string& path, const FileInfo& info) {
+        if (info.getType() == FileInfo::FileType::FILE && fileContains(path, pattern)) {
+            results.push_back(path);
+        }
+    });
+}
+
+bool Search::fileContains(const std::string& path, const std::string& pattern) {
+    // Matching is per line, so a pattern spanning lines never matches
+    if (pattern.find('\n') != std::string::npos) {
+        return false;
+    }
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    // Read ahead aggressively, and afterwards drop only what this scan
+    // brought into the page cache
+    CacheFootprint footprint(fd, static_cast<uint64_t>(st.st_size));
+    AccessHints::sequential(fd);
+
+    // Keep the last pattern.size() - 1 bytes so matches across chunks are found
+    const size_t overlap = pattern.empty() ? 0 : pattern.size() - 1;
+    std::vector<char> buffer(READ_CHUNK + overlap);
+    size_t kept = 0;
+    bool found = false;
+    bool any = false;
+    while (!found) {
+        ssize_t count = read(fd, buffer.data() + kept, READ_CHUNK);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        any = true;
+        size_t length = kept + static_cast<size_t>(count);
+        found = pattern.empty() ||
+                memmem(buffer.data(), length, pattern.data(), pattern.size()) != nullptr;
+        kept = std::min(overlap, length);
+        memmove(buffer.data(), buffer.data() + length - kept, kept);
+    }
+
+    footprint.release();
+    close(fd);
+    return found && any;
+#else
+    std::ifstream file(path);
+    std::string line;
     
-    while (!directories.empty()) {
-        std::string currentDir = directories.front();
-        directories.pop();
-        
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator(currentDir)) {
-                if (entry.is_regular_file()) {
-                    std::ifstream file(entry.path());
-                    std::string line;
-                    bool found = false;
-                    
-                    while (std::getline(file, line) && !found) {
-                        if (line.find(pattern) != std::string::npos) {
-                            results.push_back(entry.path().string());
-                            found = true;
-                        }
-                    }
-                } else if (entry.is_directory()) {
-                    directories.push(entry.path().string());
-                }
-            }
-        } catch (const std::filesystem::filesystem_error& ex) {
-            std::cerr << "Error accessing directory: " << ex.what() << std::endl;
+    while (std::getline(file, line)) {
+        if (line.find(pattern) != std::string::npos) {
+            return true;
         }
     }
+    return false;
+#endif
 }
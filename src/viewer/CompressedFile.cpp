@@ -0,0 +1,675 @@
+#include "../../include/viewer/CompressedFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+const uint64_t CompressedFile::SPAN;
+const size_t CompressedFile::MAX_CHECKPOINTS;
+const uint64_t CompressedFile::LINE_STRIDE;
+const size_t CompressedFile::MAX_LINE_CHECKPOINTS;
+const uint64_t CompressedFile::BLOCK_SIZE;
+const size_t CompressedFile::CACHE_BLOCKS;
+const uint64_t CompressedFile::MAX_LINE_BYTES;
+
+// Incremental decoder over the compressed file that can be restarted at a
+// checkpoint. During the indexing pass it can also stop at the places where
+// a checkpoint may be taken.
+class StreamDecoder {
+public:
+    virtual ~StreamDecoder() = default;
+
+    virtual bool restart(const CompressedFile::Checkpoint& point) = 0;
+    // Decompress up to capacity bytes. With stopAtBoundary it returns early
+    // at a possible checkpoint, and atBoundary() is true until the next call.
+    virtual size_t read(char* out, size_t capacity, bool stopAtBoundary) = 0;
+    // Fill in the resume state for a checkpoint at the current boundary
+    virtual void checkpoint(CompressedFile::Checkpoint& point) const = 0;
+
+    bool atBoundary() const { return boundary_; }
+    bool finished() const { return finished_; }
+    bool failed() const { return failed_; }
+    uint64_t consumed() const { return consumed_; }
+
+protected:
+    explicit StreamDecoder(int fd) : fd_(fd) {}
+
+    // Refill the input buffer from the file; false at end of file
+    bool fill(const unsigned char*& next, size_t& available) {
+        ssize_t count = pread(fd_, input_, sizeof(input_), filePos_);
+        if (count <= 0) {
+            failed_ = failed_ || count < 0;
+            return false;
+        }
+        filePos_ += static_cast<uint64_t>(count);
+        next = input_;
+        available = static_cast<size_t>(count);
+        return true;
+    }
+
+    int fd_;
+    unsigned char input_[1 << 16];
+    uint64_t filePos_ = 0;   // Next offset to read from the file
+    uint64_t consumed_ = 0;  // Compressed bytes the decoder has used
+    bool boundary_ = false;
+    bool finished_ = false;
+    bool failed_ = false;
+};
+
+namespace {
+
+const size_t WINDOW_SIZE = 32768;
+
+// Deflate inside gzip members, following concatenated members. Checkpoints
+// are taken at deflate block boundaries and resume in raw deflate mode with
+// the previous 32 KiB of output as the dictionary (the zran technique).
+class GzipDecoder : public StreamDecoder {
+public:
+    explicit GzipDecoder(int fd) : StreamDecoder(fd) {}
+
+    ~GzipDecoder() override {
+        if (initialized_) {
+            inflateEnd(&stream_);
+        }
+    }
+
+    bool restart(const CompressedFile::Checkpoint& point) override {
+        if (initialized_) {
+            inflateEnd(&stream_);
+        }
+        memset(&stream_, 0, sizeof(stream_));
+        boundary_ = finished_ = failed_ = false;
+        trailer_ = 0;
+        membersEnded_ = 0;
+        historyPos_ = historyLength_ = 0;
+        inMember_ = point.in != 0;
+
+        if (point.in == 0) {
+            // Start of the file: let zlib parse the gzip header
+            initialized_ = inflateInit2(&stream_, 15 + 16) == Z_OK;
+            raw_ = false;
+            filePos_ = consumed_ = 0;
+        } else {
+            initialized_ = inflateInit2(&stream_, -15) == Z_OK;
+            raw_ = true;
+            filePos_ = point.in - (point.bits ? 1 : 0);
+            consumed_ = point.in;
+            if (initialized_ && point.bits) {
+                unsigned char byte = 0;
+                if (pread(fd_, &byte, 1, filePos_) != 1) {
+                    failed_ = finished_ = true;
+                    return false;
+                }
+                filePos_++;
+                inflatePrime(&stream_, point.bits, byte >> (8 - point.bits));
+            }
+            if (initialized_ && !point.window.empty()) {
+                inflateSetDictionary(&stream_, point.window.data(), static_cast<uInt>(point.window.size()));
+                remember(reinterpret_cast<const char*>(point.window.data()), point.window.size());
+            }
+        }
+        if (!initialized_) {
+            failed_ = finished_ = true;
+        }
+        return initialized_;
+    }
+
+    size_t read(char* out, size_t capacity, bool stopAtBoundary) override {
+        boundary_ = false;
+        stream_.next_out = reinterpret_cast<Bytef*>(out);
+        stream_.avail_out = static_cast<uInt>(capacity);
+
+        while (stream_.avail_out > 0 && !finished_) {
+            if (stream_.avail_in == 0) {
+                const unsigned char* next = nullptr;
+                size_t available = 0;
+                if (!fill(next, available)) {
+                    // Running out of input inside a member means a truncated file
+                    failed_ = failed_ || inMember_;
+                    finished_ = true;
+                    break;
+                }
+                stream_.next_in = const_cast<Bytef*>(next);
+                stream_.avail_in = static_cast<uInt>(available);
+            }
+
+            // A raw-mode decoder has to step over the member's CRC and size
+            if (trailer_ > 0) {
+                uInt skip = std::min<uInt>(static_cast<uInt>(trailer_), stream_.avail_in);
+                stream_.next_in += skip;
+                stream_.avail_in -= skip;
+                consumed_ += skip;
+                trailer_ -= skip;
+                if (trailer_ == 0) {
+                    inflateReset2(&stream_, 15 + 16);
+                    raw_ = false;
+                    inMember_ = false;
+                }
+                continue;
+            }
+
+            uInt before = stream_.avail_in;
+            int result = inflate(&stream_, stopAtBoundary ? Z_BLOCK : Z_NO_FLUSH);
+            consumed_ += before - stream_.avail_in;
+            inMember_ = inMember_ || before != stream_.avail_in;
+
+            if (result == Z_STREAM_END) {
+                // Another member may follow (concatenated gzip)
+                membersEnded_++;
+                if (raw_) {
+                    trailer_ = 8;
+                } else {
+                    inflateReset(&stream_);
+                    inMember_ = false;
+                }
+                continue;
+            }
+            if (result == Z_BUF_ERROR && stream_.avail_in == 0) {
+                continue;
+            }
+            if (result != Z_OK) {
+                // Padding after the last member is not an error
+                failed_ = !(result == Z_DATA_ERROR && membersEnded_ > 0 && !raw_);
+                finished_ = true;
+                break;
+            }
+            if (stopAtBoundary && (stream_.data_type & 128) && !(stream_.data_type & 64)) {
+                boundary_ = true;
+                break;
+            }
+        }
+
+        size_t produced = capacity - stream_.avail_out;
+        remember(out, produced);
+        return produced;
+    }
+
+    void checkpoint(CompressedFile::Checkpoint& point) const override {
+        point.in = consumed_;
+        point.bits = stream_.data_type & 7;
+        point.window.resize(historyLength_);
+        // Oldest bytes first
+        size_t start = (historyPos_ + WINDOW_SIZE - historyLength_) % WINDOW_SIZE;
+        size_t first = std::min(historyLength_, WINDOW_SIZE - start);
+        memcpy(point.window.data(), history_ + start, first);
+        memcpy(point.window.data() + first, history_, historyLength_ - first);
+    }
+
+private:
+    // Keep the last 32 KiB of output for checkpoint windows
+    void remember(const char* data, size_t length) {
+        if (length >= WINDOW_SIZE) {
+            memcpy(history_, data + length - WINDOW_SIZE, WINDOW_SIZE);
+            historyPos_ = 0;
+            historyLength_ = WINDOW_SIZE;
+            return;
+        }
+        size_t first = std::min(length, WINDOW_SIZE - historyPos_);
+        memcpy(history_ + historyPos_, data, first);
+        memcpy(history_, data + first, length - first);
+        historyPos_ = (historyPos_ + length) % WINDOW_SIZE;
+        historyLength_ = std::min(WINDOW_SIZE, historyLength_ + length);
+    }
+
+    z_stream stream_;
+    bool initialized_ = false;
+    bool raw_ = false;
+    bool inMember_ = false;
+    size_t trailer_ = 0;
+    size_t membersEnded_ = 0;
+    unsigned char history_[WINDOW_SIZE];
+    size_t historyPos_ = 0;
+    size_t historyLength_ = 0;
+};
+
+#ifdef HAVE_ZSTD
+// zstd decoder state cannot be saved, so checkpoints are frame starts.
+// Files written as many frames (e.g. zstd --rsyncable or seekable output)
+// seek well; a single-frame file always decodes from the start.
+class ZstdDecoder : public StreamDecoder {
+public:
+    explicit ZstdDecoder(int fd) : StreamDecoder(fd), stream_(ZSTD_createDStream()) {}
+
+    ~ZstdDecoder() override {
+        ZSTD_freeDStream(stream_);
+    }
+
+    bool restart(const CompressedFile::Checkpoint& point) override {
+        boundary_ = finished_ = failed_ = false;
+        ZSTD_initDStream(stream_);
+        inFrame_ = false;
+        filePos_ = consumed_ = point.in;
+        in_ = {input_, 0, 0};
+        return true;
+    }
+
+    size_t read(char* out, size_t capacity, bool stopAtBoundary) override {
+        boundary_ = false;
+        ZSTD_outBuffer output = {out, capacity, 0};
+        while (output.pos < output.size && !finished_) {
+            if (in_.pos == in_.size) {
+                const unsigned char* next = nullptr;
+                size_t available = 0;
+                if (!fill(next, available)) {
+                    failed_ = failed_ || inFrame_;
+                    finished_ = true;
+                    break;
+                }
+                in_ = {next, available, 0};
+            }
+            size_t before = in_.pos;
+            size_t result = ZSTD_decompressStream(stream_, &output, &in_);
+            consumed_ += in_.pos - before;
+            if (ZSTD_isError(result)) {
+                failed_ = finished_ = true;
+                break;
+            }
+            inFrame_ = result != 0;
+            if (result == 0 && stopAtBoundary) {
+                boundary_ = true; // End of a frame
+                break;
+            }
+        }
+        return output.pos;
+    }
+
+    void checkpoint(CompressedFile::Checkpoint& point) const override {
+        point.in = consumed_;
+        point.bits = 0;
+        point.window.clear();
+    }
+
+private:
+    ZSTD_DStream* stream_;
+    ZSTD_inBuffer in_ = {nullptr, 0, 0};
+    bool inFrame_ = false;
+};
+#endif
+
+} // namespace
+
+CompressedFile::CompressedFile() = default;
+
+CompressedFile::~CompressedFile() {
+    close();
+}
+
+CompressedFile::Format CompressedFile::detect(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Format::NONE;
+    }
+    unsigned char magic[4] = {0};
+    ssize_t count = ::read(fd, magic, sizeof(magic));
+    ::close(fd);
+
+    if (count >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return Format::GZIP;
+    }
+    if (count == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return Format::ZSTD;
+    }
+    return Format::NONE;
+}
+
+const char* CompressedFile::formatName(Format format) {
+    switch (format) {
+        case Format::GZIP:
+            return "gzip";
+        case Format::ZSTD:
+            return "zstd";
+        default:
+            return "none";
+    }
+}
+
+bool CompressedFile::open(const std::string& path, uint64_t span) {
+    close();
+    path_ = path;
+    error_.clear();
+
+    format_ = detect(path);
+    if (format_ == Format::NONE) {
+        error_ = "not a gzip or zstd file";
+        return false;
+    }
+#ifndef HAVE_ZSTD
+    if (format_ == Format::ZSTD) {
+        error_ = "zstd support was not built in";
+        format_ = Format::NONE;
+        return false;
+    }
+#endif
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat statBuf;
+    if (fd_ < 0 || fstat(fd_, &statBuf) != 0) {
+        error_ = strerror(errno);
+        close();
+        return false;
+    }
+    compressedSize_ = static_cast<uint64_t>(statBuf.st_size);
+
+    // The start of the file is always a checkpoint, and line 0 starts there
+    checkpoints_.assign(1, Checkpoint());
+    span_ = std::max<uint64_t>(span, 1);
+    lineStarts_.assign(1, 0);
+    lineStride_ = LINE_STRIDE;
+    compressedDone_ = 0;
+    size_ = 0;
+    newlines_ = 0;
+    lastByteNewline_ = true;
+    complete_ = false;
+    stopping_ = false;
+
+    indexer_ = std::thread(&CompressedFile::indexLoop, this);
+    return true;
+}
+
+void CompressedFile::close() {
+    stopping_ = true;
+    if (indexer_.joinable()) {
+        indexer_.join();
+    }
+    cursor_.reset();
+    blocks_.clear();
+    lru_.clear();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    format_ = Format::NONE;
+}
+
+CompressedFile::Format CompressedFile::format() const {
+    return format_;
+}
+
+const std::string& CompressedFile::error() const {
+    return error_;
+}
+
+bool CompressedFile::complete() const {
+    return complete_;
+}
+
+double CompressedFile::progress() const {
+    if (complete_ || compressedSize_ == 0) {
+        return 1.0;
+    }
+    return std::min(1.0, static_cast<double>(compressedDone_) / static_cast<double>(compressedSize_));
+}
+
+uint64_t CompressedFile::size() const {
+    return size_;
+}
+
+uint64_t CompressedFile::knownLines() const {
+    uint64_t lines = newlines_;
+    if (complete_ && !lastByteNewline_) {
+        lines++; // Unterminated last line
+    }
+    return lines;
+}
+
+size_t CompressedFile::checkpointCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return checkpoints_.size();
+}
+
+void CompressedFile::waitForIndex() {
+    if (indexer_.joinable()) {
+        indexer_.join();
+    }
+}
+
+std::unique_ptr<StreamDecoder> CompressedFile::makeDecoder() const {
+#ifdef HAVE_ZSTD
+    if (format_ == Format::ZSTD) {
+        return std::unique_ptr<StreamDecoder>(new ZstdDecoder(fd_));
+    }
+#endif
+    return std::unique_ptr<StreamDecoder>(new GzipDecoder(fd_));
+}
+
+// Decompress the whole file once, recording checkpoints and line starts
+void CompressedFile::indexLoop() {
+    std::unique_ptr<StreamDecoder> decoder = makeDecoder();
+    decoder->restart(Checkpoint());
+
+    std::vector<char> buffer(1 << 16);
+    uint64_t out = 0;
+    uint64_t lastCheckpoint = 0;
+    uint64_t newlines = 0;
+    while (!stopping_ && !decoder->finished()) {
+        size_t produced = decoder->read(buffer.data(), buffer.size(), true);
+
+        const char* data = buffer.data();
+        const char* pos = data;
+        const char* end = data + produced;
+        while (const char* newline = static_cast<const char*>(memchr(pos, '\n', end - pos))) {
+            pos = newline + 1;
+            newlines++;
+            if (newlines % lineStride_ == 0) {
+                addLineStart(out + (pos - data));
+            }
+        }
+        if (produced > 0) {
+            lastByteNewline_ = buffer[produced - 1] == '\n';
+        }
+        out += produced;
+        newlines_ = newlines;
+        size_ = out;
+        compressedDone_ = decoder->consumed();
+
+        if (decoder->atBoundary() && out - lastCheckpoint >= span_) {
+            Checkpoint point;
+            point.out = out;
+            decoder->checkpoint(point);
+            addCheckpoint(std::move(point));
+            lastCheckpoint = out;
+        }
+    }
+
+    if (decoder->failed()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = "corrupt or truncated data after " + std::to_string(out) + " bytes";
+    }
+    complete_ = true;
+}
+
+void CompressedFile::addCheckpoint(Checkpoint&& point) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    checkpoints_.push_back(std::move(point));
+    if (checkpoints_.size() <= MAX_CHECKPOINTS) {
+        return;
+    }
+    // Keep every other checkpoint; the ones left are twice as far apart
+    size_t kept = 0;
+    for (size_t i = 0; i < checkpoints_.size(); i += 2) {
+        checkpoints_[kept++] = std::move(checkpoints_[i]);
+    }
+    checkpoints_.resize(kept);
+    span_ *= 2;
+}
+
+void CompressedFile::addLineStart(uint64_t offset) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lineStarts_.push_back(offset);
+    if (lineStarts_.size() <= MAX_LINE_CHECKPOINTS) {
+        return;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < lineStarts_.size(); i += 2) {
+        lineStarts_[kept++] = lineStarts_[i];
+    }
+    lineStarts_.resize(kept);
+    lineStride_ *= 2;
+}
+
+// Cached block, decoding it on a miss; null past the end of the data
+const std::string* CompressedFile::block(uint64_t blockIndex) {
+    auto it = blocks_.find(blockIndex);
+    if (it != blocks_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.second);
+        return &it->second.first;
+    }
+
+    std::string data;
+    if (!decodeBlock(blockIndex, data) || data.empty()) {
+        return nullptr;
+    }
+    if (blocks_.size() >= CACHE_BLOCKS) {
+        blocks_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(blockIndex);
+    auto inserted = blocks_.emplace(blockIndex, std::make_pair(std::move(data), lru_.begin()));
+    return &inserted.first->second.first;
+}
+
+bool CompressedFile::decodeBlock(uint64_t blockIndex, std::string& out) {
+    uint64_t target = blockIndex * BLOCK_SIZE;
+    if (!cursor_) {
+        cursor_ = makeDecoder();
+        cursorOut_ = UINT64_MAX;
+    }
+
+    // Nearest checkpoint at or before the block. A cursor between it and
+    // the block (e.g. from the previous block) is closer still.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), target,
+                                   [](uint64_t offset, const Checkpoint& point) { return offset < point.out; });
+        const Checkpoint& point = *(it - 1);
+        bool cursorUsable = cursorOut_ != UINT64_MAX && cursorOut_ >= point.out && cursorOut_ <= target &&
+                            !cursor_->failed();
+        if (!cursorUsable) {
+            if (!cursor_->restart(point)) {
+                cursorOut_ = UINT64_MAX;
+                return false;
+            }
+            cursorOut_ = point.out;
+        }
+    }
+
+    // Decompress and discard up to the block
+    std::vector<char> scratch(1 << 16);
+    while (cursorOut_ < target && !cursor_->finished()) {
+        size_t wanted = static_cast<size_t>(std::min<uint64_t>(scratch.size(), target - cursorOut_));
+        cursorOut_ += cursor_->read(scratch.data(), wanted, false);
+    }
+
+    out.resize(BLOCK_SIZE);
+    size_t filled = 0;
+    while (filled < BLOCK_SIZE && !cursor_->finished()) {
+        filled += cursor_->read(&out[filled], BLOCK_SIZE - filled, false);
+    }
+    out.resize(filled);
+    cursorOut_ += filled;
+    return !out.empty();
+}
+
+bool CompressedFile::read(uint64_t offset, uint64_t length, std::string& out) {
+    out.clear();
+    while (length > 0) {
+        const std::string* data = block(offset / BLOCK_SIZE);
+        uint64_t within = offset % BLOCK_SIZE;
+        if (!data || within >= data->size()) {
+            break; // End of data
+        }
+        uint64_t take = std::min<uint64_t>(length, data->size() - within);
+        out.append(*data, within, take);
+        offset += take;
+        length -= take;
+    }
+    return length == 0 || !out.empty();
+}
+
+bool CompressedFile::line(uint64_t n, std::string& text) {
+    uint64_t pos;
+    uint64_t skip;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (n >= knownLines()) {
+            return false;
+        }
+        pos = lineStarts_[n / lineStride_];
+        skip = n % lineStride_;
+    }
+
+    // Step over the lines between the stored start and the one wanted
+    while (skip > 0) {
+        const std::string* data = block(pos / BLOCK_SIZE);
+        uint64_t within = pos % BLOCK_SIZE;
+        if (!data || within >= data->size()) {
+            return false;
+        }
+        const char* begin = data->data() + within;
+        const void* newline = memchr(begin, '\n', data->size() - within);
+        if (newline) {
+            pos += static_cast<const char*>(newline) - begin + 1;
+            skip--;
+        } else {
+            pos += data->size() - within;
+        }
+    }
+
+    text.clear();
+    while (text.size() < MAX_LINE_BYTES) {
+        const std::string* data = block(pos / BLOCK_SIZE);
+        uint64_t within = pos % BLOCK_SIZE;
+        if (!data || within >= data->size()) {
+            break;
+        }
+        const char* begin = data->data() + within;
+        const void* newline = memchr(begin, '\n', data->size() - within);
+        uint64_t length = newline ? static_cast<uint64_t>(static_cast<const char*>(newline) - begin)
+                                  : data->size() - within;
+        text.append(begin, std::min<uint64_t>(length, MAX_LINE_BYTES - text.size()));
+        if (newline) {
+            break;
+        }
+        pos += length;
+    }
+    return true;
+}
+
+uint64_t CompressedFile::lineAtOffset(uint64_t offset) {
+    uint64_t line;
+    uint64_t pos;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        offset = std::min<uint64_t>(offset, size_);
+        auto it = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset);
+        uint64_t index = static_cast<uint64_t>(it - lineStarts_.begin()) - 1;
+        line = index * lineStride_;
+        pos = lineStarts_[index];
+    }
+
+    // Count the newlines between the stored line start and the offset
+    while (pos < offset) {
+        const std::string* data = block(pos / BLOCK_SIZE);
+        uint64_t within = pos % BLOCK_SIZE;
+        if (!data || within >= data->size()) {
+            break;
+        }
+        uint64_t limit = std::min<uint64_t>(data->size() - within, offset - pos);
+        const char* begin = data->data() + within;
+        const void* newline = memchr(begin, '\n', limit);
+        if (!newline) {
+            pos += limit;
+            continue;
+        }
+        pos += static_cast<const char*>(newline) - begin + 1;
+        line++;
+    }
+    return line;
+}
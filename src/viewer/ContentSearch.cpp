@@ -0,0 +1,214 @@
+#include "../../include/viewer/ContentSearch.h"
+#include "../../include/io/AccessHints.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define CONTENTSEARCH_USE_SSE2 1
+#endif
+
+const uint64_t ContentSearch::CHUNK;
+
+ContentSearch::ContentSearch(const MappedFile& file) : file_(file) {}
+
+ContentSearch::~ContentSearch() {
+    cancel();
+}
+
+void ContentSearch::start(const std::string& pattern, uint64_t from, bool forward) {
+    cancel();
+    pattern_ = pattern;
+    cancelled_ = false;
+    wrapped_ = false;
+    scanned_ = 0;
+    if (pattern.empty()) {
+        state_ = State::NOT_FOUND;
+        return;
+    }
+    state_ = State::RUNNING;
+    worker_ = std::thread(&ContentSearch::run, this, from, forward);
+}
+
+void ContentSearch::cancel() {
+    cancelled_ = true;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+ContentSearch::State ContentSearch::state() const {
+    return state_;
+}
+
+uint64_t ContentSearch::result() const {
+    return result_;
+}
+
+bool ContentSearch::wrapped() const {
+    return wrapped_;
+}
+
+double ContentSearch::progress() const {
+    if (file_.size() == 0) {
+        return 1.0;
+    }
+    return std::min(1.0, static_cast<double>(scanned_) / static_cast<double>(file_.size()));
+}
+
+const std::string& ContentSearch::pattern() const {
+    return pattern_;
+}
+
+void ContentSearch::run(uint64_t from, bool forward) {
+    uint64_t size = file_.size();
+    uint64_t overlap = pattern_.size() - 1;
+    from = std::min(from, size);
+    uint64_t found = 0;
+
+    // First pass from the start position, then the part before it
+    bool hit;
+    if (forward) {
+        hit = scanRange(from, size, true, found);
+        if (!hit && !cancelled_) {
+            hit = scanRange(0, std::min(size, from + overlap), true, found);
+            wrapped_ = hit;
+        }
+    } else {
+        hit = scanRange(0, std::min(size, from + overlap), false, found);
+        if (!hit && !cancelled_) {
+            hit = scanRange(from, size, false, found);
+            wrapped_ = hit;
+        }
+    }
+
+    if (cancelled_) {
+        state_ = State::CANCELLED;
+    } else if (hit) {
+        result_ = found;
+        state_ = State::FOUND;
+    } else {
+        state_ = State::NOT_FOUND;
+    }
+}
+
+// Scan [begin, end) a chunk at a time; chunks overlap by the pattern length
+// so matches across chunk boundaries are not missed. The chunk after the
+// current one, in the direction of the scan, is read in ahead.
+bool ContentSearch::scanRange(uint64_t begin, uint64_t end, bool forward, uint64_t& found) {
+    const char* data = file_.data();
+    uint64_t overlap = pattern_.size() - 1;
+    if (forward) {
+        for (uint64_t pos = begin; pos < end && !cancelled_; pos += CHUNK) {
+            uint64_t chunkEnd = std::min(end, pos + CHUNK + overlap);
+            if (chunkEnd < end) {
+                AccessHints::mappedWillNeed(data + chunkEnd, std::min(CHUNK, end - chunkEnd));
+            }
+            if (findForward(data, pos, chunkEnd, pattern_, found)) {
+                return true;
+            }
+            scanned_ += std::min(CHUNK, end - pos);
+        }
+    } else {
+        for (uint64_t high = end; high > begin && !cancelled_;) {
+            uint64_t low = high - begin > CHUNK ? high - CHUNK : begin;
+            if (low > begin) {
+                uint64_t ahead = low - begin > CHUNK ? low - CHUNK : begin;
+                AccessHints::mappedWillNeed(data + ahead, low - ahead);
+            }
+            if (findBackward(data, low, std::min(end, high + overlap), pattern_, found)) {
+                return true;
+            }
+            scanned_ += high - low;
+            high = low;
+        }
+    }
+    return false;
+}
+
+// Candidates are positions where both the first and the last byte of the
+// pattern match, tested 16 positions at a time; only those are compared in full
+bool ContentSearch::findForward(const char* data, uint64_t from, uint64_t to,
+                                const std::string& pattern, uint64_t& found) {
+    uint64_t length = pattern.size();
+    if (length == 0 || to < from || to - from < length) {
+        return false;
+    }
+    uint64_t lastStart = to - length;
+    uint64_t pos = from;
+
+#ifdef CONTENTSEARCH_USE_SSE2
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[length - 1]);
+    while (pos + 15 <= lastStart) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + length - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+        while (mask != 0) {
+            int bit = __builtin_ctz(mask);
+            if (memcmp(data + pos + bit, pattern.data(), length) == 0) {
+                found = pos + bit;
+                return true;
+            }
+            mask &= mask - 1;
+        }
+        pos += 16;
+    }
+#endif
+
+    // Remaining positions (or all of them without SSE2)
+    while (pos <= lastStart) {
+        const void* hit = memchr(data + pos, pattern[0], lastStart - pos + 1);
+        if (!hit) {
+            return false;
+        }
+        pos = static_cast<uint64_t>(static_cast<const char*>(hit) - data);
+        if (memcmp(data + pos, pattern.data(), length) == 0) {
+            found = pos;
+            return true;
+        }
+        pos++;
+    }
+    return false;
+}
+
+bool ContentSearch::findBackward(const char* data, uint64_t from, uint64_t to,
+                                 const std::string& pattern, uint64_t& found) {
+    uint64_t length = pattern.size();
+    if (length == 0 || to < from || to - from < length) {
+        return false;
+    }
+    // Candidate starts are [from, end); walk them from the top down
+    uint64_t end = to - length + 1;
+
+#ifdef CONTENTSEARCH_USE_SSE2
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[length - 1]);
+    while (end >= from + 16) {
+        uint64_t pos = end - 16;
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + length - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+        while (mask != 0) {
+            int bit = 31 - __builtin_clz(mask);
+            if (memcmp(data + pos + bit, pattern.data(), length) == 0) {
+                found = pos + bit;
+                return true;
+            }
+            mask &= ~(1u << bit);
+        }
+        end = pos;
+    }
+#endif
+
+    while (end > from) {
+        end--;
+        if (data[end] == pattern[0] && memcmp(data + end, pattern.data(), length) == 0) {
+            found = end;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+#include "../../include/viewer/FileWatcher.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+#ifdef __linux__
+bool FileWatcher::watch(const std::string& path) {
+    stop();
+    path_ = path;
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    name_ = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    fileWatch_ = inotify_add_watch(fd_, path.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    dirWatch_ = inotify_add_watch(fd_, dir.c_str(), IN_CREATE | IN_MOVED_TO);
+    if (fileWatch_ < 0 && dirWatch_ < 0) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (fd_ >= 0) {
+        close(fd_);  // Also removes the watches
+    }
+    fd_ = -1;
+    fileWatch_ = -1;
+    dirWatch_ = -1;
+}
+
+bool FileWatcher::readEvents() {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    bool relevant = false;
+    bool recreated = false;
+    alignas(struct inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            if (event->wd == fileWatch_) {
+                relevant = true;
+            } else if (event->wd == dirWatch_ && event->len > 0 && name_ == event->name) {
+                // A new file appeared under the watched name
+                relevant = true;
+                recreated = true;
+            }
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    // Follow the name, not the old inode
+    if (recreated) {
+        if (fileWatch_ >= 0) {
+            inotify_rm_watch(fd_, fileWatch_);
+        }
+        fileWatch_ = inotify_add_watch(fd_, path_.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    }
+    return relevant;
+}
+#else
+bool FileWatcher::watch(const std::string& path) {
+    path_ = path;
+    return false;
+}
+
+void FileWatcher::stop() {
+    fd_ = -1;
+}
+
+bool FileWatcher::readEvents() {
+    return false;
+}
+#endif
+
+int FileWatcher::fd() const {
+    return fd_;
+}
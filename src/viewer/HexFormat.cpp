@@ -0,0 +1,124 @@
+#include "../../include/viewer/HexFormat.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace HexFormat {
+
+bool looksBinary(const char* data, uint64_t size) {
+    uint64_t length = std::min(size, SNIFF_BYTES);
+    return length > 0 && memchr(data, '\0', length) != nullptr;
+}
+
+int bytesPerRow(int columns) {
+    // A row of n bytes is 4n + n/8 + 14 columns wide: offset and gap (12),
+    // "xx " and one ASCII column per byte, a space between groups of 8,
+    // and " |...|" around the ASCII part
+    int bytes = (columns - 14) * 8 / 33;
+    bytes -= bytes % 8;
+    return std::max(bytes, 8);
+}
+
+std::string formatRow(const char* data, uint64_t size, uint64_t offset, int bytesPerRow) {
+    static const char digits[] = "0123456789abcdef";
+    char prefix[24];
+    snprintf(prefix, sizeof(prefix), "%010llx  ", static_cast<unsigned long long>(offset));
+
+    std::string row(prefix);
+    std::string ascii;
+    for (int i = 0; i < bytesPerRow; i++) {
+        if (i > 0 && i % 8 == 0) {
+            row += ' ';
+        }
+        if (offset + i < size) {
+            unsigned char byte = static_cast<unsigned char>(data[offset + i]);
+            row += digits[byte >> 4];
+            row += digits[byte & 0xf];
+            row += ' ';
+            ascii += (byte >= 0x20 && byte < 0x7f) ? static_cast<char>(byte) : '.';
+        } else {
+            row += "   ";
+        }
+    }
+    row += " |" + ascii + "|";
+    return row;
+}
+
+bool parsePattern(const std::string& text, std::vector<uint8_t>& pattern) {
+    pattern.clear();
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        pattern.assign(text.begin() + 1, text.end() - 1);
+        return !pattern.empty();
+    }
+
+    std::string hex;
+    for (char c : text) {
+        if (isxdigit(static_cast<unsigned char>(c))) {
+            hex += c;
+        } else if (c != ' ') {
+            return false;
+        }
+    }
+    if (hex.empty() || hex.size() % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        pattern.push_back(static_cast<uint8_t>(strtoul(hex.substr(i, 2).c_str(), nullptr, 16)));
+    }
+    return true;
+}
+
+bool parseOffset(const std::string& text, uint64_t size, uint64_t& offset) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    if (text.back() == '%') {
+        unsigned long long percent = strtoull(text.c_str(), &end, 10);
+        if (end != text.c_str() + text.size() - 1) {
+            return false;
+        }
+        offset = size / 100 * std::min(percent, 100ULL) + size % 100 * std::min(percent, 100ULL) / 100;
+        return true;
+    }
+    unsigned long long value = strtoull(text.c_str(), &end, 0);
+    if (end != text.c_str() + text.size()) {
+        return false;
+    }
+    offset = value;
+    return true;
+}
+
+namespace {
+
+bool searchRange(const char* data, uint64_t from, uint64_t to,
+                 const std::vector<uint8_t>& pattern, uint64_t& found) {
+    if (to < from || to - from < pattern.size()) {
+        return false;
+    }
+    const void* hit = memmem(data + from, to - from, pattern.data(), pattern.size());
+    if (!hit) {
+        return false;
+    }
+    found = static_cast<uint64_t>(static_cast<const char*>(hit) - data);
+    return true;
+}
+
+} // namespace
+
+bool findPattern(const char* data, uint64_t size, uint64_t from,
+                 const std::vector<uint8_t>& pattern, uint64_t& found) {
+    if (pattern.empty() || !data) {
+        return false;
+    }
+    from = std::min(from, size);
+    if (searchRange(data, from, size, pattern, found)) {
+        return true;
+    }
+    // Wrap around; a match may straddle the starting offset
+    return searchRange(data, 0, std::min(size, from + pattern.size() - 1), pattern, found);
+}
+
+} // namespace HexFormat
@@ -0,0 +1,232 @@
+#include "../../include/viewer/LineIndex.h"
+#include "../../include/io/AccessHints.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define LINEINDEX_USE_SSE2 1
+#endif
+
+const uint64_t LineIndex::STRIDE;
+const uint64_t LineIndex::SCAN_CHUNK;
+const size_t LineIndex::MAX_CHECKPOINTS;
+
+LineIndex::LineIndex(const MappedFile& file, size_t maxCheckpoints)
+    : file_(file), maxCheckpoints_(std::max<size_t>(maxCheckpoints, 2)) {
+    checkpoints_.push_back(0);
+}
+
+LineIndex::~LineIndex() {
+    stopBackgroundIndexing();
+}
+
+bool LineIndex::complete() const {
+    return scannedBytes_ >= file_.size();
+}
+
+uint64_t LineIndex::knownLines() const {
+    uint64_t lines = newlines_;
+    // An unterminated last line still counts once the scan reaches it
+    if (complete() && file_.size() > 0 && file_.data()[file_.size() - 1] != '\n') {
+        lines++;
+    }
+    return lines;
+}
+
+double LineIndex::progress() const {
+    if (file_.size() == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(scannedBytes_) / static_cast<double>(file_.size());
+}
+
+bool LineIndex::hasLine(uint64_t line) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ensureLine(line);
+}
+
+bool LineIndex::lineRange(uint64_t line, uint64_t& start, uint64_t& length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ensureLine(line)) {
+        return false;
+    }
+    start = lineStart(line);
+    const char* data = file_.data();
+    uint64_t size = file_.size();
+    const void* newline = memchr(data + start, '\n', size - start);
+    uint64_t end = newline ? static_cast<uint64_t>(static_cast<const char*>(newline) - data) : size;
+    length = end - start;
+    return true;
+}
+
+uint64_t LineIndex::lineAtOffset(uint64_t offset) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const char* data = file_.data();
+    offset = std::min(offset, file_.size());
+    while (!complete() && scannedBytes_ <= offset) {
+        scanChunk();
+    }
+
+    // Find the checkpoint at or before the offset, then count forward
+    auto it = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), offset);
+    uint64_t checkpoint = static_cast<uint64_t>(it - checkpoints_.begin()) - 1;
+    uint64_t line = checkpoint * stride_;
+    uint64_t pos = checkpoints_[checkpoint];
+    while (pos < offset) {
+        const void* newline = memchr(data + pos, '\n', offset - pos);
+        if (!newline) {
+            break;
+        }
+        pos = static_cast<uint64_t>(static_cast<const char*>(newline) - data) + 1;
+        line++;
+    }
+    return line;
+}
+
+uint64_t LineIndex::lineCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!complete()) {
+        scanChunk();
+    }
+    return knownLines();
+}
+
+void LineIndex::startBackgroundIndexing() {
+    if (indexer_.joinable() || complete()) {
+        return;
+    }
+    stopping_ = false;
+    indexer_ = std::thread(&LineIndex::backgroundLoop, this);
+}
+
+void LineIndex::stopBackgroundIndexing() {
+    stopping_ = true;
+    if (indexer_.joinable()) {
+        indexer_.join();
+    }
+}
+
+void LineIndex::reset() {
+    stopBackgroundIndexing();
+    std::lock_guard<std::mutex> lock(mutex_);
+    checkpoints_.assign(1, 0);
+    stride_ = STRIDE;
+    scannedBytes_ = 0;
+    newlines_ = 0;
+}
+
+uint64_t LineIndex::stride() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stride_;
+}
+
+// One chunk per lock acquisition, so foreground lookups never wait long
+void LineIndex::backgroundLoop() {
+    while (!stopping_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (complete()) {
+            break;
+        }
+        scanChunk();
+    }
+}
+
+// Make sure the start of the given line is covered by the scanned region
+bool LineIndex::ensureLine(uint64_t line) {
+    // Scan until the line is terminated or the file ends
+    while (newlines_ <= line && !complete()) {
+        scanChunk();
+    }
+    return line < knownLines();
+}
+
+uint64_t LineIndex::lineStart(uint64_t line) const {
+    const char* data = file_.data();
+    uint64_t pos = checkpoints_[line / stride_];
+    for (uint64_t i = 0; i < line % stride_; i++) {
+        const char* newline = static_cast<const char*>(memchr(data + pos, '\n', file_.size() - pos));
+        pos = static_cast<uint64_t>(newline - data) + 1;
+    }
+    return pos;
+}
+
+// Record the start of line newlines_ (a multiple of the stride)
+void LineIndex::addCheckpoint(uint64_t offset) {
+    checkpoints_.push_back(offset);
+    if (checkpoints_.size() <= maxCheckpoints_) {
+        return;
+    }
+    // Double the stride: keep the starts of lines that are multiples of it
+    size_t kept = 0;
+    for (size_t i = 0; i < checkpoints_.size(); i += 2) {
+        checkpoints_[kept++] = checkpoints_[i];
+    }
+    checkpoints_.resize(kept);
+    stride_ *= 2;
+}
+
+// Count newlines in the next chunk. Blocks of 64 bytes are compared 16 at a
+// time into a bitmask; exact positions are only extracted from blocks where
+// the running count crosses a checkpoint.
+void LineIndex::scanChunk() {
+    const char* data = file_.data();
+    uint64_t pos = scannedBytes_;
+    uint64_t end = std::min(file_.size(), pos + SCAN_CHUNK);
+    uint64_t newlines = newlines_;
+
+    // Have the next chunk read in while this one is counted
+    if (end < file_.size()) {
+        AccessHints::mappedWillNeed(data + end, std::min(SCAN_CHUNK, file_.size() - end));
+    }
+
+#ifdef LINEINDEX_USE_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (pos + 64 <= end) {
+        const char* block = data + pos;
+        uint64_t mask =
+            static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), newline)))) |
+            (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)), newline)))) << 16) |
+            (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)), newline)))) << 32) |
+            (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)), newline)))) << 48);
+
+        if (mask != 0) {
+            uint64_t count = static_cast<uint64_t>(__builtin_popcountll(mask));
+            uint64_t nextCheckpoint = (newlines / stride_ + 1) * stride_;
+            if (newlines + count < nextCheckpoint) {
+                newlines += count;
+            } else {
+                while (mask != 0) {
+                    int bit = __builtin_ctzll(mask);
+                    mask &= mask - 1;
+                    newlines++;
+                    if (newlines % stride_ == 0) {
+                        addCheckpoint(pos + bit + 1);
+                    }
+                }
+            }
+        }
+        pos += 64;
+    }
+#endif
+
+    // Remaining bytes (or the whole chunk without SSE2)
+    while (pos < end) {
+        const void* found = memchr(data + pos, '\n', end - pos);
+        if (!found) {
+            break;
+        }
+        pos = static_cast<uint64_t>(static_cast<const char*>(found) - data) + 1;
+        newlines++;
+        if (newlines % stride_ == 0) {
+            addCheckpoint(pos);
+        }
+    }
+
+    newlines_ = newlines;
+    scannedBytes_ = end;
+}
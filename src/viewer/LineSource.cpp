@@ -0,0 +1,177 @@
+#include "../../include/viewer/LineSource.h"
+#include "../../include/io/AccessHints.h"
+#include <algorithm>
+
+const uint64_t MappedLineSource::PREFETCH_MIN_BYTES;
+const size_t CompressedLineSource::MAX_CACHED_LINES;
+
+MappedLineSource::MappedLineSource(MappedFile& file) : file_(file), index_(file), wrapCache_(file, index_) {
+    // Count lines in the background so the total and far seeks are ready soon
+    index_.startBackgroundIndexing();
+}
+
+const std::vector<RowSegment>& MappedLineSource::rows(uint64_t line, int width) {
+    return wrapCache_.rows(line, width);
+}
+
+const char* MappedLineSource::text(uint64_t) {
+    // Rows point straight into the mapping
+    return file_.data();
+}
+
+bool MappedLineSource::hasLine(uint64_t line) {
+    return index_.hasLine(line);
+}
+
+bool MappedLineSource::complete() const {
+    return index_.complete();
+}
+
+uint64_t MappedLineSource::knownLines() const {
+    return index_.knownLines();
+}
+
+uint64_t MappedLineSource::lineCount() {
+    return index_.lineCount();
+}
+
+uint64_t MappedLineSource::lineAtPercent(uint64_t percent) {
+    if (index_.complete()) {
+        // Exact line percentage straight from the checkpoints
+        return index_.knownLines() * percent / 100;
+    }
+    return index_.lineAtOffset(file_.size() * percent / 100);
+}
+
+std::string MappedLineSource::format() const {
+    return "";
+}
+
+std::string MappedLineSource::progressNote() const {
+    if (index_.complete()) {
+        return "";
+    }
+    return "Indexing " + std::to_string((int)(index_.progress() * 100)) + "%";
+}
+
+void MappedLineSource::trim(uint64_t topLine) {
+    wrapCache_.trim(topLine);
+}
+
+uint64_t MappedLineSource::lineAtOffset(uint64_t offset) {
+    return index_.lineAtOffset(offset);
+}
+
+bool MappedLineSource::reload(const std::string& path) {
+    // The mapping may move, so the indexer may not be reading it
+    index_.stopBackgroundIndexing();
+    MappedFile::Change change = file_.isOpen() ? file_.refresh() : MappedFile::Change::REPLACED;
+    bool restarted = false;
+    if (change == MappedFile::Change::GREW) {
+        // Only the unterminated last line can have changed
+        wrapCache_.invalidateFrom(index_.knownLines());
+    } else if (change != MappedFile::Change::NONE) {
+        // Truncated or rotated: start over with whatever the path names now
+        file_.open(path);
+        index_.reset();
+        wrapCache_.clear();
+        prefetchBegin_ = prefetchEnd_ = 0;
+        restarted = true;
+    }
+    index_.startBackgroundIndexing();
+    return restarted;
+}
+
+void MappedLineSource::readAhead(uint64_t viewBegin, uint64_t viewEnd) {
+    // Read-ahead in the direction of scrolling, so the next screens are
+    // already cached when a cold file is paged through
+    if (viewBegin != lastViewBegin_) {
+        scrollingForward_ = viewBegin > lastViewBegin_;
+        lastViewBegin_ = viewBegin;
+    }
+    uint64_t ahead = std::max<uint64_t>(2 * (viewEnd - viewBegin), PREFETCH_MIN_BYTES);
+    uint64_t aheadBegin = scrollingForward_ ? viewEnd : (viewBegin > ahead ? viewBegin - ahead : 0);
+    uint64_t aheadEnd = scrollingForward_ ? std::min(file_.size(), viewEnd + ahead) : viewBegin;
+    // Unless already requested
+    if (aheadBegin < aheadEnd && (aheadBegin < prefetchBegin_ || aheadEnd > prefetchEnd_)) {
+        AccessHints::mappedWillNeed(file_.data() + aheadBegin, aheadEnd - aheadBegin);
+        prefetchBegin_ = aheadBegin;
+        prefetchEnd_ = aheadEnd;
+    }
+}
+
+CompressedLineSource::CompressedLineSource(CompressedFile& file) : file_(file) {
+}
+
+const CompressedLineSource::WrappedLine& CompressedLineSource::lineAt(uint64_t line, int width) {
+    if (width != width_) {
+        lines_.clear();
+        width_ = width;
+    }
+    auto it = lines_.find(line);
+    if (it != lines_.end()) {
+        return it->second;
+    }
+    WrappedLine wrapped;
+    if (!file_.line(line, wrapped.text)) {
+        return missing_;
+    }
+    wrapped.rows = wrapLine(wrapped.text.data(), 0, wrapped.text.size(), width);
+    return lines_.emplace(line, std::move(wrapped)).first->second;
+}
+
+const std::vector<RowSegment>& CompressedLineSource::rows(uint64_t line, int width) {
+    return lineAt(line, width).rows;
+}
+
+const char* CompressedLineSource::text(uint64_t line) {
+    return lineAt(line, width_).text.data();
+}
+
+bool CompressedLineSource::hasLine(uint64_t line) {
+    return line < file_.knownLines();
+}
+
+bool CompressedLineSource::complete() const {
+    return file_.complete();
+}
+
+uint64_t CompressedLineSource::knownLines() const {
+    return file_.knownLines();
+}
+
+uint64_t CompressedLineSource::lineCount() {
+    // What has been decompressed so far; the whole file once complete
+    return file_.knownLines();
+}
+
+uint64_t CompressedLineSource::lineAtPercent(uint64_t percent) {
+    if (file_.complete()) {
+        return file_.knownLines() * percent / 100;
+    }
+    return file_.lineAtOffset(file_.size() * percent / 100);
+}
+
+std::string CompressedLineSource::format() const {
+    return CompressedFile::formatName(file_.format());
+}
+
+std::string CompressedLineSource::progressNote() const {
+    if (!file_.complete()) {
+        return "Decompressing " + std::to_string((int)(file_.progress() * 100)) + "%";
+    }
+    std::string note = std::to_string(file_.size()) + " bytes uncompressed";
+    if (!file_.error().empty()) {
+        note += " | " + file_.error();
+    }
+    return note;
+}
+
+void CompressedLineSource::trim(uint64_t topLine) {
+    if (lines_.size() <= MAX_CACHED_LINES) {
+        return;
+    }
+    uint64_t low = topLine > MAX_CACHED_LINES / 2 ? topLine - MAX_CACHED_LINES / 2 : 0;
+    lines_.erase(lines_.begin(), lines_.lower_bound(low));
+    lines_.erase(lines_.upper_bound(topLine + MAX_CACHED_LINES / 2), lines_.end());
+}
@@ -0,0 +1,97 @@
+#include "../../include/viewer/LineWrapper.h"
+#include <algorithm>
+
+const uint64_t WrapCache::MAX_LINE_BYTES;
+const size_t WrapCache::MAX_LINES;
+
+std::vector<RowSegment> wrapLine(const char* data, uint64_t start, uint64_t length, int width) {
+    std::vector<RowSegment> rows;
+    length = std::min(length, WrapCache::MAX_LINE_BYTES);
+    if (length == 0 || width <= 0) {
+        rows.push_back({start, 0});
+        return rows;
+    }
+
+    uint64_t pos = 0;
+    while (pos < length) {
+        uint64_t wrapPos = pos + width;
+        if (wrapPos >= length) {
+            // Remaining text fits in one row
+            rows.push_back({start + pos, length - pos});
+            break;
+        }
+
+        // Try to find a word boundary
+        uint64_t spacePos = wrapPos;
+        while (spacePos > pos && data[start + spacePos] != ' ') {
+            spacePos--;
+        }
+        if (spacePos > pos) {
+            rows.push_back({start + pos, spacePos - pos});
+            pos = spacePos + 1; // Skip the space
+        } else {
+            // No good word boundary, hard wrap
+            rows.push_back({start + pos, static_cast<uint64_t>(width)});
+            pos += width;
+        }
+    }
+    return rows;
+}
+
+WrapCache::WrapCache(const MappedFile& file, LineIndex& index) : file_(file), index_(index) {}
+
+const std::vector<RowSegment>& WrapCache::rows(uint64_t line, int width) {
+    if (width != width_) {
+        lines_.clear();
+        width_ = width;
+    }
+
+    auto it = lines_.find(line);
+    if (it != lines_.end()) {
+        return it->second;
+    }
+
+    uint64_t start = 0, length = 0;
+    if (!index_.lineRange(line, start, length)) {
+        return missing_;
+    }
+    return lines_.emplace(line, wrapLine(file_.data(), start, length, width)).first->second;
+}
+
+void WrapCache::trim(uint64_t topLine) {
+    if (lines_.size() <= MAX_LINES) {
+        return;
+    }
+    // Keep a window of lines around the view; scrolling back stays cheap
+    const uint64_t keep = MAX_LINES / 2;
+    for (auto it = lines_.begin(); it != lines_.end();) {
+        uint64_t distance = it->first > topLine ? it->first - topLine : topLine - it->first;
+        if (distance > keep) {
+            it = lines_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void WrapCache::invalidateFrom(uint64_t line) {
+    for (auto it = lines_.begin(); it != lines_.end();) {
+        if (it->first >= line) {
+            it = lines_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void WrapCache::clear() {
+    lines_.clear();
+}
+
+size_t WrapCache::size() const {
+    return lines_.size();
+}
+
+int WrapCache::width() const {
+    return width_;
+}
@@ -0,0 +1,256 @@
+#include "../../include/viewer/MappedFile.h"
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifndef _WIN32
+namespace {
+
+// Mappings the SIGBUS handler may patch. It runs on whichever thread
+// faulted, so the table is fixed-size and lock-free.
+struct GuardedRange {
+    std::atomic<bool> used{false};
+    std::atomic<uintptr_t> begin{0};
+    std::atomic<uintptr_t> end{0};
+    std::atomic<bool> shrank{false};
+};
+
+const size_t MAX_GUARDED = 16;
+GuardedRange guardedRanges[MAX_GUARDED];
+struct sigaction previousBusAction;
+uintptr_t pageSize = 4096;
+std::once_flag handlerInstalled;
+
+void onBusError(int, siginfo_t* info, void*) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(info->si_addr);
+    for (auto& range : guardedRanges) {
+        if (address >= range.begin && address < range.end) {
+            // Past the new end of the file: zeros from here on, and the
+            // faulting read is retried on them
+            void* page = reinterpret_cast<void*>(address & ~(pageSize - 1));
+            if (mmap(page, pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED) {
+                range.shrank = true;
+                return;
+            }
+        }
+    }
+    // Not one of ours: put back what was there and let the read fault again
+    sigaction(SIGBUS, &previousBusAction, nullptr);
+}
+
+void installBusHandler() {
+    pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onBusError;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGBUS, &action, &previousBusAction);
+}
+
+// Slot for a new mapping; -1 if the table is full and it goes unguarded
+int guardRange(const char* data, uint64_t size) {
+    std::call_once(handlerInstalled, installBusHandler);
+    for (size_t i = 0; i < MAX_GUARDED; i++) {
+        bool expected = false;
+        if (guardedRanges[i].used.compare_exchange_strong(expected, true)) {
+            guardedRanges[i].shrank = false;
+            guardedRanges[i].end = reinterpret_cast<uintptr_t>(data) + size;
+            guardedRanges[i].begin = reinterpret_cast<uintptr_t>(data);
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void moveRange(int slot, const char* data, uint64_t size) {
+    // Empty while it changes, so the handler never sees half of each
+    guardedRanges[slot].begin = 0;
+    guardedRanges[slot].end = reinterpret_cast<uintptr_t>(data) + size;
+    guardedRanges[slot].begin = reinterpret_cast<uintptr_t>(data);
+}
+
+void releaseRange(int slot) {
+    guardedRanges[slot].begin = 0;
+    guardedRanges[slot].end = 0;
+    guardedRanges[slot].used = false;
+}
+
+} // namespace
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    path_ = path;
+    error_.clear();
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        error_ = strerror(errno);
+        return false;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd_, &statBuf) != 0) {
+        error_ = strerror(errno);
+        close();
+        return false;
+    }
+    if (!S_ISREG(statBuf.st_mode)) {
+        error_ = "not a regular file";
+        close();
+        return false;
+    }
+
+    device_ = static_cast<uint64_t>(statBuf.st_dev);
+    inode_ = static_cast<uint64_t>(statBuf.st_ino);
+    size_ = static_cast<uint64_t>(statBuf.st_size);
+    if (size_ == 0) {
+        return true; // Nothing to map
+    }
+
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        error_ = strerror(errno);
+        close();
+        return false;
+    }
+    data_ = static_cast<const char*>(mapping);
+    guard_ = guardRange(data_, size_);
+    return true;
+}
+
+void MappedFile::close() {
+    if (guard_ >= 0) {
+        // Before the unmap, so the handler never patches an address reused since
+        releaseRange(guard_);
+        guard_ = -1;
+    }
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+MappedFile::Change MappedFile::refresh() {
+    if (fd_ < 0) {
+        return Change::NONE;
+    }
+    // Some of the mapping reads as zeros now, whatever the size says
+    if (shrank()) {
+        return Change::TRUNCATED;
+    }
+
+    // A rotated log is renamed away and a new file created under the name.
+    // While nothing exists at the path yet, keep showing the old file.
+    struct stat pathStat;
+    if (stat(path_.c_str(), &pathStat) == 0 &&
+        (static_cast<uint64_t>(pathStat.st_dev) != device_ || static_cast<uint64_t>(pathStat.st_ino) != inode_)) {
+        return Change::REPLACED;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd_, &statBuf) != 0) {
+        return Change::NONE;
+    }
+    uint64_t newSize = static_cast<uint64_t>(statBuf.st_size);
+    if (newSize == size_) {
+        return Change::NONE;
+    }
+    if (newSize < size_) {
+        return Change::TRUNCATED;
+    }
+
+    // Extend the mapping; pages already mapped are not read again
+    void* mapping;
+    if (data_) {
+#ifdef __linux__
+        mapping = mremap(const_cast<char*>(data_), size_, newSize, MREMAP_MAYMOVE);
+#else
+        munmap(const_cast<char*>(data_), size_);
+        mapping = mmap(nullptr, newSize, PROT_READ, MAP_SHARED, fd_, 0);
+#endif
+    } else {
+        mapping = mmap(nullptr, newSize, PROT_READ, MAP_SHARED, fd_, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        error_ = strerror(errno);
+        if (guard_ >= 0) {
+            releaseRange(guard_);
+            guard_ = -1;
+        }
+        data_ = nullptr;
+        size_ = 0;
+        return Change::TRUNCATED; // Caller reopens from scratch
+    }
+    data_ = static_cast<const char*>(mapping);
+    size_ = newSize;
+    if (guard_ >= 0) {
+        moveRange(guard_, data_, size_);
+    } else {
+        guard_ = guardRange(data_, size_);
+    }
+    return Change::GREW;
+}
+
+bool MappedFile::shrank() const {
+    return guard_ >= 0 && guardedRanges[guard_].shrank;
+}
+#else
+bool MappedFile::open(const std::string& path) {
+    path_ = path;
+    error_ = "memory mapping is not supported on this platform";
+    return false;
+}
+
+void MappedFile::close() {
+    data_ = nullptr;
+    size_ = 0;
+}
+
+MappedFile::Change MappedFile::refresh() {
+    return Change::NONE;
+}
+
+bool MappedFile::shrank() const {
+    return false;
+}
+#endif
+
+bool MappedFile::isOpen() const {
+    return fd_ >= 0;
+}
+
+const char* MappedFile::data() const {
+    return data_;
+}
+
+uint64_t MappedFile::size() const {
+    return size_;
+}
+
+const std::string& MappedFile::path() const {
+    return path_;
+}
+
+const std::string& MappedFile::error() const {
+    return error_;
+}
@@ -0,0 +1,261 @@
+#include "../../include/viewer/Previewer.h"
+#include "../../include/viewer/HexFormat.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <zlib.h>
+
+const size_t Previewer::CACHE_ENTRIES;
+const size_t Previewer::MAX_LINES;
+const size_t Previewer::READ_BYTES;
+const int Previewer::HEX_ROW_BYTES;
+
+namespace {
+
+const int TAB_WIDTH = 4;
+
+// Split text into display lines: tabs expanded, other control bytes shown as '.'
+std::vector<std::string> textLines(const std::string& data, size_t maxLines) {
+    std::vector<std::string> lines;
+    std::string line;
+    for (char c : data) {
+        if (c == '\n') {
+            lines.push_back(line);
+            line.clear();
+            if (lines.size() >= maxLines) {
+                return lines;
+            }
+        } else if (c == '\t') {
+            line.append(TAB_WIDTH - line.size() % TAB_WIDTH, ' ');
+        } else if (c == '\r') {
+            continue;
+        } else if (static_cast<unsigned char>(c) < 32 || c == 127) {
+            line += '.';
+        } else {
+            line += c;
+        }
+    }
+    if (!line.empty()) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+Previewer::Preview errorPreview(const std::string& message) {
+    Previewer::Preview preview;
+    preview.kind = "error";
+    preview.lines.push_back(message);
+    return preview;
+}
+
+// What a file that is not read is, in place of its contents
+Previewer::Preview specialPreview(mode_t mode) {
+    Previewer::Preview preview;
+    preview.kind = "special";
+    const char* what = S_ISFIFO(mode)   ? "Named pipe"
+                       : S_ISSOCK(mode) ? "Socket"
+                       : S_ISCHR(mode)  ? "Character device"
+                       : S_ISBLK(mode)  ? "Block device"
+                                        : "Special file";
+    preview.lines.push_back(std::string(what) + " (not previewed)");
+    return preview;
+}
+
+// Read up to size bytes, retrying short reads
+size_t readFully(int fd, char* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t count = read(fd, buffer + total, size - total);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        total += count;
+    }
+    return total;
+}
+
+} // namespace
+
+Previewer::Previewer(size_t cacheEntries) : shared_(std::make_shared<Shared>()) {
+    shared_->capacity = cacheEntries;
+    // The thread holds its own reference, so it can finish after the Previewer is gone
+    std::thread(run, shared_).detach();
+}
+
+Previewer::~Previewer() {
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->stopping = true;
+        shared_->cancelled = true;
+    }
+    shared_->requested.notify_all();
+}
+
+bool Previewer::request(const std::string& path, const FileInfo& info, Preview& preview) {
+    std::string key = keyOf(path, info);
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    auto it = shared_->cache.find(key);
+    if (it != shared_->cache.end()) {
+        shared_->lru.splice(shared_->lru.begin(), shared_->lru, it->second.position);
+        preview = it->second.preview;
+        return true;
+    }
+    if (key != shared_->wantedKey) {
+        // The previous item is no longer on screen
+        shared_->cancelled = true;
+        shared_->wantedKey = key;
+        shared_->wantedPath = path;
+        shared_->wantedType = info.getType();
+        shared_->hasWork = true;
+        shared_->requested.notify_all();
+    }
+    return false;
+}
+
+void Previewer::clear() {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->cache.clear();
+    shared_->lru.clear();
+    shared_->wantedKey.clear();
+}
+
+std::string Previewer::keyOf(const std::string& path, const FileInfo& info) {
+    return path + '\0' + std::to_string(info.getSize()) + '\0' +
+           std::to_string(info.getModifiedTime().time_since_epoch().count());
+}
+
+void Previewer::run(std::shared_ptr<Shared> shared) {
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    while (true) {
+        shared->requested.wait(lock, [&] { return shared->stopping || shared->hasWork; });
+        if (shared->stopping) {
+            return;
+        }
+        std::string key = shared->wantedKey;
+        std::string path = shared->wantedPath;
+        FileInfo::FileType type = shared->wantedType;
+        shared->hasWork = false;
+        shared->cancelled = false;
+        lock.unlock();
+
+        Preview preview = generate(path, type, &shared->cancelled);
+
+        lock.lock();
+        if (shared->cancelled || key != shared->wantedKey) {
+            continue;
+        }
+        shared->lru.push_front(key);
+        shared->cache[key] = Entry{std::move(preview), shared->lru.begin()};
+        while (shared->cache.size() > shared->capacity) {
+            shared->cache.erase(shared->lru.back());
+            shared->lru.pop_back();
+        }
+    }
+}
+
+Previewer::Preview Previewer::generate(const std::string& path, FileInfo::FileType type,
+                                       const std::atomic<bool>* cancelled) {
+    Preview preview;
+    if (type == FileInfo::FileType::DIRECTORY) {
+        std::vector<FileInfo> entries;
+        try {
+            entries = FileSystem::listDirectory(path, cancelled);
+        } catch (const std::runtime_error& ex) {
+            return errorPreview(ex.what());
+        }
+        std::sort(entries.begin(), entries.end(), [](const FileInfo& a, const FileInfo& b) {
+            bool aDirectory = a.getType() == FileInfo::FileType::DIRECTORY;
+            bool bDirectory = b.getType() == FileInfo::FileType::DIRECTORY;
+            if (aDirectory != bDirectory) {
+                return aDirectory;
+            }
+            return a.getName() < b.getName();
+        });
+        preview.kind = "directory";
+        for (const auto& entry : entries) {
+            if (preview.lines.size() + 1 >= MAX_LINES && entries.size() > MAX_LINES) {
+                preview.lines.push_back("... " + std::to_string(entries.size() - preview.lines.size()) + " more");
+                break;
+            }
+            bool directory = entry.getType() == FileInfo::FileType::DIRECTORY;
+            preview.lines.push_back(entry.getName() + (directory ? "/" : ""));
+        }
+        if (entries.empty()) {
+            preview.lines.push_back("(empty)");
+        }
+        return preview;
+    }
+
+    // Pipes, sockets and devices are left alone: opening or reading one
+    // can block, or consume data meant for someone else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return errorPreview("Cannot open " + path + ": " + strerror(errno));
+    }
+    if (S_ISDIR(st.st_mode)) {
+        // A symlink to a directory
+        return generate(path, FileInfo::FileType::DIRECTORY, cancelled);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        return specialPreview(st.st_mode);
+    }
+    // Non-blocking in case the path was swapped for a pipe since the stat
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return errorPreview("Cannot open " + path + ": " + strerror(errno));
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return errorPreview("Cannot open " + path + ": " + strerror(errno));
+    }
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        return specialPreview(st.st_mode);
+    }
+
+    // Read the start of the file; gzip is decompressed on the way
+    std::string data(READ_BYTES, '\0');
+    size_t count = readFully(fd, &data[0], data.size());
+    if (cancelled && *cancelled) {
+        close(fd);
+        return preview;
+    }
+    if (count >= 2 && static_cast<unsigned char>(data[0]) == 0x1f && static_cast<unsigned char>(data[1]) == 0x8b) {
+        // gzclose() closes the descriptor
+        gzFile gz = lseek(fd, 0, SEEK_SET) == 0 ? gzdopen(fd, "rb") : nullptr;
+        if (!gz) {
+            close(fd);
+            return errorPreview("Cannot open " + path);
+        }
+        int read = gzread(gz, &data[0], static_cast<unsigned>(data.size()));
+        gzclose(gz);
+        data.resize(read > 0 ? read : 0);
+        preview.kind = "gzip";
+    } else {
+        close(fd);
+        data.resize(count);
+        preview.kind = "text";
+    }
+
+    if (HexFormat::looksBinary(data.data(), data.size())) {
+        preview.kind = "hex";
+        for (uint64_t offset = 0; offset < data.size() && preview.lines.size() < MAX_LINES;
+             offset += HEX_ROW_BYTES) {
+            preview.lines.push_back(HexFormat::formatRow(data.data(), data.size(), offset, HEX_ROW_BYTES));
+        }
+    } else {
+        preview.lines = textLines(data, MAX_LINES);
+    }
+    if (preview.lines.empty()) {
+        preview.lines.push_back("(empty)");
+    }
+    return preview;
+}
@@ -0,0 +1,101 @@
+#include "io/AccessHints.h"
+#include "search/Search.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string makeTempDir() {
+    char pattern[] = "/tmp/accesshints_test_XXXXXX";
+    assert(mkdtemp(pattern) != nullptr);
+    return pattern;
+}
+
+static void writeFile(const std::string& path, const std::string& contents) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    assert(write(fd, contents.data(), contents.size()) == (ssize_t)contents.size());
+    close(fd);
+}
+
+static bool found(const std::vector<std::string>& results, const std::string& path) {
+    return std::find(results.begin(), results.end(), path) != results.end();
+}
+
+void testContentSearch() {
+    std::cout << "Testing chunked content search..." << std::endl;
+
+    std::string dir = makeTempDir();
+
+    // A match straddling the boundary between two read chunks
+    std::string straddle(Search::READ_CHUNK - 3, 'a');
+    straddle += "NEEDLE";
+    straddle += std::string(100, 'b');
+    writeFile(dir + "/straddle", straddle);
+    writeFile(dir + "/lines", "first line\nsecond line\n");
+    writeFile(dir + "/empty", "");
+
+    auto results = Search::searchByContent(dir, "NEEDLE", false);
+    assert(results.size() == 1 && found(results, dir + "/straddle"));
+
+    // Matching stays per line: patterns never span a newline
+    assert(Search::searchByContent(dir, "line\nsecond", false).empty());
+    results = Search::searchByContent(dir, "second line", false);
+    assert(results.size() == 1 && found(results, dir + "/lines"));
+
+    // An empty pattern matches every non-empty file
+    results = Search::searchByContent(dir, "", false);
+    assert(results.size() == 2 && !found(results, dir + "/empty"));
+
+    unlink((dir + "/straddle").c_str());
+    unlink((dir + "/lines").c_str());
+    unlink((dir + "/empty").c_str());
+    rmdir(dir.c_str());
+    std::cout << "testContentSearch passed" << std::endl;
+}
+
+void testFootprint() {
+    std::cout << "Testing cache footprint..." << std::endl;
+
+    std::string dir = makeTempDir();
+    std::string path = dir + "/warm";
+    std::string contents(1 << 20, 'x');
+    writeFile(path, contents);
+
+    int fd = open(path.c_str(), O_RDONLY);
+    assert(fd >= 0);
+
+    // Just written, so cached; a footprint taken now must not drop those pages
+    uint64_t before = CacheFootprint::residentPages(fd, contents.size());
+    CacheFootprint footprint(fd, contents.size());
+    AccessHints::sequential(fd);
+    AccessHints::willNeed(fd, 0, contents.size());
+    footprint.release();
+    assert(CacheFootprint::residentPages(fd, contents.size()) >= before);
+
+    // Hints on odd ranges and empty files are harmless
+    AccessHints::dontNeed(fd, 12345, 0);
+    AccessHints::mappedWillNeed(nullptr, 100);
+    CacheFootprint empty(fd, 0);
+    empty.release();
+    assert(CacheFootprint::residentPages(fd, 0) == 0);
+
+    close(fd);
+    unlink(path.c_str());
+    rmdir(dir.c_str());
+    std::cout << "testFootprint passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running AccessHints tests..." << std::endl;
+
+    testContentSearch();
+    testFootprint();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
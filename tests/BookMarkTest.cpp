@@ -4,6 +4,9 @@
 #include <unistd.h>
 #include <fstream>
 #include <pwd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <string>
 
 void testAddBookMark() {
     // Clear any existing bookmarks
@@ -89,15 +92,118 @@ void testSaveAndLoadBookMarks() {
     }
     std::string bookmarksFile = std::string(homeDir) + "/.bookmarks.txt";
     unlink(bookmarksFile.c_str());
+    unlink((std::string(homeDir) + "/.bookmarks.journal").c_str());
     
     std::cout << "testSaveAndLoadBookMarks passed\n";
 }
 
+// Point HOME at a fresh directory for the journal tests
+static std::string useTemporaryHome() {
+    char pattern[] = "/tmp/bookmark_test_XXXXXX";
+    std::string home = mkdtemp(pattern);
+    setenv("HOME", home.c_str(), 1);
+    return home;
+}
+
+static off_t fileSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? info.st_size : -1;
+}
+
+static void removeHome(const std::string& home) {
+    unlink((home + "/.bookmarks.txt").c_str());
+    unlink((home + "/.bookmarks.journal").c_str());
+    rmdir(home.c_str());
+}
+
+void testIncrementalSave() {
+    std::string previousHome = getenv("HOME") ? getenv("HOME") : "";
+    std::string home = useTemporaryHome();
+    std::string journal = home + "/.bookmarks.journal";
+    
+    // Loading and saving without changes writes nothing
+    assert(BookMark::loadBookMarks() && BookMark::bookMarks.empty());
+    assert(BookMark::saveBookMarks());
+    assert(fileSize(journal) == -1);
+    
+    // Only the change is appended
+    BookMark::addBookMark("/one");
+    assert(BookMark::saveBookMarks());
+    assert(fileSize(journal) == (off_t)std::string("+/one\n").size());
+    assert(BookMark::saveBookMarks());
+    assert(fileSize(journal) == (off_t)std::string("+/one\n").size());
+    
+    // A line cut short by a crash is ignored, and dropped by the next save
+    {
+        std::ofstream out(journal, std::ios::app);
+        out << "+/tor";
+    }
+    assert(BookMark::loadBookMarks() && BookMark::bookMarks.size() == 1);
+    BookMark::addBookMark("/two");
+    assert(BookMark::saveBookMarks());
+    assert(BookMark::loadBookMarks());
+    assert(BookMark::bookMarks.size() == 2 && BookMark::bookMarks[1] == "/two");
+    
+    // Removing and clearing are replayed too
+    BookMark::removeBookMark("/one");
+    assert(BookMark::saveBookMarks() && BookMark::loadBookMarks());
+    assert(BookMark::bookMarks.size() == 1 && BookMark::bookMarks[0] == "/two");
+    BookMark::emptyBookMarks();
+    BookMark::addBookMark("/three");
+    assert(BookMark::saveBookMarks() && BookMark::loadBookMarks());
+    assert(BookMark::bookMarks.size() == 1 && BookMark::bookMarks[0] == "/three");
+    
+    // A long journal is folded into the snapshot
+    for (int i = 0; i < BookMark::JOURNAL_COMPACT_BYTES / 8; i++) {
+        BookMark::addBookMark("/compact/" + std::to_string(i));
+        assert(BookMark::saveBookMarks());
+    }
+    assert(fileSize(journal) < BookMark::JOURNAL_COMPACT_BYTES);
+    assert(fileSize(home + "/.bookmarks.txt") > 0);
+    size_t count = BookMark::bookMarks.size();
+    assert(BookMark::loadBookMarks() && BookMark::bookMarks.size() == count);
+    assert(BookMark::bookMarks[0] == "/three");
+    
+    BookMark::emptyBookMarks();
+    BookMark::loadBookMarks();
+    removeHome(home);
+    setenv("HOME", previousHome.c_str(), 1);
+    std::cout << "testIncrementalSave passed\n";
+}
+
+void testConcurrentWriters() {
+    std::string previousHome = getenv("HOME") ? getenv("HOME") : "";
+    std::string home = useTemporaryHome();
+    
+    // Processes that load, add one bookmark and save at the same time keep every change
+    const int writers = 8;
+    for (int i = 0; i < writers; i++) {
+        if (fork() == 0) {
+            BookMark::loadBookMarks();
+            BookMark::addBookMark("/writer/" + std::to_string(i));
+            _exit(BookMark::saveBookMarks() ? 0 : 1);
+        }
+    }
+    for (int i = 0; i < writers; i++) {
+        int status = 0;
+        wait(&status);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    assert(BookMark::loadBookMarks());
+    assert(BookMark::bookMarks.size() == writers);
+    
+    removeHome(home);
+    setenv("HOME", previousHome.c_str(), 1);
+    std::cout << "testConcurrentWriters passed\n";
+}
+
 int main() {
     testAddBookMark();
     testRemoveBookMark();
     testEmptyBookMarks();
     testSaveAndLoadBookMarks();
+    testIncrementalSave();
+    testConcurrentWriters();
     
     std::cout << "All tests passed!\n";
     return 0;
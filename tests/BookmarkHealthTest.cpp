@@ -0,0 +1,162 @@
+#include "bookmark/BookmarkHealth.h"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+void testRealPaths() {
+    std::cout << "Testing checks of real paths..." << std::endl;
+
+    BookmarkHealth health({"/tmp", "/definitely/not/here", "/etc/hostname/below-a-file"});
+    std::vector<BookmarkHealth::Result> results = health.wait();
+    assert(health.done());
+    assert(results.size() == 3);
+    assert(results[0].path == "/tmp" && results[0].status == BookmarkHealth::Status::EXISTS);
+    assert(results[1].status == BookmarkHealth::Status::MISSING);
+    assert(results[2].status == BookmarkHealth::Status::MISSING);
+
+    assert(BookmarkHealth::classify(EACCES) == BookmarkHealth::Status::DENIED);
+    assert(BookmarkHealth::classify(EIO) == BookmarkHealth::Status::FAILED);
+    std::cout << "testRealPaths passed" << std::endl;
+}
+
+void testConcurrencyAndTimeout() {
+    std::cout << "Testing concurrent checks and the timeout..." << std::endl;
+
+    // Slow paths are checked in parallel, and one hung path does not hold them up
+    auto checker = [](const std::string& path) {
+        if (path == "/hung") {
+            std::this_thread::sleep_for(std::chrono::seconds(2));
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return path == "/gone" ? ENOENT : (path == "/broken" ? EIO : 0);
+    };
+    std::vector<std::string> paths = {"/hung", "/gone", "/broken"};
+    for (int i = 0; i < 8; i++) {
+        paths.push_back("/slow" + std::to_string(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BookmarkHealth health(paths, std::chrono::milliseconds(500), checker);
+    assert(!health.done());
+    assert(health.results()[1].status == BookmarkHealth::Status::PENDING);
+    std::vector<BookmarkHealth::Result> results = health.wait();
+    auto took = std::chrono::steady_clock::now() - start;
+
+    assert(took < std::chrono::milliseconds(1500));
+    assert(results[0].status == BookmarkHealth::Status::TIMED_OUT);
+    assert(results[1].status == BookmarkHealth::Status::MISSING);
+    assert(results[2].status == BookmarkHealth::Status::FAILED && !results[2].error.empty());
+    for (size_t i = 3; i < results.size(); i++) {
+        assert(results[i].status == BookmarkHealth::Status::EXISTS);
+    }
+    std::cout << "testConcurrencyAndTimeout passed" << std::endl;
+}
+
+void testPerPathTimeout() {
+    std::cout << "Testing per-path timeouts and replaced workers..." << std::endl;
+
+    // Every worker starts on a hung path; the healthy paths behind them are
+    // more than the timeout's worth of work in total and must still pass
+    auto checker = [](const std::string& path) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(path.compare(0, 5, "/hang") == 0 ? 1500 : 100));
+        return 0;
+    };
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < BookmarkHealth::MAX_WORKERS; i++) {
+        paths.push_back("/hang" + std::to_string(i));
+    }
+    for (int i = 0; i < 40; i++) {
+        paths.push_back("/healthy" + std::to_string(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BookmarkHealth health(paths, std::chrono::milliseconds(300), checker);
+    std::vector<BookmarkHealth::Result> results = health.wait();
+    auto took = std::chrono::steady_clock::now() - start;
+
+    assert(took < std::chrono::milliseconds(1400));
+    for (size_t i = 0; i < results.size(); i++) {
+        assert(results[i].status ==
+               (i < BookmarkHealth::MAX_WORKERS ? BookmarkHealth::Status::TIMED_OUT : BookmarkHealth::Status::EXISTS));
+    }
+
+    // The hung workers no longer hold up later checks
+    BookmarkHealth later({"/healthy-later"}, std::chrono::milliseconds(300), checker);
+    assert(later.wait()[0].status == BookmarkHealth::Status::EXISTS);
+    std::cout << "testPerPathTimeout passed" << std::endl;
+}
+
+void testSharedWorkers() {
+    std::cout << "Testing the shared, bounded workers..." << std::endl;
+
+    std::mutex mutex;
+    std::map<std::string, int> calls;
+    int running = 0;
+    int mostRunning = 0;
+    auto checker = [&](const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            calls[path]++;
+            mostRunning = std::max(mostRunning, ++running);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(path == "/stuck" ? 1000 : 50));
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        return 0;
+    };
+
+    // Two checks of the same paths at once share the answers
+    std::vector<std::string> paths;
+    for (int i = 0; i < 20; i++) {
+        paths.push_back("/shared" + std::to_string(i));
+    }
+    BookmarkHealth first(paths, std::chrono::milliseconds(5000), checker);
+    BookmarkHealth second(paths, std::chrono::milliseconds(5000), checker);
+    std::vector<BookmarkHealth::Result> results = second.wait();
+    assert(first.wait().size() == 20);
+    for (const auto& result : results) {
+        assert(result.status == BookmarkHealth::Status::EXISTS);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(calls.size() == 20);
+        for (const auto& call : calls) {
+            assert(call.second == 1);
+        }
+        assert(mostRunning <= (int)BookmarkHealth::MAX_WORKERS);
+    }
+
+    // Checking again and again while a path hangs starts no new threads for it
+    for (int i = 0; i < 5; i++) {
+        BookmarkHealth health({"/stuck"}, std::chrono::milliseconds(50), checker);
+        assert(health.wait()[0].status == BookmarkHealth::Status::TIMED_OUT);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(calls["/stuck"] == 1);
+    }
+    // Let the stuck check finish before the checker goes out of scope
+    BookmarkHealth({"/stuck"}, std::chrono::milliseconds(5000), checker).wait();
+
+    std::cout << "testSharedWorkers passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running BookmarkHealth tests..." << std::endl;
+
+    testRealPaths();
+    testConcurrencyAndTimeout();
+    testPerPathTimeout();
+    testSharedWorkers();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "viewer/CompressedFile.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+#include <zlib.h>
+
+static std::string tempPath() {
+    char pattern[] = "/tmp/compressedfile_test_XXXXXX";
+    int fd = mkstemp(pattern);
+    assert(fd >= 0);
+    close(fd);
+    return pattern;
+}
+
+// Append one gzip member holding the given text
+static void appendGzipMember(const std::string& path, const std::string& text) {
+    gzFile out = gzopen(path.c_str(), "ab");
+    assert(out);
+    assert(gzwrite(out, text.data(), (unsigned)text.size()) == (int)text.size());
+    gzclose(out);
+}
+
+static std::string makeLines(uint64_t first, uint64_t count) {
+    std::string text;
+    for (uint64_t i = first; i < first + count; i++) {
+        // Varying lengths, with some repetition for deflate to refer back to
+        text += "line " + std::to_string(i) + " " + std::string(i % 53, (char)('a' + i % 26)) + "\n";
+    }
+    return text;
+}
+
+void testRandomAccess() {
+    std::cout << "Testing checkpointed random access..." << std::endl;
+
+    std::string path = tempPath();
+    std::string text = makeLines(0, 100000);
+    appendGzipMember(path, text);
+
+    assert(CompressedFile::detect(path) == CompressedFile::Format::GZIP);
+    CompressedFile file;
+    assert(file.open(path, 64 << 10));
+    file.waitForIndex();
+    assert(file.complete());
+    assert(file.error().empty());
+    assert(file.size() == text.size());
+    assert(file.knownLines() == 100000);
+    assert(file.checkpointCount() > 10);
+
+    // Reads deep into the file, out of order, across block boundaries
+    const uint64_t offsets[] = {text.size() - 100, 12345, CompressedFile::BLOCK_SIZE - 7, 0, text.size() / 2};
+    for (uint64_t offset : offsets) {
+        std::string out;
+        assert(file.read(offset, 100, out));
+        assert(out == text.substr(offset, 100));
+    }
+    std::string tail;
+    assert(file.read(text.size() - 10, 100, tail) && tail == text.substr(text.size() - 10));
+
+    std::string line;
+    const uint64_t probes[] = {99999, 0, 64, 65, 50000, 1};
+    for (uint64_t n : probes) {
+        assert(file.line(n, line));
+        assert(line + "\n" == makeLines(n, 1));
+    }
+    assert(!file.line(100000, line));
+    assert(file.lineAtOffset(text.find("line 777 ")) == 777);
+
+    unlink(path.c_str());
+    std::cout << "testRandomAccess passed" << std::endl;
+}
+
+void testBoundedIndex() {
+    std::cout << "Testing bounded checkpoints and members..." << std::endl;
+
+    // Several members, the last one without a final newline
+    std::string path = tempPath();
+    std::string text;
+    for (int member = 0; member < 4; member++) {
+        std::string part = makeLines(member * 30000, 30000);
+        appendGzipMember(path, part);
+        text += part;
+    }
+    appendGzipMember(path, "unterminated");
+    text += "unterminated";
+
+    // A tiny span would need thousands of checkpoints; the cap thins them
+    CompressedFile file;
+    assert(file.open(path, 1024));
+    file.waitForIndex();
+    assert(file.error().empty());
+    assert(file.size() == text.size());
+    assert(file.checkpointCount() <= CompressedFile::MAX_CHECKPOINTS);
+    assert(file.knownLines() == 120001);
+
+    std::string line;
+    assert(file.line(120000, line) && line == "unterminated");
+    assert(file.line(89999, line) && line + "\n" == makeLines(89999, 1));
+    std::string out;
+    assert(file.read(text.size() / 3, 5000, out) && out == text.substr(text.size() / 3, 5000));
+
+    unlink(path.c_str());
+    std::cout << "testBoundedIndex passed" << std::endl;
+}
+
+void testNotCompressed() {
+    std::cout << "Testing plain and corrupt input..." << std::endl;
+
+    std::string path = tempPath();
+    {
+        FILE* out = fopen(path.c_str(), "w");
+        fputs("plain text\n", out);
+        fclose(out);
+    }
+    assert(CompressedFile::detect(path) == CompressedFile::Format::NONE);
+    CompressedFile file;
+    assert(!file.open(path));
+
+    // A gzip file cut short still shows what could be decompressed
+    appendGzipMember(path + ".gz", makeLines(0, 5000));
+    assert(truncate((path + ".gz").c_str(), 4000) == 0);
+    assert(file.open(path + ".gz"));
+    file.waitForIndex();
+    assert(!file.error().empty());
+    assert(file.knownLines() > 0);
+    std::string line;
+    assert(file.line(0, line) && line == "line 0 ");
+
+    unlink(path.c_str());
+    unlink((path + ".gz").c_str());
+    std::cout << "testNotCompressed passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running CompressedFile tests..." << std::endl;
+
+    testRandomAccess();
+    testBoundedIndex();
+    testNotCompressed();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "viewer/ContentSearch.h"
+#include "viewer/MappedFile.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <cstdlib>
+#include <unistd.h>
+
+static std::string writeTempFile(const std::string& contents) {
+    char pattern[] = "/tmp/contentsearch_test_XXXXXX";
+    int fd = mkstemp(pattern);
+    assert(fd >= 0);
+    assert(write(fd, contents.data(), contents.size()) == (ssize_t)contents.size());
+    close(fd);
+    return pattern;
+}
+
+static ContentSearch::State waitFor(ContentSearch& search) {
+    while (search.state() == ContentSearch::State::RUNNING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return search.state();
+}
+
+void testFindInRange() {
+    std::cout << "Testing ranged find..." << std::endl;
+
+    // Hits at every alignment relative to the 16-byte blocks
+    for (size_t offset = 0; offset < 40; offset++) {
+        for (const std::string& needle : {std::string("x"), std::string("needle"), std::string(20, 'n')}) {
+            std::string haystack(offset, 'a');
+            haystack += needle;
+            haystack += std::string(37, 'b');
+            uint64_t found = 0;
+            assert(ContentSearch::findForward(haystack.data(), 0, haystack.size(), needle, found));
+            assert(found == offset);
+            assert(ContentSearch::findBackward(haystack.data(), 0, haystack.size(), needle, found));
+            assert(found == offset);
+
+            // The range limits where a match may lie
+            assert(!ContentSearch::findForward(haystack.data(), offset + 1, haystack.size(), needle, found));
+            assert(!ContentSearch::findBackward(haystack.data(), 0, offset + needle.size() - 1, needle, found));
+        }
+    }
+
+    // First/last byte candidates that fail the full compare are skipped
+    std::string text = "abXdab abcd abXd abcd";
+    uint64_t found = 0;
+    assert(ContentSearch::findForward(text.data(), 0, text.size(), "abcd", found) && found == 7);
+    assert(ContentSearch::findBackward(text.data(), 0, text.size(), "abcd", found) && found == 17);
+
+    std::cout << "testFindInRange passed" << std::endl;
+}
+
+void testBackgroundSearch() {
+    std::cout << "Testing background search..." << std::endl;
+
+    // Larger than a chunk, with a match straddling the first chunk boundary
+    std::string contents(ContentSearch::CHUNK + 4096, '.');
+    contents.replace(ContentSearch::CHUNK - 3, 6, "TARGET");
+    contents.replace(100, 6, "TARGET");
+    std::string path = writeTempFile(contents);
+    MappedFile file;
+    assert(file.open(path));
+    ContentSearch search(file);
+
+    search.start("TARGET", 0, true);
+    assert(waitFor(search) == ContentSearch::State::FOUND);
+    assert(search.result() == 100 && !search.wrapped());
+
+    search.start("TARGET", 101, true);
+    assert(waitFor(search) == ContentSearch::State::FOUND);
+    assert(search.result() == ContentSearch::CHUNK - 3);
+
+    // Past the last hit the search wraps to the first one
+    search.start("TARGET", ContentSearch::CHUNK, true);
+    assert(waitFor(search) == ContentSearch::State::FOUND);
+    assert(search.result() == 100 && search.wrapped());
+
+    // Backward finds the nearest hit before the position, then wraps
+    search.start("TARGET", contents.size(), false);
+    assert(waitFor(search) == ContentSearch::State::FOUND);
+    assert(search.result() == ContentSearch::CHUNK - 3);
+    search.start("TARGET", 100, false);
+    assert(waitFor(search) == ContentSearch::State::FOUND);
+    assert(search.result() == ContentSearch::CHUNK - 3 && search.wrapped());
+
+    search.start("MISSING", 0, true);
+    assert(waitFor(search) == ContentSearch::State::NOT_FOUND);
+
+    // Cancelling returns promptly and leaves no result
+    search.start("MISSING", 0, true);
+    search.cancel();
+    assert(search.state() == ContentSearch::State::CANCELLED ||
+           search.state() == ContentSearch::State::NOT_FOUND);
+
+    unlink(path.c_str());
+    std::cout << "testBackgroundSearch passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running ContentSearch tests..." << std::endl;
+
+    testFindInRange();
+    testBackgroundSearch();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "listing/DirectoryLoader.h"
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+static bool waitFor(DirectoryLoader& loader, DirectoryLoader::Result& result) {
+    for (int i = 0; i < 500; i++) {
+        if (loader.poll(result, milliseconds(10))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void testLoad() {
+    std::cout << "Testing asynchronous listing..." << std::endl;
+
+    char pattern[] = "/tmp/loader_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    std::ofstream(dir + "/one") << "1";
+    std::ofstream(dir + "/two") << "22";
+
+    DirectoryLoader loader;
+    uint64_t id = loader.request(dir);
+    DirectoryLoader::Result result;
+    assert(waitFor(loader, result));
+    assert(result.request == id && result.path == dir);
+    assert(result.state == DirectoryLoader::State::DONE);
+    assert(result.entries.size() == 2);
+    assert(loader.state() == DirectoryLoader::State::DONE);
+
+    // The result is handed over once
+    assert(!loader.poll(result));
+
+    // Errors are reported rather than thrown
+    loader.request(dir + "/missing");
+    assert(waitFor(loader, result));
+    assert(result.state == DirectoryLoader::State::FAILED && !result.error.empty());
+
+    unlink((dir + "/one").c_str());
+    unlink((dir + "/two").c_str());
+    rmdir(dir.c_str());
+    std::cout << "testLoad passed" << std::endl;
+}
+
+// A lister that blocks on paths starting with "hang" until released
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable opened;
+    bool open = false;
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open = true;
+        opened.notify_all();
+    }
+};
+
+void testSupersededAndTimeout() {
+    std::cout << "Testing superseded and hung requests..." << std::endl;
+
+    auto gate = std::make_shared<Gate>();
+    DirectoryLoader::Lister lister = [gate](const std::string& path, const std::atomic<bool>*) {
+        if (path.compare(0, 4, "hang") == 0) {
+            std::unique_lock<std::mutex> lock(gate->mutex);
+            gate->opened.wait(lock, [&] { return gate->open; });
+        }
+        return std::vector<FileInfo>{FileInfo(path, FileInfo::FileType::FILE, 0,
+                                              std::chrono::system_clock::time_point(), 0)};
+    };
+
+    {
+        DirectoryLoader loader(milliseconds(200), lister);
+
+        // A request that never finishes times out, leaving the loader usable
+        loader.request("hang/a");
+        DirectoryLoader::Result result;
+        assert(!loader.poll(result, milliseconds(20)));
+        assert(loader.state() == DirectoryLoader::State::LOADING);
+        assert(waitFor(loader, result));
+        assert(result.state == DirectoryLoader::State::TIMED_OUT && result.path == "hang/a");
+
+        // A hung request is superseded by the next one, whose result is the one delivered
+        loader.request("hang/b");
+        uint64_t id = loader.request("quick");
+        assert(waitFor(loader, result));
+        assert(result.request == id && result.state == DirectoryLoader::State::DONE);
+        assert(result.entries.size() == 1 && result.entries[0].getName() == "quick");
+
+        // Late results from abandoned requests are dropped
+        gate->release();
+        std::this_thread::sleep_for(milliseconds(50));
+        assert(!loader.poll(result));
+
+        // Cancelling leaves nothing to collect
+        loader.request("hang/c");
+        loader.cancel();
+        assert(loader.state() == DirectoryLoader::State::IDLE);
+        assert(!loader.poll(result));
+    }
+
+    std::cout << "testSupersededAndTimeout passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running DirectoryLoader tests..." << std::endl;
+
+    testLoad();
+    testSupersededAndTimeout();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
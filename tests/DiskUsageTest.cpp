@@ -0,0 +1,160 @@
+#include "du/DiskUsage.h"
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+static void writeFile(const std::string& path, size_t size) {
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(size, 'x');
+}
+
+// Set a directory's times an hour back, so that a change right after is
+// seen even within the same clock tick
+static void backdate(const std::string& path) {
+    struct timespec times[2];
+    times[0].tv_sec = times[1].tv_sec = time(nullptr) - 3600;
+    times[0].tv_nsec = times[1].tv_nsec = 0;
+    assert(utimensat(AT_FDCWD, path.c_str(), times, 0) == 0);
+}
+
+void testComputeCountsHardlinksOnce() {
+    std::cout << "Testing compute with hardlinks..." << std::endl;
+
+    char pattern[] = "/tmp/du_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    assert(system(("mkdir -p " + dir + "/a/b " + dir + "/c").c_str()) == 0);
+    writeFile(dir + "/a/one", 1000);
+    writeFile(dir + "/a/b/two", 2000);
+    writeFile(dir + "/c/three", 3000);
+    assert(link((dir + "/c/three").c_str(), (dir + "/a/b/three_link").c_str()) == 0);
+
+    DiskUsage usage(4);
+    DiskUsage::Usage total = usage.compute(dir);
+    assert(total.files == 3);
+    assert(total.directories == 4);
+    assert(total.allocatedBytes > 0);
+    // Directory inodes contribute their own size too
+    assert(total.apparentBytes >= 6000);
+
+    // Within a subtree the link counts as an ordinary file
+    DiskUsage::Usage subtree = usage.compute(dir + "/a");
+    assert(subtree.files == 3);
+
+    DiskUsage::Usage cached;
+    assert(usage.lookup(dir, cached));
+    assert(cached.files == total.files);
+
+    // Changing a subtree drops the cached totals above it
+    usage.invalidate(dir + "/a/b");
+    assert(!usage.lookup(dir, cached));
+    assert(!usage.lookup(dir + "/a", cached));
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testComputeCountsHardlinksOnce passed" << std::endl;
+}
+
+void testComputeAsync() {
+    std::cout << "Testing computeAsync..." << std::endl;
+
+    char pattern[] = "/tmp/du_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    for (int i = 0; i < 20; i++) {
+        std::string sub = dir + "/d" + std::to_string(i);
+        assert(system(("mkdir -p " + sub).c_str()) == 0);
+        writeFile(sub + "/f", 100);
+    }
+
+    DiskUsage usage;
+    usage.computeAsync(dir);
+    usage.computeAsync(dir); // Duplicate requests are ignored
+    DiskUsage::Usage total = usage.compute(dir);
+    assert(total.files == 20);
+    assert(usage.pendingCount() == 0);
+    assert(usage.generation() >= 1);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testComputeAsync passed" << std::endl;
+}
+
+void testReuseAndCancel() {
+    std::cout << "Testing reuse of subdirectory results and cancelling..." << std::endl;
+
+    char pattern[] = "/tmp/du_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    assert(system(("mkdir -p " + dir + "/a/b " + dir + "/c").c_str()) == 0);
+    writeFile(dir + "/top", 500);
+    writeFile(dir + "/a/one", 1000);
+    writeFile(dir + "/c/three", 3000);
+    assert(link((dir + "/c/three").c_str(), (dir + "/a/b/three_link").c_str()) == 0);
+
+    DiskUsage fresh(4);
+    DiskUsage::Usage expected = fresh.compute(dir);
+    assert(expected.files == 3);
+
+    // The parent job adds the cached subdirectory totals, still counting the
+    // file linked from both of them once
+    DiskUsage usage(4);
+    DiskUsage::Usage a = usage.compute(dir + "/a");
+    DiskUsage::Usage c = usage.compute(dir + "/c");
+    assert(a.files == 2 && c.files == 1);
+    DiskUsage::Usage total = usage.compute(dir);
+    assert(total.files == expected.files);
+    assert(total.directories == expected.directories);
+    assert(total.apparentBytes == expected.apparentBytes);
+    assert(total.allocatedBytes == expected.allocatedBytes);
+
+    // A cached subdirectory that changed after it was sized is walked again
+    DiskUsage reused(4);
+    backdate(dir + "/c");
+    backdate(dir);
+    assert(reused.compute(dir + "/c").files == 1);
+    writeFile(dir + "/c/four", 4000);
+    assert(reused.compute(dir).files == expected.files + 1);
+    DiskUsage other(4);
+    assert(other.compute(dir).files == expected.files + 1);
+
+    // revalidate() drops a cached total once its directory has changed
+    DiskUsage::Usage cached;
+    uint64_t generation = reused.generation();
+    writeFile(dir + "/five", 10);
+    reused.revalidate(dir);
+    for (int i = 0; i < 200 && reused.generation() == generation; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(!reused.lookup(dir, cached));
+    assert(reused.compute(dir).files == expected.files + 2);
+
+    // Cancelled jobs publish nothing, and asking again starts a new one
+    assert(mkdir((dir + "/many").c_str(), 0755) == 0);
+    for (int i = 0; i < 200; i++) {
+        assert(mkdir((dir + "/many/d" + std::to_string(i)).c_str(), 0755) == 0);
+    }
+    DiskUsage cancelled(2);
+    cancelled.computeAsync(dir + "/many");
+    cancelled.cancelPending();
+    DiskUsage::Usage many = cancelled.compute(dir + "/many");
+    assert(many.directories == 201);
+    assert(cancelled.pendingCount() == 0);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testReuseAndCancel passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running DiskUsage tests..." << std::endl;
+
+    testComputeCountsHardlinksOnce();
+    testComputeAsync();
+    testReuseAndCancel();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
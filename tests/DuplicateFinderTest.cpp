@@ -0,0 +1,61 @@
+#include "dupes/DuplicateFinder.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+
+static void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+}
+
+void testFindDuplicates() {
+    std::cout << "Testing findDuplicates..." << std::endl;
+
+    char pattern[] = "/tmp/dupes_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    assert(system(("mkdir -p " + dir + "/nested").c_str()) == 0);
+
+    // Large files that agree on both 4 KiB edges but differ in the middle
+    std::string large(64 * 1024, 'x');
+    std::string largeVariant = large;
+    largeVariant[32 * 1024] = 'y';
+
+    writeFile(dir + "/a.txt", "duplicate contents");
+    writeFile(dir + "/nested/b.txt", "duplicate contents");
+    writeFile(dir + "/c.txt", "different contents");
+    writeFile(dir + "/big1.bin", large);
+    writeFile(dir + "/nested/big2.bin", large);
+    writeFile(dir + "/big3.bin", largeVariant);
+    writeFile(dir + "/empty1", "");
+    writeFile(dir + "/empty2", "");
+    // A hardlink is the same file, not a duplicate
+    assert(link((dir + "/c.txt").c_str(), (dir + "/c_link.txt").c_str()) == 0);
+
+    DuplicateFinder::Report report = DuplicateFinder::findDuplicates(dir);
+
+    assert(report.groups.size() == 2);
+    assert(report.hardlinksSkipped == 1);
+    // Sorted by reclaimable bytes, so the large pair comes first
+    assert(report.groups[0].size == large.size());
+    assert(report.groups[0].paths.size() == 2);
+    assert(report.groups[0].paths[0] == dir + "/big1.bin");
+    assert(report.groups[1].paths.size() == 2);
+    assert(report.reclaimableBytes == large.size() + std::string("duplicate contents").size());
+    // Only the three large files survive the edge comparison
+    assert(report.filesFullyHashed == 3);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testFindDuplicates passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running DuplicateFinder tests..." << std::endl;
+
+    testFindDuplicates();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "fileops/FileOperations.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+static std::string makeTempDir() {
+    char pattern[] = "/tmp/fileops_test_XXXXXX";
+    char* dir = mkdtemp(pattern);
+    assert(dir != nullptr);
+    return std::string(dir);
+}
+
+static std::string readAll(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void testCopyRegularFile() {
+    std::cout << "Testing copyFile with a regular file..." << std::endl;
+
+    std::string dir = makeTempDir();
+    std::string source = dir + "/source.txt";
+    std::string destination = dir + "/destination.txt";
+    {
+        std::ofstream file(source);
+        file << "hello world\n";
+    }
+
+    FileOperations::CopyStats stats;
+    assert(FileOperations::copyFile(source, destination, stats));
+    assert(readAll(destination) == "hello world\n");
+    assert(stats.filesCopied == 1);
+    assert(stats.logicalBytes == 12);
+    assert(stats.physicalBytes == 12);
+
+    std::system(("rm -rf " + dir).c_str());
+    std::cout << "testCopyRegularFile passed" << std::endl;
+}
+
+void testCopySparseFile() {
+    std::cout << "Testing copyFile with a sparse file..." << std::endl;
+
+    std::string dir = makeTempDir();
+    std::string source = dir + "/sparse.img";
+    std::string destination = dir + "/sparse_copy.img";
+
+    // 8 MiB file with a single 4 KiB data block in the middle and a trailing hole
+    const off_t fileSize = 8 << 20;
+    const off_t dataOffset = 4 << 20;
+    int fd = open(source.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    std::string block(4096, 'x');
+    assert(pwrite(fd, block.data(), block.size(), dataOffset) == (ssize_t)block.size());
+    assert(ftruncate(fd, fileSize) == 0);
+    close(fd);
+
+    FileOperations::CopyStats stats;
+    assert(FileOperations::copyFile(source, destination, stats));
+    assert(stats.logicalBytes == (uint64_t)fileSize);
+    assert(stats.physicalBytes <= stats.logicalBytes);
+    assert(readAll(destination) == readAll(source));
+
+    struct stat sourceStat, destinationStat;
+    assert(stat(source.c_str(), &sourceStat) == 0);
+    assert(stat(destination.c_str(), &destinationStat) == 0);
+    assert(destinationStat.st_size == fileSize);
+    // Holes must not be filled in when the source has them
+    if (sourceStat.st_blocks * 512 < fileSize) {
+        assert(stats.sparseFiles == 1);
+        assert(stats.physicalBytes < stats.logicalBytes);
+        assert(destinationStat.st_blocks * 512 < fileSize);
+    }
+
+    std::system(("rm -rf " + dir).c_str());
+    std::cout << "testCopySparseFile passed" << std::endl;
+}
+
+void testCopyDirectory() {
+    std::cout << "Testing copyFile with a directory tree..." << std::endl;
+
+    std::string dir = makeTempDir();
+    std::string source = dir + "/tree";
+    assert(mkdir(source.c_str(), 0755) == 0);
+    assert(mkdir((source + "/nested").c_str(), 0755) == 0);
+    {
+        std::ofstream a(source + "/a.txt");
+        a << "a";
+        std::ofstream b(source + "/nested/b.txt");
+        b << "bb";
+    }
+
+    FileOperations::CopyStats stats;
+    assert(FileOperations::copyFile(source, dir + "/tree_copy", stats));
+    assert(readAll(dir + "/tree_copy/a.txt") == "a");
+    assert(readAll(dir + "/tree_copy/nested/b.txt") == "bb");
+    assert(stats.filesCopied == 2);
+    assert(stats.logicalBytes == 3);
+
+    // A read-only directory is filled first and locked down afterwards
+    assert(chmod((source + "/nested").c_str(), 0555) == 0);
+    FileOperations::CopyStats readOnlyStats;
+    assert(FileOperations::copyFile(source, dir + "/tree_copy2", readOnlyStats));
+    assert(readAll(dir + "/tree_copy2/nested/b.txt") == "bb");
+    struct stat copied;
+    assert(stat((dir + "/tree_copy2/nested").c_str(), &copied) == 0);
+    assert((copied.st_mode & 07777) == 0555);
+    chmod((source + "/nested").c_str(), 0755);
+    chmod((dir + "/tree_copy2/nested").c_str(), 0755);
+
+    std::system(("rm -rf " + dir).c_str());
+    std::cout << "testCopyDirectory passed" << std::endl;
+}
+
+void testMoveAcrossDevices() {
+    std::cout << "Testing moveFile across devices..." << std::endl;
+
+    // Needs two filesystems; /dev/shm is tmpfs on most Linux systems
+    std::string sourceDir = makeTempDir();
+    char pattern[] = "/dev/shm/fileops_test_XXXXXX";
+    char* targetDir = mkdtemp(pattern);
+    struct stat sourceStat, targetStat;
+    if (!targetDir || stat(sourceDir.c_str(), &sourceStat) != 0 || stat(targetDir, &targetStat) != 0 ||
+        sourceStat.st_dev == targetStat.st_dev) {
+        std::system(("rm -rf " + sourceDir).c_str());
+        if (targetDir) {
+            std::system((std::string("rm -rf ") + targetDir).c_str());
+        }
+        std::cout << "testMoveAcrossDevices skipped (no second filesystem)" << std::endl;
+        return;
+    }
+
+    std::string tree = sourceDir + "/tree";
+    assert(mkdir(tree.c_str(), 0755) == 0);
+    assert(mkdir((tree + "/nested").c_str(), 0755) == 0);
+    for (int i = 0; i < 16; i++) {
+        std::ofstream file(tree + "/nested/file" + std::to_string(i));
+        file << std::string(i * 100, 'a' + i);
+    }
+
+    std::string destination = std::string(targetDir) + "/moved";
+    FileOperations::CopyStats stats;
+    assert(FileOperations::moveFile(tree, destination, stats));
+    assert(stats.filesCopied == 16);
+    assert(!FileOperations::exists(tree));
+    assert(readAll(destination + "/nested/file7") == std::string(700, 'h'));
+
+    std::system(("rm -rf " + sourceDir).c_str());
+    std::system((std::string("rm -rf ") + targetDir).c_str());
+    std::cout << "testMoveAcrossDevices passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FileOperations tests..." << std::endl;
+
+    testCopyRegularFile();
+    testCopySparseFile();
+    testCopyDirectory();
+    testMoveAcrossDevices();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "cli/FrameRenderer.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Row = FrameRenderer::Row;
+
+// A header, `count` list rows starting at `first` with `selected` reversed, and a footer
+static std::vector<Row> listing(int first, int count, int selected) {
+    std::vector<Row> rows;
+    rows.push_back({"header", 0});
+    for (int i = first; i < first + count; i++) {
+        rows.push_back({"entry " + std::to_string(i), i == selected ? 1 : 0});
+    }
+    rows.push_back({"footer", 0});
+    return rows;
+}
+
+void testUnchangedAndMoved() {
+    std::cout << "Testing row diffing..." << std::endl;
+
+    // Nothing changed: nothing to draw
+    FrameRenderer::Plan plan = FrameRenderer::plan(listing(0, 10, 3), listing(0, 10, 3), 1, 11);
+    assert(plan.scroll == 0 && plan.dirty.empty());
+
+    // Moving the selection redraws the old and the new selected row only
+    plan = FrameRenderer::plan(listing(0, 10, 3), listing(0, 10, 4), 1, 11);
+    assert(plan.scroll == 0);
+    assert((plan.dirty == std::vector<int>{4, 5}));
+
+    // A first frame draws every row
+    plan = FrameRenderer::plan({}, listing(0, 10, 0), 1, 11);
+    assert(plan.dirty.size() == 12);
+
+    // Rows the new frame no longer has are cleared
+    plan = FrameRenderer::plan(listing(0, 10, 0), listing(0, 5, 0), 1, 6);
+    assert(plan.scroll == 0);
+    for (int row = 7; row < 12; row++) {
+        assert(std::find(plan.dirty.begin(), plan.dirty.end(), row) != plan.dirty.end());
+    }
+
+    std::cout << "testUnchangedAndMoved passed" << std::endl;
+}
+
+void testScrolling() {
+    std::cout << "Testing scroll detection..." << std::endl;
+
+    // Selection at the bottom moving down one: the list scrolls up by a row;
+    // only the old selected row, the new one and the scrolled-in row are drawn
+    FrameRenderer::Plan plan = FrameRenderer::plan(listing(0, 10, 9), listing(1, 10, 10), 1, 11);
+    assert(plan.scroll == 1);
+    assert((plan.dirty == std::vector<int>{9, 10}));
+
+    // And back up
+    plan = FrameRenderer::plan(listing(1, 10, 1), listing(0, 10, 0), 1, 11);
+    assert(plan.scroll == -1);
+    assert((plan.dirty == std::vector<int>{1, 2}));
+
+    // A jump by a whole page is a plain redraw
+    plan = FrameRenderer::plan(listing(0, 10, 9), listing(10, 10, 10), 1, 11);
+    assert(plan.scroll == 0 && plan.dirty.size() == 10);
+
+    // Regions too small to gain from scrolling are redrawn
+    plan = FrameRenderer::plan(listing(0, 2, 1), listing(1, 2, 2), 1, 3);
+    assert(plan.scroll == 0);
+
+    std::cout << "testScrolling passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FrameRenderer tests..." << std::endl;
+
+    testUnchangedAndMoved();
+    testScrolling();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
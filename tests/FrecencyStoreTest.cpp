@@ -0,0 +1,250 @@
+#include "bookmark/FrecencyStore.h"
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static std::string logPath() {
+    char pattern[] = "/tmp/frecency_test_XXXXXX";
+    int fd = mkstemp(pattern);
+    close(fd);
+    unlink(pattern);
+    return pattern;
+}
+
+// The log and its lock file
+static void removeLog(const std::string& path) {
+    unlink(path.c_str());
+    unlink((path + ".lock").c_str());
+}
+
+void testRankingAndMatching() {
+    std::cout << "Testing frecency ranking and matching..." << std::endl;
+
+    std::string path = logPath();
+    FrecencyStore store(path);
+    assert(store.load() && store.size() == 0);
+
+    const std::time_t now = 1000000000;
+    const std::time_t week = 7 * 24 * 60 * 60;
+    store.record("/home/user/src/project", now - 2 * week);
+    store.record("/home/user/src/project", now - 2 * week);
+    store.record("/home/user/src/project", now - 2 * week);
+    store.record("/srv/Projects", now - 60);
+    store.record("/home/user/docs", now - 60);
+    assert(store.size() == 3);
+
+    // Recent visits outweigh older, more frequent ones
+    auto matches = store.query({"proj"}, 10, now);
+    assert(matches.size() == 2);
+    assert(matches[0].path == "/srv/Projects");
+    assert(matches[1].path == "/home/user/src/project");
+    assert(FrecencyStore::frecency(3, now - 2 * week, now) == 0.75);
+
+    // Words match in order, the last one in the final component
+    assert(store.query({"src", "proj"}, 10, now).size() == 1);
+    assert(store.query({"proj", "src"}, 10, now).empty());
+    assert(store.query({"user"}, 10, now).empty());
+    assert(store.query({"PROJECTS"}, 10, now).size() == 1);
+
+    // Short words are matched without the index
+    assert(store.query({"do"}, 10, now).size() == 1);
+
+    // No words: everything, best first
+    matches = store.query({}, 2, now);
+    assert(matches.size() == 2 && matches[0].path == "/home/user/docs");
+
+    // Removed directories stay removed after reloading
+    assert(store.remove("/home/user/docs"));
+    assert(!store.remove("/home/user/docs"));
+    FrecencyStore reloaded(path);
+    assert(reloaded.load() && reloaded.size() == 2);
+    matches = reloaded.query({"proj"}, 10, now);
+    assert(matches.size() == 2 && matches[1].score == 0.75);
+
+    removeLog(path);
+    std::cout << "testRankingAndMatching passed" << std::endl;
+}
+
+void testLogAndCompaction() {
+    std::cout << "Testing the visit log and compaction..." << std::endl;
+
+    std::string path = logPath();
+    {
+        FrecencyStore store(path);
+        store.load();
+        for (size_t i = 0; i < FrecencyStore::COMPACT_MIN_LINES; i++) {
+            store.record("/data/dir" + std::to_string(i % 10), 1000 + i);
+        }
+        assert(store.logLines() == FrecencyStore::COMPACT_MIN_LINES);
+        // One more visit passes the limit and the log shrinks to a line per directory
+        store.record("/data/dir0", 5000);
+        assert(store.logLines() == 10 && store.size() == 10);
+    }
+
+    // A torn last line (a crash mid-write) is skipped
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "1.000\t6000\t/data/dir";
+    }
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "1.000\t6000\t/data/new\n";
+    }
+    FrecencyStore store(path);
+    assert(store.load());
+    assert(store.size() == 10);
+    auto matches = store.query({"dir0"}, 10, 5000);
+    assert(matches.size() == 1 && matches[0].score == 101 * 4);
+
+    removeLog(path);
+    std::cout << "testLogAndCompaction passed" << std::endl;
+}
+
+void testAging() {
+    std::cout << "Testing aging of old entries..." << std::endl;
+
+    std::string path = logPath();
+    FrecencyStore store(path);
+    store.load();
+    store.record("/rare", 1);
+    for (int i = 0; i < FrecencyStore::MAX_TOTAL_RANK; i++) {
+        store.record("/busy", 2);
+    }
+    // Passing the cap scales ranks down and drops what falls below one visit
+    assert(store.size() == 1);
+    assert(store.query({"rare"}, 10, 2).empty());
+    assert(store.query({"busy"}, 10, 2).size() == 1);
+
+    // A long history of single visits is within the cap, which grows with it
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 20000; i++) {
+            out << "1.000\t1\t/many/dir" << i << "\n";
+        }
+    }
+    assert(store.load() && store.size() == 20000);
+    assert(store.record("/many/new", 2));
+    assert(store.size() == 20001);
+
+    // Aging keeps the directory that pushed the total over, however new
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 2000; i++) {
+            out << "5.000\t1\t/often/dir" << i << "\n";
+        }
+    }
+    assert(store.load() && store.size() == 2000);
+    assert(store.record("/often/fresh", 2));
+    assert(store.size() == 2001);
+    auto matches = store.query({"fresh"}, 10, 2);
+    assert(matches.size() == 1 && matches[0].score == 4);
+
+    removeLog(path);
+    std::cout << "testAging passed" << std::endl;
+}
+
+// Time of one query, in milliseconds
+static double timeQuery(const FrecencyStore& store, const std::vector<std::string>& words,
+                        std::vector<FrecencyStore::Match>& matches) {
+    auto start = std::chrono::steady_clock::now();
+    matches = store.query(words, 10, 100000);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void testLookupSpeed() {
+    std::cout << "Testing lookups in a large history..." << std::endl;
+
+    std::string path = logPath();
+    FrecencyStore store(path);
+    store.load();
+    {
+        // Written as an already compacted log to keep the test quick
+        std::ofstream out(path);
+        for (int i = 0; i < 100000; i++) {
+            out << "1.000\t" << i << "\t/home/user/area" << i % 97 << "/module" << i << "/build\n";
+        }
+        out << "1.000\t5\t/home/user/area1/deep/nested/target-dir\n";
+        out << "1.000\t5\t/x/foo\n";
+        out << "1.000\t5\t/x/quiz\n";
+    }
+    assert(store.load() && store.size() == 100003);
+
+    // Visits keep the history as it is and are found straight away
+    assert(store.record("/home/user/area1/deep/nested/target-dir", 99000));
+    assert(store.record("/home/user/area2/elsewhere", 99000));
+    assert(store.size() == 100004);
+
+    std::vector<FrecencyStore::Match> matches;
+    // Only the few names holding the rarest trigram, or the bigram of a
+    // two-letter word, are looked at
+    double rare = timeQuery(store, {"target"}, matches);
+    assert(matches.size() == 1 && matches[0].path == "/home/user/area1/deep/nested/target-dir");
+    assert(store.examined() == 1);
+    double twoLetters = timeQuery(store, {"fo"}, matches);
+    assert(matches.size() == 1 && matches[0].path == "/x/foo");
+    assert(store.examined() == 1);
+    // A trigram in every name: best first, stopping once the rest score lower
+    double common = timeQuery(store, {"bui"}, matches);
+    assert(matches.size() == 10 && matches[0].score == 4);
+    assert(store.examined() < 5000);
+    double none = timeQuery(store, {}, matches);
+    assert(matches.size() == 10);
+    assert(store.examined() < 5000);
+    // One letter, in a single old directory: found however far down it ranks
+    double oneLetter = timeQuery(store, {"q"}, matches);
+    assert(matches.size() == 1 && matches[0].path == "/x/quiz");
+    std::cout << "  lookups took " << rare << ", " << twoLetters << ", " << common << ", " << none << " and "
+              << oneLetter << " ms" << std::endl;
+
+    removeLog(path);
+    std::cout << "testLookupSpeed passed" << std::endl;
+}
+
+void testConcurrentRewrite() {
+    std::cout << "Testing a rewrite while another process appends..." << std::endl;
+
+    std::string path = logPath();
+    FrecencyStore first(path);
+    FrecencyStore second(path);
+    assert(first.load() && second.load());
+    assert(first.record("/mine", 10));
+
+    // Appended after the first store read the log
+    assert(second.record("/theirs", 20));
+    assert(second.record("/theirs", 30));
+
+    // Rewriting reads the log again under the lock, so their visits stay
+    assert(first.compact());
+    assert(first.logLines() == 2 && first.size() == 2);
+    FrecencyStore reloaded(path);
+    assert(reloaded.load() && reloaded.size() == 2);
+    auto matches = reloaded.query({"theirs"}, 10, 30);
+    assert(matches.size() == 1 && matches[0].score == 2 * 4);
+
+    // No temporary files are left next to the log
+    std::string directory = path.substr(0, path.rfind('/'));
+    std::string name = path.substr(path.rfind('/') + 1);
+    std::string leftovers = "ls " + directory + " | grep -c '^" + name + "\\.' | grep -qx 1";
+    assert(system(leftovers.c_str()) == 0);
+
+    removeLog(path);
+    std::cout << "testConcurrentRewrite passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FrecencyStore tests..." << std::endl;
+
+    testRankingAndMatching();
+    testLogAndCompaction();
+    testAging();
+    testLookupSpeed();
+    testConcurrentRewrite();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
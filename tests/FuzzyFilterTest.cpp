@@ -0,0 +1,133 @@
+#include "listing/FuzzyFilter.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> namesOf(const FuzzyFilter& filter, const std::vector<std::string>& names) {
+    std::vector<std::string> result;
+    for (uint32_t index : filter.matches()) {
+        result.push_back(names[index]);
+    }
+    return result;
+}
+
+// Reference: characters of query in order, ignoring ASCII case
+static bool isSubsequence(const std::string& name, const std::string& query) {
+    size_t j = 0;
+    for (size_t i = 0; i < name.size() && j < query.size(); i++) {
+        if (tolower((unsigned char)name[i]) == tolower((unsigned char)query[j])) {
+            j++;
+        }
+    }
+    return j == query.size();
+}
+
+void testMatching() {
+    std::cout << "Testing fuzzy matching..." << std::endl;
+
+    std::vector<std::string> names = {"README.md", "CMakeLists.txt", "main.cpp", "Makefile", "src", "readme_old.txt"};
+    FuzzyFilter filter;
+    for (const auto& name : names) {
+        filter.add(name);
+    }
+    assert(filter.size() == names.size());
+
+    // No query: everything, in order
+    assert(filter.matches().size() == names.size() && filter.matches()[2] == 2);
+
+    filter.setQuery("mk");
+    std::vector<std::string> found = namesOf(filter, names);
+    assert(found.size() == 2);
+    assert(std::find(found.begin(), found.end(), "CMakeLists.txt") != found.end());
+    assert(std::find(found.begin(), found.end(), "Makefile") != found.end());
+
+    // Case is ignored on both sides
+    filter.setQuery("RDM");
+    found = namesOf(filter, names);
+    assert(found.size() == 2);
+
+    filter.setQuery("zzz");
+    assert(filter.matches().empty());
+    filter.setQuery("");
+    assert(filter.matches().size() == names.size());
+
+    std::cout << "testMatching passed" << std::endl;
+}
+
+void testIncremental() {
+    std::cout << "Testing narrowing and widening..." << std::endl;
+
+    // Names with letters spread at varied places, longer than one 16-byte block
+    std::vector<std::string> names;
+    for (int i = 0; i < 3000; i++) {
+        std::string name;
+        unsigned value = i * 2654435761u;
+        for (int k = 0; k < 5 + i % 40; k++) {
+            name += "abcdefghij_.XYZ0123"[(value >> (k % 27)) % 19];
+            value = value * 1103515245u + 12345u;
+        }
+        names.push_back(name);
+    }
+    FuzzyFilter incremental;
+    for (const auto& name : names) {
+        incremental.add(name);
+    }
+
+    // Typing, deleting and retyping must agree with a from-scratch filter
+    const char* steps[] = {"a", "ab", "abc", "abcx", "ab", "a_", "a_.", "", "j0", "j0z", "b"};
+    for (const char* query : steps) {
+        incremental.setQuery(query);
+        FuzzyFilter fresh;
+        for (const auto& name : names) {
+            fresh.add(name);
+        }
+        fresh.setQuery(query);
+        assert(incremental.matches() == fresh.matches());
+
+        size_t expected = std::count_if(names.begin(), names.end(),
+                                        [&](const std::string& name) { return isSubsequence(name, query); });
+        assert(incremental.matches().size() == expected);
+        for (uint32_t index : incremental.matches()) {
+            assert(isSubsequence(names[index], query));
+        }
+    }
+
+    std::cout << "testIncremental passed" << std::endl;
+}
+
+void testRanking() {
+    std::cout << "Testing ranking..." << std::endl;
+
+    std::vector<std::string> names = {"a_long_prefix_then_conf", "xconfigx", "config.h", "c_o_n_f", "configure.ac"};
+    FuzzyFilter filter(2);
+    for (const auto& name : names) {
+        filter.add(name);
+    }
+    filter.setQuery("conf");
+    std::vector<std::string> found = namesOf(filter, names);
+    assert(found.size() == 5);
+
+    // The two best are prefix matches, shorter first; the rest keep their order
+    assert(found[0] == "config.h");
+    assert(found[1] == "configure.ac");
+    assert(found[2] == "a_long_prefix_then_conf" && found[3] == "xconfigx" && found[4] == "c_o_n_f");
+
+    // Starts and separators beat scattered matches
+    assert(FuzzyFilter::score("config.h", 8, "ch") > FuzzyFilter::score("xcxxxxxh", 8, "ch"));
+    assert(FuzzyFilter::score("conf", 4, "conf") > FuzzyFilter::score("c_o_n_f", 7, "conf"));
+
+    std::cout << "testRanking passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FuzzyFilter tests..." << std::endl;
+
+    testMatching();
+    testIncremental();
+    testRanking();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "hash/FastHash.h"
+#include "hash/Sha256.h"
+#include "hash/Checksum.h"
+#include <cassert>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+void testFastHashVectors() {
+    std::cout << "Testing FastHash reference vectors..." << std::endl;
+
+    // Reference values from the xxHash project (XXH64, seed 0)
+    assert(FastHash::hash("", 0) == 0xEF46DB3751D8E999ULL);
+    assert(FastHash::hash("a", 1) == 0xD24EC4F1A98C6E5BULL);
+    assert(FastHash::hash("abc", 3) == 0x44BC2CF5AD770999ULL);
+    std::string fox = "The quick brown fox jumps over the lazy dog";
+    assert(FastHash::hash(fox.data(), fox.size()) == 0x0B242D361FDA71BCULL);
+
+    assert(FastHash::toHex(0xEF46DB3751D8E999ULL) == "ef46db3751d8e999");
+
+    std::cout << "testFastHashVectors passed" << std::endl;
+}
+
+void testFastHashStreaming() {
+    std::cout << "Testing FastHash streaming updates..." << std::endl;
+
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data.push_back(static_cast<char>(i * 31));
+    }
+
+    // Feeding odd-sized pieces must match hashing in one go
+    FastHash hasher(7);
+    for (size_t pos = 0; pos < data.size(); pos += 13) {
+        hasher.update(data.data() + pos, std::min<size_t>(13, data.size() - pos));
+    }
+    assert(hasher.digest() == FastHash::hash(data.data(), data.size(), 7));
+    assert(FastHash::hash(data.data(), data.size(), 7) != FastHash::hash(data.data(), data.size(), 0));
+
+    std::cout << "testFastHashStreaming passed" << std::endl;
+}
+
+void testSha256Vectors() {
+    std::cout << "Testing Sha256 reference vectors..." << std::endl;
+
+    assert(Sha256::toHex(Sha256::hash("", 0)) ==
+           "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(Sha256::toHex(Sha256::hash("abc", 3)) ==
+           "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    // 56 bytes forces the length into a second padding block
+    std::string twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    assert(Sha256::toHex(Sha256::hash(twoBlocks.data(), twoBlocks.size())) ==
+           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    std::cout << "testSha256Vectors passed" << std::endl;
+}
+
+void testChecksumChunking() {
+    std::cout << "Testing Checksum over files and trees..." << std::endl;
+
+    char pattern[] = "/tmp/hash_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    assert(system(("mkdir -p " + dir + "/tree/sub").c_str()) == 0);
+    {
+        std::ofstream a(dir + "/tree/a.txt");
+        a << "abc";
+        std::ofstream b(dir + "/tree/sub/b.txt");
+        b << "";
+    }
+
+    // Small files hash to the plain single-pass digest
+    auto results = Checksum::hashPaths({dir + "/tree"}, Checksum::Algorithm::FAST);
+    assert(results.size() == 2);
+    assert(results[0].path == dir + "/tree/a.txt");
+    assert(results[0].digest == FastHash::toHex(FastHash::hash("abc", 3)));
+
+    auto shaResults = Checksum::hashPaths({dir + "/tree/a.txt"}, Checksum::Algorithm::SHA256);
+    assert(shaResults.size() == 1);
+    assert(shaResults[0].digest == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // The tree digest only depends on relative paths and contents
+    assert(system(("cp -r " + dir + "/tree " + dir + "/copy").c_str()) == 0);
+    auto copyResults = Checksum::hashPaths({dir + "/copy"}, Checksum::Algorithm::FAST);
+    assert(Checksum::combineTree(dir + "/tree", results, Checksum::Algorithm::FAST) ==
+           Checksum::combineTree(dir + "/copy", copyResults, Checksum::Algorithm::FAST));
+
+    // A file larger than the chunk size is hashed in chunks whose digests
+    // are folded in order; with a small chunk size the split is exercised
+    // without a 64 MiB file
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data.push_back(static_cast<char>(i * 7 + i / 256));
+    }
+    {
+        std::ofstream big(dir + "/big.bin", std::ios::binary);
+        big.write(data.data(), data.size());
+    }
+    const uint64_t chunkSize = 4096;
+    FastHash folded(data.size());
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+        size_t length = std::min<size_t>(chunkSize, data.size() - offset);
+        std::string chunkDigest = FastHash::toHex(FastHash::hash(data.data() + offset, length));
+        folded.update(chunkDigest.data(), chunkDigest.size());
+    }
+    auto chunked = Checksum::hashPaths({dir + "/big.bin"}, Checksum::Algorithm::FAST, chunkSize);
+    assert(chunked.size() == 1 && chunked[0].error.empty());
+    assert(chunked[0].size == data.size());
+    assert(chunked[0].digest == FastHash::toHex(folded.digest()));
+    assert(chunked[0].digest != FastHash::toHex(FastHash::hash(data.data(), data.size())));
+    // A file no larger than one chunk is hashed whole; an exact multiple of
+    // the chunk size has no short last chunk
+    auto whole = Checksum::hashPaths({dir + "/big.bin"}, Checksum::Algorithm::FAST, data.size());
+    assert(whole[0].digest == FastHash::toHex(FastHash::hash(data.data(), data.size())));
+    auto halves = Checksum::hashPaths({dir + "/big.bin"}, Checksum::Algorithm::FAST, data.size() / 2);
+    FastHash twoChunks(data.size());
+    for (size_t offset = 0; offset < data.size(); offset += data.size() / 2) {
+        std::string chunkDigest = FastHash::toHex(FastHash::hash(data.data() + offset, data.size() / 2));
+        twoChunks.update(chunkDigest.data(), chunkDigest.size());
+    }
+    assert(halves[0].digest == FastHash::toHex(twoChunks.digest()));
+    // SHA-256 is never chunked
+    auto shaBig = Checksum::hashPaths({dir + "/big.bin"}, Checksum::Algorithm::SHA256, chunkSize);
+    assert(shaBig[0].digest == Sha256::toHex(Sha256::hash(data.data(), data.size())));
+
+    auto missing = Checksum::hashPaths({dir + "/missing"}, Checksum::Algorithm::FAST);
+    assert(missing.size() == 1 && !missing[0].error.empty());
+
+    // A tree with a file that could not be read has no digest
+    std::vector<Checksum::Result> partial = results;
+    partial[1].digest.clear();
+    partial[1].error = "Permission denied";
+    assert(Checksum::combineTree(dir + "/tree", partial, Checksum::Algorithm::FAST).empty());
+    assert(!Checksum::combineTree(dir + "/tree/", results, Checksum::Algorithm::FAST).empty());
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testChecksumChunking passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Hash tests..." << std::endl;
+
+    testFastHashVectors();
+    testFastHashStreaming();
+    testSha256Vectors();
+    testChecksumChunking();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
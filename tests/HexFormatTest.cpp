@@ -0,0 +1,98 @@
+#include "viewer/HexFormat.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void testBinaryDetection() {
+    std::cout << "Testing binary detection..." << std::endl;
+
+    std::string text = "plain text\nwith lines\n";
+    assert(!HexFormat::looksBinary(text.data(), text.size()));
+    assert(!HexFormat::looksBinary(text.data(), 0));
+
+    std::string binary = std::string("\x7f" "ELF", 4) + std::string(1, '\0') + "rest";
+    assert(HexFormat::looksBinary(binary.data(), binary.size()));
+
+    // Only the first SNIFF_BYTES are examined
+    std::string late(HexFormat::SNIFF_BYTES, 'a');
+    late += '\0';
+    assert(!HexFormat::looksBinary(late.data(), late.size()));
+
+    std::cout << "testBinaryDetection passed" << std::endl;
+}
+
+void testRowFormatting() {
+    std::cout << "Testing row formatting..." << std::endl;
+
+    std::string data = "Hello, world!\n" + std::string(1, '\0') + "\xff";
+    std::string row = HexFormat::formatRow(data.data(), data.size(), 0, 8);
+    assert(row == "0000000000  48 65 6c 6c 6f 2c 20 77  |Hello, w|");
+
+    // A short final row is padded so the ASCII column stays aligned
+    std::string last = HexFormat::formatRow(data.data(), data.size(), 8, 16);
+    assert(last == "0000000008  6f 72 6c 64 21 0a 00 ff                           |orld!...|");
+    assert(last.find('|') == HexFormat::formatRow(data.data(), data.size(), 0, 16).find('|'));
+
+    // Rows are sized to the screen in multiples of 8 bytes
+    assert(HexFormat::bytesPerRow(80) == 16);
+    assert(HexFormat::bytesPerRow(118) == 24);
+    assert(HexFormat::bytesPerRow(20) == 8);
+    int bytes = HexFormat::bytesPerRow(200);
+    assert((int)HexFormat::formatRow(data.data(), data.size(), 0, bytes).size() <= 200);
+
+    std::cout << "testRowFormatting passed" << std::endl;
+}
+
+void testParsing() {
+    std::cout << "Testing pattern and offset parsing..." << std::endl;
+
+    std::vector<uint8_t> pattern;
+    assert(HexFormat::parsePattern("de ad BE ef", pattern));
+    assert((pattern == std::vector<uint8_t>{0xde, 0xad, 0xbe, 0xef}));
+    assert(HexFormat::parsePattern("\"ELF\"", pattern));
+    assert((pattern == std::vector<uint8_t>{'E', 'L', 'F'}));
+    assert(!HexFormat::parsePattern("abc", pattern));
+    assert(!HexFormat::parsePattern("zz", pattern));
+    assert(!HexFormat::parsePattern("\"\"", pattern));
+
+    uint64_t offset = 0;
+    assert(HexFormat::parseOffset("4096", 10000, offset) && offset == 4096);
+    assert(HexFormat::parseOffset("0x1f", 10000, offset) && offset == 0x1f);
+    assert(HexFormat::parseOffset("50%", 10000, offset) && offset == 5000);
+    assert(HexFormat::parseOffset("100%", 10001, offset) && offset == 10001);
+    assert(!HexFormat::parseOffset("12ab", 10000, offset));
+    assert(!HexFormat::parseOffset("", 10000, offset));
+
+    std::cout << "testParsing passed" << std::endl;
+}
+
+void testPatternSearch() {
+    std::cout << "Testing pattern search..." << std::endl;
+
+    std::string data = std::string("ab\0cd", 5) + "xxab" + std::string("\0c", 2);
+    std::vector<uint8_t> pattern = {'b', 0, 'c'};
+    uint64_t found = 0;
+    assert(HexFormat::findPattern(data.data(), data.size(), 0, pattern, found) && found == 1);
+    assert(HexFormat::findPattern(data.data(), data.size(), 2, pattern, found) && found == 8);
+
+    // Wraps around to the start after the last hit
+    assert(HexFormat::findPattern(data.data(), data.size(), 9, pattern, found) && found == 1);
+
+    std::vector<uint8_t> missing = {'z'};
+    assert(!HexFormat::findPattern(data.data(), data.size(), 0, missing, found));
+
+    std::cout << "testPatternSearch passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running HexFormat tests..." << std::endl;
+
+    testBinaryDetection();
+    testRowFormatting();
+    testParsing();
+    testPatternSearch();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include "viewer/LineIndex.h"
+#include "viewer/LineWrapper.h"
+#include "viewer/MappedFile.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+
+static std::string writeTempFile(const std::string& contents) {
+    char pattern[] = "/tmp/lineindex_test_XXXXXX";
+    int fd = mkstemp(pattern);
+    assert(fd >= 0);
+    assert(write(fd, contents.data(), contents.size()) == (ssize_t)contents.size());
+    close(fd);
+    return pattern;
+}
+
+static std::string lineText(LineIndex& index, const MappedFile& file, uint64_t line) {
+    uint64_t start = 0, length = 0;
+    assert(index.lineRange(line, start, length));
+    return std::string(file.data() + start, length);
+}
+
+void testSmallFiles() {
+    std::cout << "Testing LineIndex on small files..." << std::endl;
+
+    const struct {
+        std::string contents;
+        uint64_t lines;
+    } cases[] = {
+        {"", 0},
+        {"a", 1},
+        {"a\n", 1},
+        {"a\nb", 2},
+        {"a\n\nb\n", 3},
+        {"\n", 1},
+    };
+
+    for (const auto& c : cases) {
+        std::string path = writeTempFile(c.contents);
+        MappedFile file;
+        assert(file.open(path));
+        LineIndex index(file);
+        assert(!index.hasLine(c.lines));
+        assert(index.complete());
+        assert(index.knownLines() == c.lines);
+        unlink(path.c_str());
+    }
+
+    std::string path = writeTempFile("first\n\nthird");
+    MappedFile file;
+    assert(file.open(path));
+    LineIndex index(file);
+    assert(lineText(index, file, 0) == "first");
+    assert(lineText(index, file, 1) == "");
+    assert(lineText(index, file, 2) == "third");
+    unlink(path.c_str());
+
+    std::cout << "testSmallFiles passed" << std::endl;
+}
+
+void testLazyIndexing() {
+    std::cout << "Testing LineIndex lazy indexing..." << std::endl;
+
+    // Enough lines to span several scan chunks and many checkpoints
+    std::string contents;
+    const uint64_t lineCount = 300000;
+    for (uint64_t i = 0; i < lineCount; i++) {
+        contents += "line " + std::to_string(i) + "\n";
+    }
+    std::string path = writeTempFile(contents);
+    MappedFile file;
+    assert(file.open(path));
+    LineIndex index(file);
+
+    // Early lines must not force a full scan
+    assert(lineText(index, file, 10) == "line 10");
+    assert(!index.complete());
+
+    assert(lineText(index, file, 12345) == "line 12345");
+    assert(lineText(index, file, LineIndex::STRIDE) == "line " + std::to_string(LineIndex::STRIDE));
+    assert(lineText(index, file, lineCount - 1) == "line " + std::to_string(lineCount - 1));
+    assert(!index.hasLine(lineCount));
+    assert(index.complete());
+    assert(index.knownLines() == lineCount);
+
+    uint64_t start = 0, length = 0;
+    assert(index.lineRange(777, start, length));
+    assert(index.lineAtOffset(start) == 777);
+    assert(index.lineAtOffset(start + length) == 777);
+    assert(index.lineAtOffset(start + length + 1) == 778);
+
+    unlink(path.c_str());
+    std::cout << "testLazyIndexing passed" << std::endl;
+}
+
+void testBackgroundIndexing() {
+    std::cout << "Testing LineIndex background indexing..." << std::endl;
+
+    // Mixed line lengths so newlines land at every position within a block
+    std::string contents;
+    const uint64_t lineCount = 200000;
+    for (uint64_t i = 0; i < lineCount; i++) {
+        contents += std::string(i % 97, 'x') + std::to_string(i) + "\n";
+    }
+    contents += "unterminated";
+    std::string path = writeTempFile(contents);
+    MappedFile file;
+    assert(file.open(path));
+    LineIndex index(file);
+
+    index.startBackgroundIndexing();
+    // Foreground lookups interleave safely with the worker
+    assert(lineText(index, file, 5) == std::string(5, 'x') + "5");
+    assert(index.lineCount() == lineCount + 1);
+    index.stopBackgroundIndexing();
+
+    assert(index.complete());
+    assert(index.progress() == 1.0);
+    const uint64_t probes[] = {0, 63, 64, 65, 128, 99999, lineCount - 1};
+    for (uint64_t line : probes) {
+        assert(lineText(index, file, line) == std::string(line % 97, 'x') + std::to_string(line));
+    }
+    assert(lineText(index, file, lineCount) == "unterminated");
+
+    unlink(path.c_str());
+    std::cout << "testBackgroundIndexing passed" << std::endl;
+}
+
+void testWrapCache() {
+    std::cout << "Testing WrapCache..." << std::endl;
+
+    std::string path = writeTempFile("short\nthe quick brown fox jumps\n" + std::string(25, 'x') + "\n");
+    MappedFile file;
+    assert(file.open(path));
+    LineIndex index(file);
+    WrapCache cache(file, index);
+
+    // Breaks at spaces where possible, hard-wraps otherwise
+    const std::vector<RowSegment>& words = cache.rows(1, 10);
+    assert(words.size() == 3);
+    assert(std::string(file.data() + words[0].start, words[0].length) == "the quick");
+    assert(std::string(file.data() + words[1].start, words[1].length) == "brown fox");
+    assert(std::string(file.data() + words[2].start, words[2].length) == "jumps");
+    assert(cache.rows(2, 10).size() == 3);
+    assert(cache.rows(0, 10).size() == 1);
+    assert(cache.rows(3, 10).empty());
+    assert(cache.size() == 3);
+
+    // Only lines asked for at the new width are rewrapped
+    assert(cache.rows(1, 40).size() == 1);
+    assert(cache.width() == 40);
+    assert(cache.size() == 1);
+
+    unlink(path.c_str());
+    std::cout << "testWrapCache passed" << std::endl;
+}
+
+void testFollowGrowth() {
+    std::cout << "Testing MappedFile refresh and LineIndex compaction..." << std::endl;
+
+    std::string path = writeTempFile("one\ntwo\nthr");
+    MappedFile file;
+    assert(file.open(path));
+    assert(file.refresh() == MappedFile::Change::NONE);
+    LineIndex index(file, 4);
+    assert(index.lineCount() == 3);
+
+    // Appended data extends the mapping and the index picks up from there
+    {
+        std::ofstream out(path, std::ios::app);
+        out << "ee\n";
+        for (int i = 0; i < 1000; i++) {
+            out << "line" << i << "\n";
+        }
+    }
+    assert(file.refresh() == MappedFile::Change::GREW);
+    assert(!index.complete());
+    assert(index.lineCount() == 1003);
+    assert(lineText(index, file, 2) == "three");
+    assert(lineText(index, file, 1002) == "line999");
+
+    // Capped at four checkpoints, the stride has doubled until it fits
+    assert(index.stride() >= 1003 / 4);
+    assert(lineText(index, file, 517) == "line514");
+    assert(index.lineAtOffset(file.size() - 1) == 1002);
+
+    // Truncation is reported so the viewer can start over
+    assert(truncate(path.c_str(), 4) == 0);
+    assert(file.refresh() == MappedFile::Change::TRUNCATED);
+    assert(file.open(path));
+    index.reset();
+    assert(index.stride() == LineIndex::STRIDE);
+    assert(index.lineCount() == 1);
+
+    // Rotation: a new file under the same name
+    std::string rotated = path + ".1";
+    assert(rename(path.c_str(), rotated.c_str()) == 0);
+    assert(file.refresh() == MappedFile::Change::NONE);
+    { std::ofstream out(path); out << "fresh\n"; }
+    assert(file.refresh() == MappedFile::Change::REPLACED);
+
+    unlink(rotated.c_str());
+    unlink(path.c_str());
+    std::cout << "testFollowGrowth passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LineIndex tests..." << std::endl;
+
+    testSmallFiles();
+    testLazyIndexing();
+    testBackgroundIndexing();
+    testWrapCache();
+    testFollowGrowth();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
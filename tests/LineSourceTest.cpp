@@ -0,0 +1,172 @@
+#include "viewer/CompressedFile.h"
+#include "viewer/LineSource.h"
+#include "viewer/MappedFile.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+#include <zlib.h>
+
+static std::string tempPath() {
+    char pattern[] = "/tmp/linesource_test_XXXXXX";
+    int fd = mkstemp(pattern);
+    assert(fd >= 0);
+    close(fd);
+    return pattern;
+}
+
+static std::string makeLines(uint64_t count) {
+    std::string text;
+    for (uint64_t i = 0; i < count; i++) {
+        text += "line " + std::to_string(i) + " " + std::string(i % 97, (char)('a' + i % 26)) + "\n";
+    }
+    return text;
+}
+
+// The text of a line as the viewer draws it, row by row
+static std::string drawn(LineSource& source, uint64_t line, int width) {
+    const std::vector<RowSegment>& rows = source.rows(line, width);
+    const char* text = source.text(line);
+    std::string result;
+    for (const auto& row : rows) {
+        result.append(text + row.start, row.length);
+    }
+    return result;
+}
+
+// Both kinds of source show the same lines the same way
+static void checkSource(LineSource& source, uint64_t lines) {
+    assert(source.lineCount() == lines);
+    assert(source.complete());
+    assert(source.knownLines() == lines);
+    assert(source.hasLine(lines - 1));
+    assert(!source.hasLine(lines));
+    assert(source.rows(lines, 40).empty());
+
+    // Line 1234 has 1234 % 97 = 70 letters after "line 1234 ": wrapped at
+    // 40, the break takes the space and the letters are cut once more
+    std::string expected = "line 1234" + std::string(1234 % 97, (char)('a' + 1234 % 26));
+    assert(drawn(source, 1234, 40) == expected);
+    assert(source.rows(1234, 40).size() == 3);
+    assert(drawn(source, 0, 40) == "line 0 ");
+
+    assert(source.lineAtPercent(0) == 0);
+    assert(source.lineAtPercent(50) == lines / 2);
+    assert(source.lineAtPercent(100) == lines);
+
+    // Far-away lines are dropped, the ones around the top of the view stay
+    for (uint64_t line = 0; line < 3000; line++) {
+        source.rows(line, 40);
+    }
+    source.trim(2000);
+    assert(drawn(source, 2000, 40).compare(0, 9, "line 2000") == 0);
+}
+
+void testMappedSource() {
+    std::cout << "Testing the mapped line source..." << std::endl;
+
+    std::string path = tempPath();
+    std::string text = makeLines(5000);
+    {
+        FILE* out = fopen(path.c_str(), "wb");
+        assert(out);
+        assert(fwrite(text.data(), 1, text.size(), out) == text.size());
+        fclose(out);
+    }
+
+    MappedFile file;
+    assert(file.open(path));
+    MappedLineSource source(file);
+    checkSource(source, 5000);
+    assert(source.format().empty());
+    assert(source.progressNote().empty());
+    assert(source.lineAtOffset(text.find("line 10 ")) == 10);
+
+    // Appended lines are picked up without starting over
+    {
+        FILE* out = fopen(path.c_str(), "ab");
+        assert(out);
+        fputs("appended\n", out);
+        fclose(out);
+    }
+    assert(!source.reload(path));
+    assert(source.lineCount() == 5001);
+    assert(drawn(source, 5000, 40) == "appended");
+
+    // A truncated file is a new file
+    assert(truncate(path.c_str(), 0) == 0);
+    assert(source.reload(path));
+    assert(source.lineCount() == 0);
+
+    unlink(path.c_str());
+    std::cout << "testMappedSource passed" << std::endl;
+}
+
+void testTruncatedWhileIndexing() {
+    std::cout << "Testing a file truncated while it is indexed..." << std::endl;
+
+    std::string path = tempPath();
+    std::string text = makeLines(400000);
+    {
+        FILE* out = fopen(path.c_str(), "wb");
+        assert(out);
+        assert(fwrite(text.data(), 1, text.size(), out) == text.size());
+        fclose(out);
+    }
+
+    // Cut the file to a few pages while the indexer is running; reads past
+    // the new end see zeros instead of killing the process
+    MappedFile file;
+    assert(file.open(path));
+    MappedLineSource source(file);
+    assert(truncate(path.c_str(), 8192) == 0);
+    uint64_t lines = source.lineCount();
+    assert(lines > 0 && lines <= 400000);
+    drawn(source, lines - 1, 40);
+    assert(file.data()[file.size() - 1] == '\0');
+    assert(file.shrank());
+
+    // Reloading starts over with what is left
+    assert(source.reload(path));
+    assert(!file.shrank());
+    assert(source.lineCount() == (uint64_t)std::count(text.begin(), text.begin() + 8192, '\n') + 1);
+    assert(drawn(source, 0, 40) == "line 0 ");
+
+    unlink(path.c_str());
+    std::cout << "testTruncatedWhileIndexing passed" << std::endl;
+}
+
+void testCompressedSource() {
+    std::cout << "Testing the compressed line source..." << std::endl;
+
+    std::string path = tempPath();
+    std::string text = makeLines(5000);
+    gzFile out = gzopen(path.c_str(), "wb");
+    assert(out);
+    assert(gzwrite(out, text.data(), (unsigned)text.size()) == (int)text.size());
+    gzclose(out);
+
+    CompressedFile file;
+    assert(file.open(path));
+    file.waitForIndex();
+    CompressedLineSource source(file);
+    checkSource(source, 5000);
+    assert(source.format() == "gzip");
+    assert(source.progressNote() == std::to_string(text.size()) + " bytes uncompressed");
+
+    unlink(path.c_str());
+    std::cout << "testCompressedSource passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LineSource tests..." << std::endl;
+
+    testMappedSource();
+    testTruncatedWhileIndexing();
+    testCompressedSource();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
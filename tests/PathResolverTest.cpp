@@ -0,0 +1,213 @@
+#include "io/PathResolver.h"
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Canonical, since /tmp itself may be a symlink
+static std::string makeTempDir() {
+    char pattern[] = "/tmp/pathresolver_test_XXXXXX";
+    assert(mkdtemp(pattern) != nullptr);
+    char canonical[PATH_MAX];
+    assert(realpath(pattern, canonical) != nullptr);
+    return canonical;
+}
+
+void testOneLookupPerHop() {
+    std::cout << "Testing lookups while moving through a deep tree..." << std::endl;
+
+    std::string dir = makeTempDir();
+    std::string deepest = dir;
+    for (int i = 0; i < 12; i++) {
+        deepest += "/d" + std::to_string(i);
+    }
+    assert(system(("mkdir -p " + deepest).c_str()) == 0);
+
+    PathResolver resolver;
+    std::string current = dir;
+    std::string resolved;
+    assert(resolver.resolve(current, "d0", resolved));
+    assert(resolved == dir + "/d0");
+    current = resolved;
+
+    // Down one level at a time, then back up: one lookup each
+    for (int i = 1; i < 12; i++) {
+        size_t before = resolver.lookups();
+        assert(resolver.resolve(current, "d" + std::to_string(i), resolved));
+        assert(resolver.lookups() == before + 1);
+        assert(resolved == current + "/d" + std::to_string(i));
+        current = resolved;
+    }
+    assert(current == deepest);
+    for (int i = 0; i < 11; i++) {
+        size_t before = resolver.lookups();
+        assert(resolver.resolve(current, "..", resolved));
+        assert(resolver.lookups() == before + 1);
+        current = resolved;
+    }
+    assert(current == dir + "/d0");
+
+    // Several levels at once, and an absolute path, are still one lookup
+    size_t before = resolver.lookups();
+    assert(resolver.resolve(current, "d1/./d2//d3/", resolved));
+    assert(resolved == dir + "/d0/d1/d2/d3");
+    assert(resolver.resolve(resolved, "../../..", resolved));
+    assert(resolved == dir + "/d0");
+    assert(resolver.resolve("/", deepest, resolved));
+    assert(resolved == deepest);
+    assert(resolver.lookups() == before + 3);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testOneLookupPerHop passed" << std::endl;
+}
+
+void testSymlinks() {
+    std::cout << "Testing cached symlinks..." << std::endl;
+
+    std::string dir = makeTempDir();
+    assert(system(("mkdir -p " + dir + "/real/sub " + dir + "/other/sub").c_str()) == 0);
+    assert(symlink("real", (dir + "/link").c_str()) == 0);
+
+    PathResolver resolver;
+    std::string resolved;
+    assert(resolver.resolve(dir, "link/sub", resolved));
+    assert(resolved == dir + "/real/sub");
+    assert(resolver.cachedLinks() == 1);
+
+    // Through the cached link the target is found with one lookup
+    assert(resolver.resolve(dir, ".", resolved));
+    size_t before = resolver.lookups();
+    assert(resolver.resolve(dir, "link/sub", resolved));
+    assert(resolved == dir + "/real/sub");
+    assert(resolver.lookups() == before + 1);
+
+    // ".." after a link goes to the parent of its target
+    assert(resolver.resolve(dir, "link/../other", resolved));
+    assert(resolved == dir + "/other");
+
+    // A current directory reached through a link
+    assert(resolver.resolve(dir + "/link", "sub", resolved));
+    assert(resolved == dir + "/real/sub");
+
+    // Pointing the link elsewhere is noticed
+    assert(unlink((dir + "/link").c_str()) == 0);
+    assert(symlink(dir.c_str(), (dir + "/link").c_str()) == 0);
+    assert(resolver.resolve(dir, "link/other/sub", resolved));
+    assert(resolved == dir + "/other/sub");
+    assert(resolver.cachedLinks() == 1);
+
+    // A link to a file, a dangling link and a loop are not directories
+    int fd = open((dir + "/file").c_str(), O_WRONLY | O_CREAT, 0644);
+    assert(fd >= 0);
+    close(fd);
+    assert(symlink("file", (dir + "/filelink").c_str()) == 0);
+    assert(symlink("nowhere", (dir + "/dangling").c_str()) == 0);
+    assert(symlink("loop", (dir + "/loop").c_str()) == 0);
+    assert(!resolver.resolve(dir, "filelink", resolved));
+    assert(!resolver.resolve(dir, "dangling", resolved));
+    assert(!resolver.resolve(dir, "loop", resolved));
+
+    resolver.clear();
+    assert(resolver.cachedLinks() == 0);
+    assert(resolver.resolve(dir, "link", resolved));
+    assert(resolved == dir);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testSymlinks passed" << std::endl;
+}
+
+void testTargets() {
+    std::cout << "Testing home, missing and odd targets..." << std::endl;
+
+    std::string dir = makeTempDir();
+    assert(system(("mkdir -p " + dir + "/home/projects").c_str()) == 0);
+    int fd = open((dir + "/file").c_str(), O_WRONLY | O_CREAT, 0644);
+    assert(fd >= 0);
+    close(fd);
+
+    const char* savedHome = getenv("HOME");
+    std::string home = savedHome ? savedHome : "";
+    setenv("HOME", (dir + "/home").c_str(), 1);
+
+    PathResolver resolver;
+    std::string resolved;
+    assert(resolver.resolve(dir, "~", resolved));
+    assert(resolved == dir + "/home");
+    assert(resolver.resolve(dir, "~/projects", resolved));
+    assert(resolved == dir + "/home/projects");
+
+    assert(!resolver.resolve(dir, "", resolved));
+    assert(!resolver.resolve(dir, "missing", resolved));
+    assert(!resolver.resolve(dir, "file", resolved));
+    assert(!resolver.resolve(dir, "file/..", resolved));
+    assert(resolved == dir + "/home/projects");
+
+    // Above the root stays at the root
+    assert(resolver.resolve("/", "../..", resolved));
+    assert(resolved == "/");
+
+    // From a current directory that is gone, ".." still leads back
+    assert(resolver.resolve(dir, "home/projects", resolved));
+    assert(rmdir((dir + "/home/projects").c_str()) == 0);
+    assert(!resolver.resolve(dir + "/home/projects", "sub", resolved));
+    assert(resolver.resolve(dir + "/home/projects", "..", resolved));
+    assert(resolved == dir + "/home");
+
+    if (savedHome) {
+        setenv("HOME", home.c_str(), 1);
+    } else {
+        unsetenv("HOME");
+    }
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testTargets passed" << std::endl;
+}
+
+void testRenames() {
+    std::cout << "Testing renames under the held directory..." << std::endl;
+
+    std::string dir = makeTempDir();
+    assert(system(("mkdir -p " + dir + "/t/a/sub").c_str()) == 0);
+
+    PathResolver resolver;
+    std::string resolved;
+    assert(resolver.resolve(dir, "t/a", resolved));
+    assert(resolved == dir + "/t/a");
+
+    // The held directory moves, but its old path no longer leads anywhere
+    assert(rename((dir + "/t/a").c_str(), (dir + "/t/b").c_str()) == 0);
+    assert(!resolver.resolve(dir + "/t/a", "sub", resolved));
+    assert(resolver.resolve(dir + "/t/a", "../b/sub", resolved));
+    assert(resolved == dir + "/t/b/sub");
+
+    // Likewise when a parent is renamed
+    assert(rename((dir + "/t").c_str(), (dir + "/u").c_str()) == 0);
+    assert(!resolver.resolve(dir + "/t/b/sub", ".", resolved));
+    assert(!resolver.resolve(dir + "/t/b/sub", "..", resolved));
+    assert(resolver.resolve(dir + "/u/b/sub", "..", resolved));
+    assert(resolved == dir + "/u/b");
+
+    // Back to one lookup per hop from the new place
+    size_t before = resolver.lookups();
+    assert(resolver.resolve(resolved, "sub", resolved));
+    assert(resolved == dir + "/u/b/sub");
+    assert(resolver.lookups() == before + 1);
+
+    assert(system(("rm -rf " + dir).c_str()) == 0);
+    std::cout << "testRenames passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running PathResolver tests..." << std::endl;
+
+    testOneLookupPerHop();
+    testSymlinks();
+    testTargets();
+    testRenames();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
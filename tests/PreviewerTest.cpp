@@ -0,0 +1,172 @@
+#include "viewer/Previewer.h"
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static FileInfo info(const std::string& name, FileInfo::FileType type, size_t size, int stamp = 0) {
+    return FileInfo(name, type, size, std::chrono::system_clock::time_point(std::chrono::seconds(stamp)), 0644);
+}
+
+// Ask until the worker has made the preview
+static bool waitFor(Previewer& previewer, const std::string& path, const FileInfo& file,
+                    Previewer::Preview& preview) {
+    for (int i = 0; i < 500; i++) {
+        if (previewer.request(path, file, preview)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+void testGenerate(const std::string& dir) {
+    std::cout << "Testing preview contents..." << std::endl;
+
+    // Text: the first lines, tabs expanded and control characters replaced
+    {
+        std::ofstream out(dir + "/notes.txt");
+        out << "first\tline\r\nsecond\x01\n";
+        for (size_t i = 0; i < Previewer::MAX_LINES * 2; i++) {
+            out << "line " << i << "\n";
+        }
+    }
+    Previewer::Preview text = Previewer::generate(dir + "/notes.txt", FileInfo::FileType::FILE);
+    assert(text.kind == "text");
+    assert(text.lines.size() == Previewer::MAX_LINES);
+    assert(text.lines[0] == "first   line");
+    assert(text.lines[1] == "second.");
+
+    // Binary: a hex dump
+    {
+        std::ofstream out(dir + "/blob.bin", std::ios::binary);
+        for (int i = 0; i < 64; i++) {
+            out.put(static_cast<char>(i));
+        }
+    }
+    Previewer::Preview hex = Previewer::generate(dir + "/blob.bin", FileInfo::FileType::FILE);
+    assert(hex.kind == "hex");
+    assert(hex.lines.size() == 64 / Previewer::HEX_ROW_BYTES);
+    assert(hex.lines[1].find("08 09 0a") != std::string::npos);
+
+    // gzip: the decompressed text
+    {
+        gzFile gz = gzopen((dir + "/log.gz").c_str(), "wb");
+        gzputs(gz, "packed text\nmore\n");
+        gzclose(gz);
+    }
+    Previewer::Preview packed = Previewer::generate(dir + "/log.gz", FileInfo::FileType::FILE);
+    assert(packed.kind == "gzip");
+    assert(packed.lines.size() == 2 && packed.lines[0] == "packed text");
+
+    // Directory: subdirectories first, then files
+    mkdir((dir + "/sub").c_str(), 0755);
+    Previewer::Preview listing = Previewer::generate(dir, FileInfo::FileType::DIRECTORY);
+    assert(listing.kind == "directory");
+    assert(listing.lines.size() == 4);
+    assert(listing.lines[0] == "sub/" && listing.lines[1] == "blob.bin");
+
+    Previewer::Preview empty = Previewer::generate(dir + "/sub", FileInfo::FileType::DIRECTORY);
+    assert(empty.lines.size() == 1 && empty.lines[0] == "(empty)");
+
+    // Errors become the preview
+    Previewer::Preview missing = Previewer::generate(dir + "/missing", FileInfo::FileType::FILE);
+    assert(missing.kind == "error" && !missing.lines.empty());
+
+    std::cout << "testGenerate passed" << std::endl;
+}
+
+void testWorkerAndCache(const std::string& dir) {
+    std::cout << "Testing background previews and the cache..." << std::endl;
+
+    Previewer previewer(2);
+    Previewer::Preview preview;
+    FileInfo notes = info("notes.txt", FileInfo::FileType::FILE, 100);
+    FileInfo blob = info("blob.bin", FileInfo::FileType::FILE, 64);
+    FileInfo sub = info("sub", FileInfo::FileType::DIRECTORY, 0);
+
+    // The first request only starts the work
+    assert(!previewer.request(dir + "/notes.txt", notes, preview));
+    assert(waitFor(previewer, dir + "/notes.txt", notes, preview));
+    assert(preview.kind == "text");
+
+    // A changed file is previewed again
+    FileInfo touched = info("notes.txt", FileInfo::FileType::FILE, 100, 5);
+    assert(!previewer.request(dir + "/notes.txt", touched, preview));
+    assert(waitFor(previewer, dir + "/notes.txt", touched, preview));
+
+    // The least recently used preview is dropped at the cap
+    assert(waitFor(previewer, dir + "/blob.bin", blob, preview) && preview.kind == "hex");
+    assert(waitFor(previewer, dir + "/sub", sub, preview) && preview.kind == "directory");
+    assert(!previewer.request(dir + "/notes.txt", touched, preview));
+    assert(waitFor(previewer, dir + "/notes.txt", touched, preview));
+    assert(previewer.request(dir + "/sub", sub, preview));
+
+    // Moving on before a preview is ready leaves only the latest one to finish
+    previewer.clear();
+    previewer.request(dir + "/blob.bin", blob, preview);
+    previewer.request(dir + "/notes.txt", touched, preview);
+    assert(waitFor(previewer, dir + "/notes.txt", touched, preview));
+
+    std::cout << "testWorkerAndCache passed" << std::endl;
+}
+
+void testSpecialFiles(const std::string& dir) {
+    std::cout << "Testing pipes, devices and links..." << std::endl;
+
+    // A pipe with no writer would block an ordinary open forever
+    assert(mkfifo((dir + "/pipe").c_str(), 0644) == 0);
+    auto start = std::chrono::steady_clock::now();
+    Previewer::Preview pipe = Previewer::generate(dir + "/pipe", FileInfo::FileType::FILE);
+    assert(pipe.kind == "special");
+    assert(pipe.lines.size() == 1 && pipe.lines[0].find("pipe") != std::string::npos);
+    Previewer::Preview device = Previewer::generate("/dev/null", FileInfo::FileType::UNKNOWN);
+    assert(device.kind == "special");
+
+    // A link to a directory lists the directory
+    assert(symlink("sub", (dir + "/sublink").c_str()) == 0);
+    Previewer::Preview linked = Previewer::generate(dir + "/sublink", FileInfo::FileType::SYMLINK);
+    assert(linked.kind == "directory");
+
+    // The worker does not get stuck on the pipe either, and the previewer
+    // goes away without waiting for it
+    {
+        Previewer previewer;
+        Previewer::Preview preview;
+        FileInfo fifo = info("pipe", FileInfo::FileType::FILE, 0);
+        assert(waitFor(previewer, dir + "/pipe", fifo, preview));
+        assert(preview.kind == "special");
+        previewer.request(dir + "/notes.txt", info("notes.txt", FileInfo::FileType::FILE, 1), preview);
+    }
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+
+    unlink((dir + "/pipe").c_str());
+    unlink((dir + "/sublink").c_str());
+    std::cout << "testSpecialFiles passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Previewer tests..." << std::endl;
+
+    char pattern[] = "/tmp/previewer_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+
+    testGenerate(dir);
+    testWorkerAndCache(dir);
+    testSpecialFiles(dir);
+
+    unlink((dir + "/notes.txt").c_str());
+    unlink((dir + "/blob.bin").c_str());
+    unlink((dir + "/log.gz").c_str());
+    rmdir((dir + "/sub").c_str());
+    rmdir(dir.c_str());
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
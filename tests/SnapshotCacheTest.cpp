@@ -0,0 +1,169 @@
+#include "listing/ListingPrefetcher.h"
+#include "listing/SnapshotCache.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+static std::vector<FileInfo> entries(size_t count, const std::string& prefix = "entry") {
+    std::vector<FileInfo> result;
+    for (size_t i = 0; i < count; i++) {
+        result.emplace_back(prefix + std::to_string(i), FileInfo::FileType::FILE, i,
+                            std::chrono::system_clock::time_point(), 0644);
+    }
+    return result;
+}
+
+void testLruAndCap() {
+    std::cout << "Testing snapshot LRU and memory cap..." << std::endl;
+
+    // Room for about three listings of 100 entries
+    size_t listing = SnapshotCache::footprint(entries(100)) + 16;
+    SnapshotCache cache(listing * 3 + listing / 2);
+
+    cache.put("/a", entries(100));
+    cache.put("/b", entries(100));
+    cache.put("/c", entries(100));
+    assert(cache.size() == 3 && cache.bytes() <= cache.capacity());
+
+    // Using /a makes /b the oldest, so it goes first
+    std::vector<FileInfo> found;
+    assert(cache.get("/a", found) && found.size() == 100 && found[5].getName() == "entry5");
+    cache.put("/d", entries(100));
+    assert(cache.size() == 3);
+    assert(!cache.contains("/b"));
+    assert(cache.contains("/a") && cache.contains("/c") && cache.contains("/d"));
+
+    // Replacing a snapshot does not count it twice
+    size_t before = cache.bytes();
+    cache.put("/d", entries(100, "other"));
+    assert(cache.bytes() == before && cache.size() == 3);
+    assert(cache.get("/d", found) && found[0].getName() == "other0");
+
+    // Lookups are counted
+    assert(!cache.get("/missing", found));
+    assert(cache.hits() == 2 && cache.misses() == 1);
+
+    // A listing larger than the whole cache is not kept
+    cache.put("/huge", entries(1000));
+    assert(!cache.contains("/huge") && cache.size() == 3);
+
+    // Invalidation drops the path and the parent listing that shows it
+    cache.put("/a/sub", entries(1));
+    cache.invalidate("/a/sub");
+    assert(!cache.contains("/a/sub") && !cache.contains("/a"));
+    assert(cache.contains("/d"));
+
+    cache.clear();
+    assert(cache.size() == 0 && cache.bytes() == 0);
+    std::cout << "testLruAndCap passed" << std::endl;
+}
+
+void testPrefetch() {
+    std::cout << "Testing prefetch of the highlighted directory..." << std::endl;
+
+    char pattern[] = "/tmp/prefetch_test_XXXXXX";
+    std::string dir = mkdtemp(pattern);
+    std::ofstream(dir + "/one") << "1";
+    std::ofstream(dir + "/two") << "2";
+
+    SnapshotCache cache;
+    {
+        ListingPrefetcher prefetcher(cache, std::chrono::milliseconds(20));
+
+        // Passing over a directory quickly does not read it
+        prefetcher.hint(dir);
+        prefetcher.hint("");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        assert(!cache.contains(dir) && prefetcher.completed() == 0);
+
+        // Resting on it does
+        prefetcher.hint(dir);
+        for (int i = 0; i < 200 && !cache.contains(dir); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::vector<FileInfo> found;
+        assert(cache.get(dir, found) && found.size() == 2);
+        assert(prefetcher.completed() == 1);
+
+        // Unreadable directories are skipped quietly
+        prefetcher.hint(dir + "/missing");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        assert(!cache.contains(dir + "/missing"));
+    }
+
+    unlink((dir + "/one").c_str());
+    unlink((dir + "/two").c_str());
+    rmdir(dir.c_str());
+    std::cout << "testPrefetch passed" << std::endl;
+}
+
+void testPrefetchHungMount() {
+    std::cout << "Testing prefetch from a mount that does not answer..." << std::endl;
+
+    // "hung" blocks until released, like a read from a dead network mount
+    auto gate = std::make_shared<std::atomic<bool>>(false);
+    auto entered = std::make_shared<std::atomic<int>>(0);
+    ListingPrefetcher::Lister lister = [gate, entered](const std::string& path, const std::atomic<bool>*) {
+        if (path == "hung") {
+            (*entered)++;
+            while (!*gate) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        return std::vector<FileInfo>{FileInfo(path, FileInfo::FileType::FILE, 1,
+                                              std::chrono::system_clock::time_point(), 0)};
+    };
+
+    SnapshotCache cache;
+    auto start = std::chrono::steady_clock::now();
+    {
+        ListingPrefetcher prefetcher(cache, std::chrono::milliseconds(10), lister, std::chrono::milliseconds(50));
+        prefetcher.hint("hung");
+        for (int i = 0; i < 200 && *entered == 0; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert(*entered == 1);
+
+        // Once the read has stalled, moving on gets a new worker
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        prefetcher.hint("next");
+        for (int i = 0; i < 200 && !cache.contains("next"); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        assert(cache.contains("next") && prefetcher.completed() == 1);
+
+        // Going back to the hung directory stalls the new worker too
+        prefetcher.hint("hung");
+        for (int i = 0; i < 200 && *entered < 2; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert(*entered == 2);
+    }
+    // Leaving does not wait for either stuck read
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(3));
+
+    // When they finish at last they leave the cache alone
+    *gate = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!cache.contains("hung"));
+
+    std::cout << "testPrefetchHungMount passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running SnapshotCache tests..." << std::endl;
+
+    testLruAndCap();
+    testPrefetch();
+    testPrefetchHungMount();
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}